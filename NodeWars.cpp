@@ -60,70 +60,18 @@ int main()
                         }
                         if (const auto* scroll = event->getIf<sf::Event::MouseWheelScrolled>()) {
                                 if (auto* battle = dynamic_cast<BattleScene*>(sceneManager.currentScene())) {
-                                        battle->camera().processMouseScroll(scroll->delta);
+                                        BattleCommand zoom{BattleCommandType::CameraZoom};
+                                        zoom.value = scroll->delta;
+                                        battle->execute(zoom);
                                 }
                         }
                 }
 
-                // 输入处理
+                // 输入处理（对局中的选中/开火/相机操作由 InteractiveBattleScene 翻译为 BattleCommand）
                 sceneManager.handleInput(deltaTime, &window);
 
                 if (auto* battleScene = dynamic_cast<BattleScene*>(sceneManager.currentScene())) {
                         battleScene->inputManager().setRightButtonDown(sf::Mouse::isButtonPressed(sf::Mouse::Button::Right));
-
-                        bool forward = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W);
-                        bool backward = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S);
-                        bool left = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A);
-                        bool right = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D);
-                        bool rotateLeft = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Q);
-                        bool rotateRight = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::E);
-                        bool boost = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift);
-
-                        battleScene->camera().processKeyboard(forward, backward, left, right, rotateLeft, rotateRight, boost, deltaTime);
-
-                        static bool fWasPressed = false;
-                        bool fPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::F);
-                        if (fPressed && !fWasPressed) {
-                                EntityId selectedId = battleScene->selectedNodeId();
-                                if (selectedId != 0) {
-                                        NodeEntity* node = battleScene->getNodeEntity(selectedId);
-                                        if (node) {
-                                                battleScene->camera().focusOnTarget(node->transform.position);
-                                                printf("Focusing on Node %llu at (%.2f, %.2f, %.2f)\n",
-                                                       selectedId,
-                                                       node->transform.position.x,
-                                                       node->transform.position.y,
-                                                       node->transform.position.z);
-                                        }
-                                }
-                        }
-                        fWasPressed = fPressed;
-
-                        // Camera switching: 1, 2, 3 keys
-                        static bool key1WasPressed = false;
-                        static bool key2WasPressed = false;
-                        static bool key3WasPressed = false;
-
-                        bool key1Pressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Num1);
-                        bool key2Pressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Num2);
-                        bool key3Pressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Num3);
-
-                        if (key1Pressed && !key1WasPressed) {
-	                        battleScene->camera().switchToCamera(CameraType::FreeCam);
-	                        printf("Switching to Free Camera\n");
-                        }
-                        if (key2Pressed && !key2WasPressed) {
-	                        battleScene->camera().switchToCamera(CameraType::FrontView);
-	                        printf("Switching to Front View Camera\n");
-                        }
-                        if (key3Pressed && !key3WasPressed) {
-	                        battleScene->camera().switchToCamera(CameraType::TopView);
-	                        printf("Switching to Top View Camera\n");
-                        }
-
-                        key1WasPressed = key1Pressed;
-                        key2WasPressed = key2Pressed;
-                        key3WasPressed = key3Pressed;
                 } else if (auto* menuScene = dynamic_cast<MenuScene*>(sceneManager.currentScene())) {
                         if (menuScene->exitRequested()) {
                                 window.close();
@@ -0,0 +1,292 @@
+﻿// NodeWarsHeadless.cpp: 无窗口、无渲染地全速运行 BattleScene 对局逻辑（吞吐与回归基准）
+//
+// 用法: nodewars_headless [--matches N=1] [--threads T=1] [--seed S=1] [--max-ticks M=36000] [--physics-threads P] [--verify]
+//                          [--verify-threads V] [--replay FILE] [--broadphase sap|hash|bvh]
+// 以演示模式（双方 AI 对战）运行 N 局，第 i 局种子为 S + i；场景处于固定 dt 模式，每次 tick 恰好推进一个固定步，
+// 直到一方节点全部被占领或达到最大步数。
+// T > 1 时每个线程同时跑一局；物理窄相线程数 P 默认单线程跑时为 0（硬件并发数），多线程跑时为 1，避免超额订阅。
+// 汇报：每局与总体 ticks/s、各流水线阶段单 tick 耗时的均值与 p99、实体数峰值、进程内存峰值。
+// --replay：每局改为重放窗口版录制的命令日志（F9 保存的 replay.nwlog）：种子取自日志，不进入演示模式，
+// 在命令记录的模拟步执行命令，推进到日志的结束步为止（不因一方节点清零提前结束），最后与录制时的状态哈希比对，不一致返回 1。
+// --broadphase：物理广相策略（默认 sap），配合 --replay 可在同一录制场景上横向对比三种策略。
+// --verify：记录每 tick 的 Scene::stateHash，再以另一物理线程数逐局串行重跑，任一 tick 的哈希不同即报告并返回 1。
+// --verify-threads：重跑的物理线程数（隐含 --verify）；默认 P 为 1 时取 8，否则取 1。
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "src/core/platform/ProcessMemory.hpp"
+#include "src/core/render/NullRenderer.hpp"
+#include "src/game/scene/BattleScene.hpp"
+#include "src/game/input/CommandLog.hpp"
+
+namespace {
+	// 与 Scene::LogicStats 对应的流水线阶段，最后一项为驱动侧测得的整个 tick
+	enum Stage {
+		SyncTransform,
+		PhysicsStep,
+		BuildQuery,
+		WriteBack,
+		CollisionEvents,
+		EntityUpdate,
+		SubmitCommands,
+		TickTotal,
+		StageCount
+	};
+
+	const char *kStageNames[StageCount] = {
+		"Sync Transform", "Physics Step", "Build Query", "Write Back",
+		"Collision Events", "Entity Update", "Submit Commands", "Tick Total"
+	};
+
+	struct Options {
+		int matches = 1;
+		int threads = 1;
+		uint64_t seed = 1;
+		long maxTicks = 36000;
+		int physicsThreads = -1; // -1：按 threads 自动选择
+		bool verify = false;
+		int verifyThreads = -1; // -1：按 physicsThreads 自动选择
+		const char *replayPath = nullptr;
+		CommandLog replay;
+		BroadPhaseType broadPhase = BroadPhaseType::SweepAndPrune;
+	};
+
+	bool ParseBroadPhase(const char *name, BroadPhaseType &out) {
+		if (std::strcmp(name, "sap") == 0) out = BroadPhaseType::SweepAndPrune;
+		else if (std::strcmp(name, "hash") == 0) out = BroadPhaseType::SpatialHash;
+		else if (std::strcmp(name, "bvh") == 0) out = BroadPhaseType::Bvh;
+		else return false;
+		return true;
+	}
+
+	const char *BroadPhaseName(BroadPhaseType type) {
+		switch (type) {
+			case BroadPhaseType::SpatialHash: return "hash";
+			case BroadPhaseType::Bvh: return "bvh";
+			default: return "sap";
+		}
+	}
+
+	struct MatchResult {
+		uint64_t seed = 0;
+		long ticks = 0;
+		double seconds = 0.0;
+		float dt = 0.0f;
+		int friendly = 0;
+		int enemy = 0;
+		uint64_t endHash = 0;
+		size_t peakEntities = 0;
+		std::vector<float> samples[StageCount]; // 每 tick 一个样本（ms）
+		std::vector<uint64_t> hashes; // --verify 时每 tick 的状态哈希
+	};
+
+	bool ParseOptions(int argc, char **argv, Options &opt) {
+		for (int i = 1; i < argc; ++i) {
+			const char *arg = argv[i];
+			const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+			auto take = [&](const char *name) {
+				if (std::strcmp(arg, name) != 0 || !value) return false;
+				++i;
+				return true;
+			};
+			if (take("--matches")) opt.matches = std::atoi(value);
+			else if (take("--threads")) opt.threads = std::atoi(value);
+			else if (take("--seed")) opt.seed = std::strtoull(value, nullptr, 10);
+			else if (take("--max-ticks")) opt.maxTicks = std::strtol(value, nullptr, 10);
+			else if (take("--physics-threads")) opt.physicsThreads = std::atoi(value);
+			else if (take("--verify-threads")) {
+				opt.verifyThreads = std::atoi(value);
+				opt.verify = true;
+			}
+			else if (take("--replay")) opt.replayPath = value;
+			else if (take("--broadphase")) {
+				if (!ParseBroadPhase(value, opt.broadPhase)) return false;
+			}
+			else if (std::strcmp(arg, "--verify") == 0) opt.verify = true;
+			else if (i == 1 && arg[0] != '-') opt.maxTicks = std::strtol(arg, nullptr, 10); // 旧用法：唯一参数为最大步数
+			else return false;
+		}
+		if (opt.replayPath) {
+			if (!opt.replay.load(opt.replayPath)) {
+				fprintf(stderr, "failed to load command log %s\n", opt.replayPath);
+				return false;
+			}
+			opt.maxTicks = opt.replay.endStep;
+		}
+		return opt.matches > 0 && opt.threads > 0 && opt.maxTicks > 0;
+	}
+
+	void RunMatch(const Options &opt, int physicsThreads, MatchResult &out) {
+		NullRenderer renderer;
+		BattleScene scene;
+		scene.setPrintStats(false);
+		scene.setFixedDtMode(true);
+		scene.setSeed(out.seed);
+		if (opt.replayPath && opt.replay.fixedDt > 0.0f && opt.replay.fixedDt != scene.fixedTimestep()) {
+			scene.setFixedTimestep(1.0f / opt.replay.fixedDt, 0);
+		}
+		// 广相策略只能在注册碰撞体之前切换：init 之前设置，BattleScene::init 保留它
+		WorldParams initial = scene.physics().params();
+		initial.broadPhase = opt.broadPhase;
+		scene.physics().setParams(initial);
+		scene.init(&renderer);
+		if (!opt.replayPath) scene.enterDemoMode();
+		size_t nextCommand = 0;
+
+		WorldParams params = scene.physics().params();
+		params.narrowPhaseThreads = physicsThreads;
+		scene.physics().setParams(params);
+
+		for (auto &s : out.samples) s.reserve(static_cast<size_t>(opt.maxTicks));
+		if (opt.verify) out.hashes.reserve(static_cast<size_t>(opt.maxTicks));
+		const float dt = out.dt = scene.fixedTimestep();
+		const auto start = std::chrono::steady_clock::now();
+		while (out.ticks < opt.maxTicks) {
+			const auto t0 = std::chrono::steady_clock::now();
+			// 回放：执行录制时在当前步之前发出的命令（与窗口版一样在 tick 之前处理输入）
+			const auto &commands = opt.replay.commands;
+			while (opt.replayPath && nextCommand < commands.size() && commands[nextCommand].step <= scene.stepCount()) {
+				scene.execute(commands[nextCommand++]);
+			}
+			scene.tick(dt);
+			const auto t1 = std::chrono::steady_clock::now();
+			++out.ticks;
+
+			const Scene::LogicStats &ls = scene.logicStats();
+			out.samples[SyncTransform].push_back(ls.syncTransform);
+			out.samples[PhysicsStep].push_back(ls.physicsStep);
+			out.samples[BuildQuery].push_back(ls.buildQuery);
+			out.samples[WriteBack].push_back(ls.writeBack);
+			out.samples[CollisionEvents].push_back(ls.collisionEvents);
+			out.samples[EntityUpdate].push_back(ls.entityUpdate);
+			out.samples[SubmitCommands].push_back(ls.submitCommands);
+			out.samples[TickTotal].push_back(std::chrono::duration<float, std::milli>(t1 - t0).count());
+			out.peakEntities = std::max(out.peakEntities, scene.entities().size());
+			if (opt.verify) out.hashes.push_back(scene.stateHash());
+
+			if (!opt.replayPath && (scene.friendlyNodeCount() == 0 || scene.enemyNodeCount() == 0)) break;
+		}
+		// 录制在结束步保存前发出的命令也计入结束状态
+		while (opt.replayPath && nextCommand < opt.replay.commands.size()) scene.execute(opt.replay.commands[nextCommand++]);
+		out.endHash = scene.stateHash();
+		out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		out.friendly = scene.friendlyNodeCount();
+		out.enemy = scene.enemyNodeCount();
+	}
+
+	// 最近秩法 p99
+	float Percentile99(std::vector<float> &v) {
+		if (v.empty()) return 0.0f;
+		const size_t rank = (v.size() * 99 + 99) / 100 - 1;
+		std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(rank), v.end());
+		return v[rank];
+	}
+
+	// 以 physicsThreads 串行重跑每一局，与 results 的逐 tick 哈希比对；返回不一致的局数
+	int VerifyMatches(const Options &opt, int physicsThreads, const std::vector<MatchResult> &results) {
+		int mismatches = 0;
+		for (size_t i = 0; i < results.size(); ++i) {
+			const MatchResult &a = results[i];
+			MatchResult b;
+			b.seed = a.seed;
+			RunMatch(opt, physicsThreads, b);
+			const size_t n = std::min(a.hashes.size(), b.hashes.size());
+			size_t tick = 0;
+			while (tick < n && a.hashes[tick] == b.hashes[tick]) ++tick;
+			if (tick == n && a.hashes.size() == b.hashes.size()) continue;
+			++mismatches;
+			if (tick < n) {
+				printf("Verify: match %zu (seed %llu) diverged at tick %zu: %016llx vs %016llx\n", i,
+				       static_cast<unsigned long long>(a.seed), tick + 1,
+				       static_cast<unsigned long long>(a.hashes[tick]), static_cast<unsigned long long>(b.hashes[tick]));
+			} else {
+				printf("Verify: match %zu (seed %llu) ended after %zu vs %zu ticks\n", i,
+				       static_cast<unsigned long long>(a.seed), a.hashes.size(),
+				       b.hashes.size());
+			}
+		}
+		return mismatches;
+	}
+}
+
+int main(int argc, char **argv) {
+	Options opt;
+	if (!ParseOptions(argc, argv, opt)) {
+		fprintf(stderr, "usage: %s [--matches N] [--threads T] [--seed S] [--max-ticks M] [--physics-threads P] [--verify]"
+		        " [--verify-threads V] [--replay FILE] [--broadphase sap|hash|bvh]\n", argv[0]);
+		return 2;
+	}
+	const int threads = std::min(opt.threads, opt.matches);
+	const int physicsThreads = opt.physicsThreads >= 0 ? opt.physicsThreads : (threads > 1 ? 1 : 0);
+
+	std::vector<MatchResult> results(static_cast<size_t>(opt.matches));
+	for (int i = 0; i < opt.matches; ++i) results[i].seed = opt.replayPath ? opt.replay.seed : opt.seed + static_cast<uint64_t>(i);
+
+	// 每个线程循环领取下一局，各局的场景、物理世界与随机数互不共享
+	std::atomic<int> next{0};
+	auto worker = [&] {
+		for (int i = next++; i < opt.matches; i = next++) RunMatch(opt, physicsThreads, results[i]);
+	};
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+	worker();
+	for (auto &th : pool) th.join();
+	const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%-6s %-10s %8s %9s %9s %10s %9s %7s %13s\n",
+	       "Match", "Seed", "Ticks", "Sim s", "Wall s", "Ticks/s", "Friendly", "Enemy", "Peak entities");
+	long totalTicks = 0;
+	size_t peakEntities = 0;
+	for (int i = 0; i < opt.matches; ++i) {
+		const MatchResult &r = results[i];
+		printf("%-6d %-10llu %8ld %9.1f %9.3f %10.0f %9d %7d %13zu\n",
+		       i, static_cast<unsigned long long>(r.seed), r.ticks, r.ticks * static_cast<double>(r.dt), r.seconds, r.seconds > 0.0 ? r.ticks / r.seconds : 0.0,
+		       r.friendly, r.enemy, r.peakEntities);
+		totalTicks += r.ticks;
+		peakEntities = std::max(peakEntities, r.peakEntities);
+	}
+
+	printf("\n%d matches on %d threads (physics threads per match: %d, broadphase: %s): %ld ticks in %.3f s, %.0f ticks/s\n",
+	       opt.matches, threads, physicsThreads, BroadPhaseName(opt.broadPhase), totalTicks, wall,
+	       wall > 0.0 ? totalTicks / wall : 0.0);
+	printf("%-18s %10s %10s\n", "Stage (per tick)", "mean ms", "p99 ms");
+	for (int s = 0; s < StageCount; ++s) {
+		std::vector<float> all;
+		all.reserve(static_cast<size_t>(totalTicks));
+		for (auto &r : results) all.insert(all.end(), r.samples[s].begin(), r.samples[s].end());
+		double sum = 0.0;
+		for (float v : all) sum += v;
+		const double mean = all.empty() ? 0.0 : sum / static_cast<double>(all.size());
+		printf("%-18s %10.4f %10.4f\n", kStageNames[s], mean, Percentile99(all));
+	}
+	printf("Peak entities: %zu, peak resident memory: %.1f MiB\n",
+	       peakEntities, PeakResidentBytes() / (1024.0 * 1024.0));
+
+	int exitCode = 0;
+	if (opt.replayPath) {
+		int reproduced = 0;
+		for (const MatchResult &r : results) reproduced += r.endHash == opt.replay.endHash ? 1 : 0;
+		printf("Replay: %zu commands over %u steps, end state %016llx; %d/%d matches reproduced it\n",
+		       opt.replay.commands.size(), opt.replay.endStep, static_cast<unsigned long long>(opt.replay.endHash),
+		       reproduced, opt.matches);
+		if (reproduced != opt.matches) exitCode = 1;
+	}
+
+	if (opt.verify) {
+		// 重跑换一个物理线程数（默认单线程 ↔ 8 线程），同时也与批量运行时的并发局数不同
+		const int verifyThreads = opt.verifyThreads >= 0 ? opt.verifyThreads : (physicsThreads == 1 ? 8 : 1);
+		const int mismatches = VerifyMatches(opt, verifyThreads, results);
+		printf("Verify: %d/%d matches reproduced tick-for-tick with %d physics threads\n",
+		       opt.matches - mismatches, opt.matches, verifyThreads);
+		if (mismatches > 0) exitCode = 1;
+	}
+	return exitCode;
+}
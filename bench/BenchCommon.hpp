@@ -0,0 +1,61 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+// BenchCommon.hpp: 基准程序共用的命令行解析与计时
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace bench {
+	// 公共选项：--steps K、--seed S；不以 '-' 开头的参数依次收入 args（规模 N、线程数 W 等）。
+	// 默认值由各基准在解析前填写，args 为空时由各基准补默认列表
+	struct Options {
+		int steps = 60;
+		uint64_t seed = 1;
+		std::vector<uint64_t> args;
+	};
+
+	// extra(name, value) 处理基准自己的带值选项，认识时返回 true；
+	// 未知选项、选项缺值或 steps 不为正时返回 false
+	template<typename ExtraFn>
+	bool ParseOptions(int argc, char **argv, Options &opt, ExtraFn &&extra) {
+		for (int i = 1; i < argc; ++i) {
+			const char *arg = argv[i];
+			if (arg[0] != '-') {
+				opt.args.push_back(std::strtoull(arg, nullptr, 10));
+				continue;
+			}
+			if (i + 1 >= argc) return false;
+			const char *value = argv[++i];
+			if (std::strcmp(arg, "--steps") == 0) opt.steps = std::atoi(value);
+			else if (std::strcmp(arg, "--seed") == 0) opt.seed = std::strtoull(value, nullptr, 10);
+			else if (!extra(arg, value)) return false;
+		}
+		return opt.steps > 0;
+	}
+
+	inline bool ParseOptions(int argc, char **argv, Options &opt) {
+		return ParseOptions(argc, argv, opt, [](const char *, const char *) { return false; });
+	}
+
+	// 每步耗时累计（均值 / 最大）
+	struct Timing {
+		double totalMs = 0.0;
+		double maxMs = 0.0;
+
+		void add(double ms) {
+			totalMs += ms;
+			maxMs = std::max(maxMs, ms);
+		}
+
+		double meanMs(int steps) const { return steps > 0 ? totalMs / steps : 0.0; }
+	};
+
+	inline double ElapsedMs(std::chrono::steady_clock::time_point t0) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+	}
+}
@@ -0,0 +1,274 @@
+﻿// BroadPhaseBench.cpp: 广相基准——旧的每步单轴排序扫掠 vs 持久化三轴 SAP / 空间哈希 / BVH
+//
+// 用法: broadphase_bench [--steps K=60] [--seed S=1] [--bullets B]... [N...=1000 10000 50000]
+// 两类场景，各推进 K 步，动态体每步移动并更新代理 AABB，然后各策略求候选对：
+// - 战场（--bullets，默认 100 300 1000）：与 BattleScene 同形的 32×32 静态地砖 + 两层围墙，
+//   B 颗半径 0.25 的子弹贴地以 10 单位/秒滚动、碰墙反弹；每步约 1% 的子弹消失并在随机位置重生
+//   （逐个 removeProxy/addProxy，不走批量）。几乎全部碰撞体静止，是游戏里的常态。
+// - 随机云（N，压力场景）：N 个碰撞体（10% 静态方块、90% 半径 0.5 的运动球，密度固定）。
+// 汇报每步广相耗时（均值/最大）、候选对数与相对旧扫掠的加速比（空间哈希用默认格子边长 1）；
+// 各策略的候选对数须与旧扫掠逐步一致（默认过滤、无层掩码），否则返回 1。
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "BenchCommon.hpp"
+#include "core/physics/BroadPhase.hpp"
+#include "core/util/Random.hpp"
+
+namespace {
+	using bench::ElapsedMs;
+
+	// 基线：旧版 PhysicsWorld::broadPhase（每步单轴排序扫掠）的做法——每步收集全部 AABB、按 minX 排序、
+	// 单轴扫掠维护活动集合，再测 Y/Z；静态-静态对跳过
+	class LegacySweep {
+	public:
+		void computePairs(const std::vector<ColliderBase *> &colliders, const std::vector<Aabb> &boxes,
+		                  std::vector<ColliderPair> &out) {
+			out.clear();
+			items_.clear();
+			for (size_t i = 0; i < colliders.size(); ++i) {
+				const Aabb &b = boxes[i];
+				items_.push_back(BoxItem{colliders[i], b.min.x, b.max.x, b.min.y, b.max.y, b.min.z, b.max.z});
+			}
+			std::sort(items_.begin(), items_.end(), [](const BoxItem &a, const BoxItem &b) {
+				if (a.minX == b.minX) return a.maxX < b.maxX;
+				return a.minX < b.minX;
+			});
+			active_.clear();
+			for (const BoxItem &it : items_) {
+				size_t write = 0;
+				for (size_t k = 0; k < active_.size(); ++k) {
+					if (active_[k].maxX >= it.minX) active_[write++] = active_[k];
+				}
+				active_.resize(write);
+				for (const BoxItem &bj : active_) {
+					if (it.maxY < bj.minY || bj.maxY < it.minY) continue;
+					if (it.maxZ < bj.minZ || bj.maxZ < it.minZ) continue;
+					if (bj.c->isStatic() && it.c->isStatic()) continue;
+					out.emplace_back(bj.c, it.c);
+				}
+				active_.push_back(it);
+			}
+		}
+
+	private:
+		struct BoxItem {
+			ColliderBase *c;
+			float minX, maxX, minY, maxY, minZ, maxZ;
+		};
+
+		std::vector<BoxItem> items_;
+		std::vector<BoxItem> active_;
+	};
+
+	// 合成场景：碰撞体、各自的当前 AABB 与运动体的位置/速度；运动体在 [lo, hi] 内匀速运动、碰到边界反弹
+	struct Field {
+		std::vector<std::unique_ptr<ColliderBase> > colliders;
+		std::vector<ColliderBase *> raw;
+		std::vector<Aabb> boxes;
+		std::vector<DirectX::XMFLOAT3> pos;
+		std::vector<DirectX::XMFLOAT3> vel;
+		std::vector<size_t> dynamic; // 运动体下标
+		std::vector<size_t> respawned; // advance 中重生的运动体下标（调用方据此逐个移出/重新插入代理）
+		DirectX::XMFLOAT3 lo{0, 0, 0};
+		DirectX::XMFLOAT3 hi{0, 0, 0};
+		float radius = 0.5f;
+		float respawnRate = 0.0f; // 每步每个运动体重生的概率
+		Random rng{1};
+
+		void addStatic(const DirectX::XMFLOAT3 &p) {
+			add(MakeObbCollider(DirectX::XMFLOAT3{0.5f, 0.5f, 0.5f}), p, {0, 0, 0}, true);
+		}
+
+		void addMoving(const DirectX::XMFLOAT3 &p, const DirectX::XMFLOAT3 &v) {
+			dynamic.push_back(raw.size());
+			add(MakeSphereCollider(radius), p, v, false);
+		}
+
+		// 随机云：静态方块铺在 [0, side)^3 的随机格点上，其余为运动球
+		static Field RandomCloud(size_t n, uint64_t seed) {
+			Field f;
+			f.rng = Random(seed);
+			const float side = std::cbrt(static_cast<float>(n) * 8.0f); // 每个碰撞体约占 8 单位体积
+			f.hi = {side, side, side};
+			for (size_t i = 0; i < n; ++i) {
+				DirectX::XMFLOAT3 p{f.rng.range(0.0f, side), f.rng.range(0.0f, side), f.rng.range(0.0f, side)};
+				const DirectX::XMFLOAT3 v{f.rng.range(-2.0f, 2.0f), f.rng.range(-2.0f, 2.0f), f.rng.range(-2.0f, 2.0f)};
+				if (i % 10 == 0) f.addStatic({std::floor(p.x) + 0.5f, std::floor(p.y) + 0.5f, std::floor(p.z) + 0.5f});
+				else f.addMoving(p, v);
+			}
+			return f;
+		}
+
+		// 战场：布局同 BattleScene（地砖顶面 y = 0，围墙在地砖外圈之上），子弹贴地滚动
+		static Field Battlefield(size_t bullets, uint64_t seed) {
+			Field f;
+			f.rng = Random(seed);
+			f.radius = 0.25f;
+			f.respawnRate = 0.01f;
+			constexpr int size = 32;
+			const float half = size / 2.0f;
+			for (int x = 0; x < size; ++x)
+				for (int z = 0; z < size; ++z) f.addStatic({x - half, -0.5f, z - half});
+			for (int layer = 0; layer < 2; ++layer) {
+				const float y = layer + 0.5f;
+				for (int i = 0; i < size; ++i) {
+					f.addStatic({i - half, y, -half});
+					f.addStatic({i - half, y, half - 1.0f});
+					if (i == 0 || i == size - 1) continue;
+					f.addStatic({-half, y, i - half});
+					f.addStatic({half - 1.0f, y, i - half});
+				}
+			}
+			// 子弹在围墙内侧运动：x/z ∈ [-half + 0.5 + r, half - 1.5 - r]，y 固定贴地
+			f.lo = {-half + 0.5f + f.radius, f.radius, -half + 0.5f + f.radius};
+			f.hi = {half - 1.5f - f.radius, f.radius, half - 1.5f - f.radius};
+			for (size_t i = 0; i < bullets; ++i) f.addMoving(f.spawnPoint(), f.spawnVelocity());
+			return f;
+		}
+
+		DirectX::XMFLOAT3 spawnPoint() {
+			return {rng.range(lo.x, hi.x), lo.y, rng.range(lo.z, hi.z)};
+		}
+
+		DirectX::XMFLOAT3 spawnVelocity() {
+			const float a = rng.range(0.0f, 6.2831853f);
+			return {10.0f * std::cos(a), 0.0f, 10.0f * std::sin(a)};
+		}
+
+		void advance(float dt) {
+			respawned.clear();
+			for (size_t i : dynamic) {
+				if (respawnRate > 0.0f && rng.range(0.0f, 1.0f) < respawnRate) {
+					pos[i] = spawnPoint();
+					vel[i] = spawnVelocity();
+					respawned.push_back(i);
+				} else {
+					float *p[3] = {&pos[i].x, &pos[i].y, &pos[i].z};
+					float *v[3] = {&vel[i].x, &vel[i].y, &vel[i].z};
+					const float l[3] = {lo.x, lo.y, lo.z};
+					const float h[3] = {hi.x, hi.y, hi.z};
+					for (int k = 0; k < 3; ++k) {
+						*p[k] += *v[k] * dt;
+						if (*p[k] < l[k] || *p[k] > h[k]) *v[k] = -*v[k];
+					}
+				}
+				boxes[i] = sphereBox(pos[i]);
+			}
+		}
+
+	private:
+		Aabb sphereBox(const DirectX::XMFLOAT3 &c) const {
+			return {{c.x - radius, c.y - radius, c.z - radius}, {c.x + radius, c.y + radius, c.z + radius}};
+		}
+
+		void add(std::unique_ptr<ColliderBase> c, const DirectX::XMFLOAT3 &p, const DirectX::XMFLOAT3 &v, bool isStatic) {
+			c->setIsStatic(isStatic);
+			c->setOwnerWorldPosition(p);
+			c->updateDerived();
+			boxes.push_back(c->aabb());
+			raw.push_back(c.get());
+			colliders.push_back(std::move(c));
+			pos.push_back(p);
+			vel.push_back(v);
+		}
+	};
+
+	struct Timing : bench::Timing {
+		size_t pairs = 0;
+		bool mismatch = false;
+	};
+
+	bool RunScene(const char *title, Field &scene, const bench::Options &opt) {
+		const size_t n = scene.raw.size();
+		const BroadPhaseType types[] = {BroadPhaseType::SweepAndPrune, BroadPhaseType::SpatialHash, BroadPhaseType::Bvh};
+		constexpr int kStrategies = 3;
+		std::unique_ptr<IBroadPhase> bp[kStrategies];
+		std::vector<IBroadPhase::ProxyId> proxies[kStrategies];
+		Timing timing[kStrategies + 1]; // [0] 为旧扫掠
+
+		// 初始插入（批量）不计入每步耗时
+		for (int s = 0; s < kStrategies; ++s) {
+			bp[s] = MakeBroadPhase(types[s], 1.0f);
+			bp[s]->beginBatch();
+			for (size_t i = 0; i < n; ++i) {
+				proxies[s].push_back(bp[s]->addProxy(scene.raw[i], scene.boxes[i], scene.raw[i]->isStatic(), CollisionFilter{}));
+			}
+			bp[s]->endBatch();
+		}
+
+		LegacySweep legacy;
+		std::vector<ColliderPair> pairs;
+		BroadPhaseStats stats{};
+		const float dt = 1.0f / 60.0f;
+		for (int step = 0; step < opt.steps; ++step) {
+			scene.advance(dt);
+
+			auto t0 = std::chrono::steady_clock::now();
+			legacy.computePairs(scene.raw, scene.boxes, pairs);
+			timing[0].add(ElapsedMs(t0));
+			const size_t expected = pairs.size();
+			timing[0].pairs += expected;
+
+			for (int s = 0; s < kStrategies; ++s) {
+				t0 = std::chrono::steady_clock::now();
+				// 重生的运动体：逐个移出并以新包围盒重新插入（模拟子弹销毁/生成）
+				for (size_t i : scene.respawned) {
+					bp[s]->removeProxy(proxies[s][i]);
+					proxies[s][i] = bp[s]->addProxy(scene.raw[i], scene.boxes[i], false, CollisionFilter{});
+				}
+				for (size_t i : scene.dynamic) bp[s]->updateProxy(proxies[s][i], scene.boxes[i]);
+				bp[s]->computePairs(pairs, stats);
+				timing[s + 1].add(ElapsedMs(t0));
+				timing[s + 1].pairs += pairs.size();
+				if (pairs.size() != expected) timing[s + 1].mismatch = true;
+			}
+		}
+
+		printf("\n%s: %zu colliders (%zu moving), %d steps\n", title, n, scene.dynamic.size(), opt.steps);
+		printf("Strategy                 mean ms     max ms   pairs/step  speedup\n");
+		const char *names[kStrategies + 1] = {"single-axis sweep (old)", bp[0]->name(), bp[1]->name(), bp[2]->name()};
+		const double baseline = timing[0].meanMs(opt.steps);
+		bool ok = true;
+		for (int s = 0; s <= kStrategies; ++s) {
+			const double mean = timing[s].meanMs(opt.steps);
+			printf("%-24s %8.3f   %8.3f   %10zu  %6.2fx%s\n", names[s], mean, timing[s].maxMs,
+			       timing[s].pairs / static_cast<size_t>(opt.steps), mean > 0.0 ? baseline / mean : 0.0,
+			       timing[s].mismatch ? "  PAIR COUNT MISMATCH" : "");
+			ok = ok && !timing[s].mismatch;
+		}
+		return ok;
+	}
+}
+
+int main(int argc, char **argv) {
+	bench::Options opt;
+	opt.steps = 60;
+	std::vector<size_t> bullets;
+	const bool parsed = bench::ParseOptions(argc, argv, opt, [&bullets](const char *name, const char *value) {
+		if (std::strcmp(name, "--bullets") != 0) return false;
+		bullets.push_back(std::strtoull(value, nullptr, 10));
+		return true;
+	});
+	if (!parsed) {
+		fprintf(stderr, "usage: broadphase_bench [--steps K] [--seed S] [--bullets B]... [N...]\n");
+		return 2;
+	}
+	if (bullets.empty()) bullets = {100, 300, 1000};
+	if (opt.args.empty()) opt.args = {1000, 10000, 50000};
+	bool ok = true;
+	for (size_t b : bullets) {
+		Field scene = Field::Battlefield(b, opt.seed);
+		ok = RunScene("battlefield", scene, opt) && ok;
+	}
+	for (uint64_t n : opt.args) {
+		Field scene = Field::RandomCloud(static_cast<size_t>(n), opt.seed);
+		ok = RunScene("random cloud", scene, opt) && ok;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+﻿// PhysicsDeterminism.cpp: 物理结果与线程数无关的回归检查——同一堆叠场景分别以不同工作线程数推进，逐步比对体状态
+//
+// 用法: physics_determinism [--steps K=240] [--seed S=1] [--grid G=10] [--layers L=2] [W...=1 8]
+// 场景：围墙内 G×G×L 个半径 0.5 的球紧密堆放，上面压一块盖住全部顶层球的重板（动态 OBB）。
+// 堆与板连成一个大岛：接触数超过 colorThreshold，走图着色分批；板与顶层 G×G 个球各有一个接触，
+// 超过 64 种颜色的部分进入溢出批。关闭休眠，窄相/着色批的每段最少条目调小，使多线程确实切分任务。
+// 每个工作线程数 W 各推进 K 步，每步对全部体的位置与速度求哈希，与第一个 W 逐步比对；
+// 任一步不一致，或场景未走到着色/溢出路径，返回 1。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+#include "BenchCommon.hpp"
+#include "core/physics/PhysicsWorld.hpp"
+#include "core/util/Random.hpp"
+#include "core/util/StateHash.hpp"
+
+namespace {
+	// 位置参数为工作线程数 W
+	struct Options : bench::Options {
+		int grid = 10;
+		int layers = 2;
+	};
+
+	bool ParseOptions(int argc, char **argv, Options &opt) {
+		opt.steps = 240;
+		const bool parsed = bench::ParseOptions(argc, argv, opt, [&opt](const char *name, const char *value) {
+			if (std::strcmp(name, "--grid") == 0) opt.grid = std::atoi(value);
+			else if (std::strcmp(name, "--layers") == 0) opt.layers = std::atoi(value);
+			else return false;
+			return true;
+		});
+		if (!parsed) return false;
+		if (opt.args.empty()) opt.args = {1, 8};
+		for (uint64_t w : opt.args) {
+			if (w < 1) return false;
+		}
+		return opt.grid > 0 && opt.layers > 0;
+	}
+
+	// 一次运行：碰撞体与刚体先于 world 声明，world 先析构
+	struct Pile {
+		std::vector<std::unique_ptr<ColliderBase> > colliders;
+		std::vector<RigidBody> bodies;
+		PhysicsWorld world;
+
+		Pile(const Options &opt, int workers) : world(MakeParams(workers)) {
+			const float half = opt.grid * 0.5f;
+			EntityId next = 1;
+			auto addStatic = [&](DirectX::XMFLOAT3 pos, DirectX::XMFLOAT3 halfExtents) {
+				colliders.push_back(MakeObbCollider(halfExtents));
+				ColliderBase *c = colliders.back().get();
+				c->setIsStatic(true);
+				c->setOwnerWorldPosition(pos);
+				world.registerEntity(next++, nullptr, std::span<ColliderBase *>(&c, 1));
+			};
+			const float wallH = opt.layers + 2.0f;
+			addStatic({0.0f, -0.5f, 0.0f}, {half + 1.0f, 0.5f, half + 1.0f});
+			addStatic({-half - 0.5f, wallH * 0.5f, 0.0f}, {0.5f, wallH * 0.5f, half + 1.0f});
+			addStatic({half + 0.5f, wallH * 0.5f, 0.0f}, {0.5f, wallH * 0.5f, half + 1.0f});
+			addStatic({0.0f, wallH * 0.5f, -half - 0.5f}, {half, wallH * 0.5f, 0.5f});
+			addStatic({0.0f, wallH * 0.5f, half + 0.5f}, {half, wallH * 0.5f, 0.5f});
+
+			// 球：格点上略加扰动与初速度，堆内有持续的挤压与滑动
+			Random rng(opt.seed);
+			bodies.reserve(static_cast<size_t>(opt.grid * opt.grid * opt.layers) + 1);
+			auto addBody = [&](std::unique_ptr<ColliderBase> c, DirectX::XMFLOAT3 pos, float invMass) {
+				bodies.emplace_back();
+				RigidBody &rb = bodies.back();
+				rb.position = pos;
+				rb.invMass = invMass;
+				rb.velocity = {rng.range(-0.5f, 0.5f), 0.0f, rng.range(-0.5f, 0.5f)};
+				ColliderBase *raw = c.get();
+				colliders.push_back(std::move(c));
+				world.registerEntity(next++, &rb, std::span<ColliderBase *>(&raw, 1));
+			};
+			for (int l = 0; l < opt.layers; ++l) {
+				for (int z = 0; z < opt.grid; ++z) {
+					for (int x = 0; x < opt.grid; ++x) {
+						const DirectX::XMFLOAT3 p{
+							x - half + 0.5f + rng.range(-0.05f, 0.05f), 0.5f + l,
+							z - half + 0.5f + rng.range(-0.05f, 0.05f)
+						};
+						addBody(MakeSphereCollider(0.5f), p, 1.0f);
+					}
+				}
+			}
+			// 重板：盖住全部顶层球
+			addBody(MakeObbCollider(DirectX::XMFLOAT3{half - 0.1f, 0.25f, half - 0.1f}),
+			        {0.0f, opt.layers + 0.25f, 0.0f}, 0.02f);
+		}
+
+		static WorldParams MakeParams(int workers) {
+			WorldParams p{};
+			p.narrowPhaseThreads = workers;
+			p.narrowPhaseMinPairsPerJob = 16;
+			p.solver.minContactsPerJob = 8;
+			p.enableSleeping = false;
+			return p;
+		}
+
+		uint64_t hash() const {
+			StateHash h;
+			for (const RigidBody &rb : bodies) {
+				h.add(rb.position);
+				h.add(rb.velocity);
+			}
+			return h.value;
+		}
+	};
+
+	struct Run {
+		std::vector<uint64_t> hashes;
+		bench::Timing timing;
+		size_t maxContacts = 0;
+		size_t coloredSteps = 0; // 走着色路径的步数
+		size_t maxBatches = 0;
+		size_t maxOverflow = 0;
+	};
+
+	Run RunPile(const Options &opt, int workers) {
+		Pile pile(opt, workers);
+		Run run;
+		run.hashes.reserve(static_cast<size_t>(opt.steps));
+		const float dt = 1.0f / 60.0f;
+		for (int s = 0; s < opt.steps; ++s) {
+			const auto t0 = std::chrono::steady_clock::now();
+			pile.world.step(dt);
+			run.timing.add(bench::ElapsedMs(t0));
+			const SolverStats &sv = pile.world.solverStats();
+			run.maxContacts = std::max(run.maxContacts, sv.contactCount);
+			if (sv.coloredIslands > 0) ++run.coloredSteps;
+			run.maxBatches = std::max(run.maxBatches, sv.colorBatches);
+			run.maxOverflow = std::max(run.maxOverflow, sv.overflowContacts);
+			run.hashes.push_back(pile.hash());
+		}
+		return run;
+	}
+}
+
+int main(int argc, char **argv) {
+	Options opt;
+	if (!ParseOptions(argc, argv, opt)) {
+		fprintf(stderr, "usage: physics_determinism [--steps K] [--seed S] [--grid G] [--layers L] [W...]\n");
+		return 2;
+	}
+	printf("pile %dx%dx%d spheres + lid, %d steps, seed %llu\n", opt.grid, opt.grid, opt.layers, opt.steps,
+	       static_cast<unsigned long long>(opt.seed));
+	printf("Workers   mean ms   contacts  colored steps  batches  overflow  result\n");
+	bool ok = true;
+	Run reference;
+	for (size_t r = 0; r < opt.args.size(); ++r) {
+		const int w = static_cast<int>(opt.args[r]);
+		Run run = RunPile(opt, w);
+		const char *result = "reference";
+		if (r == 0) {
+			reference = run;
+		} else {
+			result = "identical";
+			for (size_t s = 0; s < run.hashes.size(); ++s) {
+				if (run.hashes[s] == reference.hashes[s]) continue;
+				printf("  %d workers diverged from %d at step %zu: %016llx vs %016llx\n", w, static_cast<int>(opt.args[0]), s,
+				       static_cast<unsigned long long>(run.hashes[s]),
+				       static_cast<unsigned long long>(reference.hashes[s]));
+				result = "DIVERGED";
+				ok = false;
+				break;
+			}
+		}
+		printf("%7d  %8.3f  %9zu  %13zu  %7zu  %8zu  %s\n", w, run.timing.meanMs(opt.steps), run.maxContacts,
+		       run.coloredSteps, run.maxBatches, run.maxOverflow, result);
+	}
+	// 场景须真正覆盖着色批与溢出批，否则比对没有意义
+	if (reference.coloredSteps == 0 || reference.maxOverflow == 0) {
+		printf("pile did not reach the %s path\n", reference.coloredSteps == 0 ? "graph-colored" : "overflow batch");
+		ok = false;
+	}
+	return ok ? 0 : 1;
+}
@@ -1,7 +1,5 @@
 ﻿#include "Camera.hpp"
 
-#include <cstdlib>
-
 using namespace DirectX;
 
 Camera::Camera() {
@@ -223,10 +221,10 @@ void Camera::update(float dt) {
             float progress = m_shakeTimer / m_shakeDuration;
             float decay = 1.0f - progress; // 线性衰减
 
-            // 生成随机偏移量（使用简单的伪随机）
-            float randomX = (static_cast<float>(std::rand()) / RAND_MAX * 2.0f - 1.0f) * m_shakeIntensity * decay;
-            float randomY = (static_cast<float>(std::rand()) / RAND_MAX * 2.0f - 1.0f) * m_shakeIntensity * decay;
-            float randomZ = (static_cast<float>(std::rand()) / RAND_MAX * 2.0f - 1.0f) * m_shakeIntensity * decay;
+            // 生成随机偏移量
+            float randomX = m_shakeRng.range(-1.0f, 1.0f) * m_shakeIntensity * decay;
+            float randomY = m_shakeRng.range(-1.0f, 1.0f) * m_shakeIntensity * decay;
+            float randomZ = m_shakeRng.range(-1.0f, 1.0f) * m_shakeIntensity * decay;
 
             m_shakeOffset = XMFLOAT3{randomX, randomY, randomZ};
         }
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include <DirectXMath.h>
+#include "core/util/Random.hpp"
 
 // 相机模式
 enum class CameraMode {
@@ -118,4 +119,5 @@ private:
     float m_shakeDuration = 0.0f; // 抖动持续时间
     float m_shakeTimer = 0.0f; // 抖动计时器
     DirectX::XMFLOAT3 m_shakeOffset{0, 0, 0}; // 当前抖动偏移量
+    Random m_shakeRng{0x5eed}; // 抖动专用随机数：相机按帧更新，不能消耗场景模拟的随机序列
 };
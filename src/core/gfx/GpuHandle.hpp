@@ -0,0 +1,38 @@
+﻿#pragma once
+#include <memory>
+
+// D3D11 接口前置声明：头文件之间只传递这些对象的指针，不依赖 <d3d11.h>，
+// 因此 Mesh / Texture / Model / Material 可以在无 D3D11 的 headless 构建中使用
+struct ID3D11Device;
+struct ID3D11Buffer;
+struct ID3D11ShaderResourceView;
+
+// GPU 对象的共享引用（语义同 ComPtr：拷贝即共享，最后一个引用析构时 Release）
+template<typename T>
+using GpuRef = std::shared_ptr<T>;
+
+// 接管一个创建函数返回的 COM 指针（实例化处需包含完整的 D3D11 头文件）
+template<typename T>
+GpuRef<T> AdoptGpu(T *p) {
+    return p ? GpuRef<T>(p, [](T *q) { q->Release(); }) : GpuRef<T>();
+}
+
+// D3D 创建函数 T** 输出参数的适配，语义同 ComPtr::ReleaseAndGetAddressOf：
+// device->CreateBuffer(&desc, &init, GpuOut(m_vb))，调用所在的完整表达式结束时接管结果
+template<typename T>
+class GpuOutParam {
+public:
+    explicit GpuOutParam(GpuRef<T> &ref) : ref_(ref) {
+    }
+
+    ~GpuOutParam() { ref_ = AdoptGpu(raw_); }
+
+    operator T **() { return &raw_; }
+
+private:
+    GpuRef<T> &ref_;
+    T *raw_ = nullptr;
+};
+
+template<typename T>
+GpuOutParam<T> GpuOut(GpuRef<T> &ref) { return GpuOutParam<T>(ref); }
@@ -4,6 +4,8 @@
 
 #include "Mesh.hpp"
 
+#include <d3d11.h>
+
 #include <iterator>
 
 #include "Vertex.hpp"
@@ -34,7 +36,7 @@ bool Mesh::createQuadXY(ID3D11Device *dev, float w, float h, float z) {
     vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
     D3D11_SUBRESOURCE_DATA vinit{};
     vinit.pSysMem = v;
-    if (FAILED(dev->CreateBuffer(&vbDesc, &vinit, m_vb.ReleaseAndGetAddressOf()))) return false;
+    if (FAILED(dev->CreateBuffer(&vbDesc, &vinit, GpuOut(m_vb)))) return false;
 
 
     D3D11_BUFFER_DESC ibDesc{};
@@ -43,7 +45,7 @@ bool Mesh::createQuadXY(ID3D11Device *dev, float w, float h, float z) {
     ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
     D3D11_SUBRESOURCE_DATA iinit{};
     iinit.pSysMem = idx;
-    if (FAILED(dev->CreateBuffer(&ibDesc, &iinit, m_ib.ReleaseAndGetAddressOf()))) return false;
+    if (FAILED(dev->CreateBuffer(&ibDesc, &iinit, GpuOut(m_ib)))) return false;
 
 
     return true;
@@ -115,12 +117,12 @@ bool Mesh::createCube(ID3D11Device *dev, float h) {
     bd.ByteWidth = (UINT) (m_vertices.size() * sizeof(VertexPNCT));
     bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
     sd.pSysMem = m_vertices.data();
-    if (FAILED(dev->CreateBuffer(&bd, &sd, m_vb.ReleaseAndGetAddressOf()))) return false;
+    if (FAILED(dev->CreateBuffer(&bd, &sd, GpuOut(m_vb)))) return false;
 
     bd.ByteWidth = (UINT) (m_indices.size() * sizeof(uint16_t));
     bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
     sd.pSysMem = m_indices.data();
-    if (FAILED(dev->CreateBuffer(&bd, &sd, m_ib.ReleaseAndGetAddressOf()))) return false;
+    if (FAILED(dev->CreateBuffer(&bd, &sd, GpuOut(m_ib)))) return false;
 
     return true;
 }
@@ -144,12 +146,12 @@ bool Mesh::createFromPNCT(ID3D11Device *dev,
     bd.ByteWidth = (UINT) (m_vertices.size() * sizeof(VertexPNCT));
     bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
     sd.pSysMem = m_vertices.data();
-    if (FAILED(dev->CreateBuffer(&bd, &sd, m_vb.ReleaseAndGetAddressOf()))) return false;
+    if (FAILED(dev->CreateBuffer(&bd, &sd, GpuOut(m_vb)))) return false;
 
     bd.ByteWidth = (UINT) (m_indices.size() * sizeof(uint16_t));
     bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
     sd.pSysMem = m_indices.data();
-    if (FAILED(dev->CreateBuffer(&bd, &sd, m_ib.ReleaseAndGetAddressOf()))) return false;
+    if (FAILED(dev->CreateBuffer(&bd, &sd, GpuOut(m_ib)))) return false;
 
     return true;
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
 ﻿#pragma once
-#include <d3d11.h>
-#include <wrl/client.h>
 #include <DirectXMath.h>
+#include <cstdint>
 #include <vector>
 
+#include "GpuHandle.hpp"
 #include "Vertex.hpp"
 
 class Mesh {
@@ -18,20 +18,20 @@ public:
                         const std::vector<uint16_t> &indices);
 
     // Getters for rendering data
-    ID3D11Buffer *vertexBuffer() const { return m_vb.Get(); }
-    ID3D11Buffer *indexBuffer() const { return m_ib.Get(); }
-    UINT stride() const { return m_stride; }
-    UINT indexCount() const { return m_indexCount; }
+    ID3D11Buffer *vertexBuffer() const { return m_vb.get(); }
+    ID3D11Buffer *indexBuffer() const { return m_ib.get(); }
+    uint32_t stride() const { return m_stride; }
+    uint32_t indexCount() const { return m_indexCount; }
 
     // CPU-side vertex data access (for collision/physics)
     const std::vector<VertexPNCT> &vertices() const { return m_vertices; }
     const std::vector<uint16_t> &indices() const { return m_indices; }
 
 private:
-    Microsoft::WRL::ComPtr<ID3D11Buffer> m_vb;
-    Microsoft::WRL::ComPtr<ID3D11Buffer> m_ib;
-    UINT m_stride = sizeof(VertexPC);
-    UINT m_indexCount = 0;
+    GpuRef<ID3D11Buffer> m_vb;
+    GpuRef<ID3D11Buffer> m_ib;
+    uint32_t m_stride = sizeof(VertexPC);
+    uint32_t m_indexCount = 0;
 
     // CPU-side copy for collision detection and other CPU operations
     std::vector<VertexPNCT> m_vertices;
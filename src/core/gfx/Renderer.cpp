@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cstring>
 #include "../render/Drawable.hpp"
+#include "../resource/ResourceManagerD3D11.hpp"
 #include <vector>
 #include <unordered_map>
 using namespace DirectX;
@@ -208,6 +209,10 @@ void Renderer::shutdown() {
 void Renderer::beginFrame(float r, float g, float b, float a) { m_dev.clear(r, g, b, a); }
 void Renderer::endFrame() { m_dev.present(); }
 
+std::unique_ptr<ResourceManager> Renderer::createResourceManager() {
+    return std::make_unique<ResourceManagerD3D11>(device());
+}
+
 void Renderer::beginFrame() {
     opaqueItems_.clear();
     transparentItems_.clear();
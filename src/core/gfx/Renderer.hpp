@@ -9,6 +9,7 @@
 #include "../physics/Collider.hpp"
 #include "../physics/Transform.hpp"
 #include "../render/Material.hpp"
+#include "../render/IRenderer.hpp"
 #include <DirectXMath.h>
 #include <deque>
 #include <vector>
@@ -19,7 +20,8 @@
 // Forward declare to avoid heavy include in header
 struct IDrawable;
 
-class Renderer {
+// D3D11 渲染器（IRenderer 的窗口版实现）
+class Renderer : public IRenderer {
 public:
     bool initialize(HWND hwnd, unsigned width, unsigned height, bool debug = false);
 
@@ -29,19 +31,11 @@ public:
 
     void endFrame();
 
-    struct DrawItem {
-        const Mesh *mesh = nullptr;
-        const Material *material = nullptr;
-        Transform transform{};
-        float alpha = 1.0f;
-        bool transparent = false;
-    };
-
-    void beginFrame();
+    void beginFrame() override;
 
-    void submit(const DrawItem &item);
+    void submit(const DrawItem &item) override;
 
-    void endFrame(const Camera &camera);
+    void endFrame(const Camera &camera) override;
 
     // Draw mesh with transform matrix and texture
     void drawMesh(const Mesh &mesh, const DirectX::XMMATRIX &transform, const Texture &texture,
@@ -49,13 +43,13 @@ public:
 
     // Draw a full model: iterate draw items, combine model transform with node transforms
     void drawModel(const Model &model, const DirectX::XMMATRIX &modelTransform,
-                   const DirectX::XMFLOAT4 *baseColorFactor = nullptr);
+                   const DirectX::XMFLOAT4 *baseColorFactor = nullptr) override;
 
     // Draw via drawable interface (adapter)
-    void draw(const IDrawable &drawable);
+    void draw(const IDrawable &drawable) override;
 
     // Debug draw helpers for colliders (wireframe via line list)
-    void drawColliderWire(const ColliderBase &col);
+    void drawColliderWire(const ColliderBase &col) override;
 
     void drawCollidersWire(const std::vector<ColliderBase *> &cols);
 
@@ -82,7 +76,7 @@ public:
     const Camera &getCamera() const { return m_camera; }
 
     // 设置当前帧使用的 Camera（由 Scene 提供）
-    void setCamera(const Camera *camera) { m_externalCamera = camera; }
+    void setCamera(const Camera *camera) override { m_externalCamera = camera; }
 
     void drawUiQuad(float x, float y, float width, float height,
                     ID3D11ShaderResourceView *texture,
@@ -91,7 +85,7 @@ public:
                     float uvOffsetX = 0.0f,
                     float uvOffsetY = 0.0f,
                     float uvScaleX = 1.0f,
-                    float uvScaleY = 1.0f);
+                    float uvScaleY = 1.0f) override;
 
     const Texture &defaultTexture() const { return m_defaultTexture; }
 
@@ -103,27 +97,23 @@ public:
     void drawCube(const DirectX::XMMATRIX &worldTransform);
 
     // Device accessor for resource initialization
-    ID3D11Device *device() const { return m_dev.device(); }
+    ID3D11Device *device() const override { return m_dev.device(); }
+
+    // 创建在本设备上加载资源的 ResourceManagerD3D11
+    std::unique_ptr<ResourceManager> createResourceManager() override;
 
     // Render state management for transparent objects (Billboard)
-    void setAlphaBlending(bool enable);
+    void setAlphaBlending(bool enable) override;
 
-    void setDepthWrite(bool enable);
+    void setDepthWrite(bool enable) override;
 
-    void setBackfaceCulling(bool enable);
+    void setBackfaceCulling(bool enable) override;
 
     // Ribbon/Trail rendering (dynamic mesh with optional texture)
-    struct RibbonVertex {
-        DirectX::XMFLOAT3 position;
-        DirectX::XMFLOAT3 normal;
-        DirectX::XMFLOAT4 color;
-        DirectX::XMFLOAT2 texCoord;
-    };
-
     void drawRibbon(const std::vector<RibbonVertex> &vertices,
                     const std::vector<uint16_t> &indices,
                     ID3D11ShaderResourceView *texture,
-                    const DirectX::XMFLOAT4 &baseColor);
+                    const DirectX::XMFLOAT4 &baseColor) override;
 
     // Outline effect for selected entities (dual-pass method)
     void setOutlineColor(const DirectX::XMFLOAT4 &color) { m_outlineColor = color; }
@@ -134,12 +124,12 @@ public:
 
     bool loadSkyboxCubeMap(const std::wstring &rightPath, const std::wstring &leftPath,
                            const std::wstring &topPath, const std::wstring &bottomPath,
-                           const std::wstring &frontPath, const std::wstring &backPath);
+                           const std::wstring &frontPath, const std::wstring &backPath) override;
 
     bool loadSkyboxFromDDS(const std::wstring &ddsPath);
 
     bool createSolidColorSkybox(unsigned char r = 255, unsigned char g = 255,
-                                unsigned char b = 255, unsigned char a = 255);
+                                unsigned char b = 255, unsigned char a = 255) override;
 
     void enableSkybox(bool enable) { m_skyboxEnabled = enable; }
     bool isSkyboxEnabled() const { return m_skyboxEnabled && m_skybox && m_skybox->isValid(); }
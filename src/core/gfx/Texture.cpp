@@ -1,4 +1,5 @@
 ﻿#include "Texture.hpp"
+#include <d3d11.h>
 #include <DirectXTex.h>
 #include <wrl/client.h>
 #include <cwctype>
@@ -33,7 +34,7 @@ bool Texture::loadFromFile(ID3D11Device *device, const std::wstring &filepath) {
 
     // Create shader resource view
     hr = CreateShaderResourceView(device, image.GetImages(), image.GetImageCount(),
-                                  metadata, m_srv.ReleaseAndGetAddressOf());
+                                  metadata, GpuOut(m_srv));
 
     if (FAILED(hr)) {
         wprintf(L"Failed to create SRV, HRESULT: 0x%08X\n", hr);
@@ -84,7 +85,7 @@ bool Texture::loadFromMemory(ID3D11Device *device, const void *data, size_t size
     }
 
     hr = CreateShaderResourceView(device, image.GetImages(), image.GetImageCount(), metadata,
-                                  m_srv.ReleaseAndGetAddressOf());
+                                  GpuOut(m_srv));
     return SUCCEEDED(hr);
 }
 
@@ -118,7 +119,7 @@ bool Texture::createFromRGBA(ID3D11Device *device, const void *rgbaPixels, uint3
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Texture2D.MipLevels = 1;
 
-    hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, m_srv.ReleaseAndGetAddressOf());
+    hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, GpuOut(m_srv));
     return SUCCEEDED(hr);
 }
 
@@ -154,7 +155,7 @@ bool Texture::createSolidColor(ID3D11Device *device, unsigned char r, unsigned c
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Texture2D.MipLevels = 1;
 
-    hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, m_srv.ReleaseAndGetAddressOf());
+    hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, GpuOut(m_srv));
 
     return SUCCEEDED(hr);
 }
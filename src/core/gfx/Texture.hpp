@@ -1,10 +1,10 @@
 ﻿#pragma once
-#include <d3d11.h>
-#include <wrl/client.h>
 #include <string>
 #include <vector>
 #include <cstdint>
 
+#include "GpuHandle.hpp"
+
 class Texture {
 public:
     Texture() = default;
@@ -25,11 +25,11 @@ public:
     bool createSolidColor(ID3D11Device *device, unsigned char r, unsigned char g, unsigned char b, unsigned char a);
 
     // Get shader resource view
-    ID3D11ShaderResourceView *srv() const { return m_srv.Get(); }
+    ID3D11ShaderResourceView *srv() const { return m_srv.get(); }
 
     // Check if texture is loaded
     bool isValid() const { return m_srv != nullptr; }
 
 private:
-    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_srv;
+    GpuRef<ID3D11ShaderResourceView> m_srv;
 };
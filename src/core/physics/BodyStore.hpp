@@ -0,0 +1,100 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <initializer_list>
+#include <DirectXMath.h>
+
+// 体状态的冷数据（材质、CCD、休眠计数等），每体一个结构
+struct BodyState {
+    DirectX::XMFLOAT3 pSynced{0, 0, 0}; // 最近一次写入 Collider 的位置（未变化时跳过同步）
+    float restitution = 0.2f;
+    float muS = 0.6f;
+    float muK = 0.5f;
+    bool ccd = false; // 允许连续碰撞检测（来自 RigidBody::ccd）
+    int ccdSlot = -1; // 本步走扫掠检测时在 PhysicsWorld::ccdBodies_ 中的下标，否则 -1
+    int restFrames = 0; // 速度连续低于休眠阈值的步数
+    int sleepPrev = -1; // 休眠时同岛的体串成环形双链表（同岛一起唤醒，只走本岛）；醒着为 -1
+    int sleepNext = -1;
+};
+
+// PhysicsWorld 内部的体状态（SoA）
+// - 积分用到的热数据按分量分列，积分核一次处理 4/8 个体（见 Integrator.hpp）；
+// - 冷数据在 state 里；所有列等长，下标即体下标，删除时与末尾交换后弹出。
+struct BodyStore {
+    std::vector<float> px, py, pz; // 位置
+    std::vector<float> vx, vy, vz; // 速度
+    std::vector<float> qx, qy, qz; // 上一位置（积分前，解算后从这里重新积分）
+    std::vector<float> fx, fy, fz; // 本步外力（来自 RigidBody::forceAccum）
+    std::vector<float> invMass; // 0 表示静态
+    std::vector<uint32_t> asleep; // 1 表示休眠：不积分、不参与检测
+    std::vector<BodyState> state;
+
+    size_t size() const { return state.size(); }
+
+    void push(const BodyState &s, const DirectX::XMFLOAT3 &p, const DirectX::XMFLOAT3 &v, float im) {
+        px.push_back(p.x);
+        py.push_back(p.y);
+        pz.push_back(p.z);
+        vx.push_back(v.x);
+        vy.push_back(v.y);
+        vz.push_back(v.z);
+        qx.push_back(p.x);
+        qy.push_back(p.y);
+        qz.push_back(p.z);
+        fx.push_back(0.0f);
+        fy.push_back(0.0f);
+        fz.push_back(0.0f);
+        invMass.push_back(im);
+        asleep.push_back(0);
+        state.push_back(s);
+    }
+
+    void swap(size_t a, size_t b) {
+        forEachLane([a, b](auto &lane) { std::swap(lane[a], lane[b]); });
+    }
+
+    void pop_back() {
+        forEachLane([](auto &lane) { lane.pop_back(); });
+    }
+
+    bool isDynamic(size_t i) const { return invMass[i] > 0.0f; }
+
+    DirectX::XMFLOAT3 position(size_t i) const { return {px[i], py[i], pz[i]}; }
+    DirectX::XMFLOAT3 velocity(size_t i) const { return {vx[i], vy[i], vz[i]}; }
+    DirectX::XMFLOAT3 prevPosition(size_t i) const { return {qx[i], qy[i], qz[i]}; }
+
+    void setPosition(size_t i, const DirectX::XMFLOAT3 &p) {
+        px[i] = p.x;
+        py[i] = p.y;
+        pz[i] = p.z;
+    }
+
+    void setVelocity(size_t i, const DirectX::XMFLOAT3 &v) {
+        vx[i] = v.x;
+        vy[i] = v.y;
+        vz[i] = v.z;
+    }
+
+    void setPrevPosition(size_t i, const DirectX::XMFLOAT3 &p) {
+        qx[i] = p.x;
+        qy[i] = p.y;
+        qz[i] = p.z;
+    }
+
+    void setForce(size_t i, const DirectX::XMFLOAT3 &f) {
+        fx[i] = f.x;
+        fy[i] = f.y;
+        fz[i] = f.z;
+    }
+
+private:
+    template<class Fn>
+    void forEachLane(Fn &&fn) {
+        for (auto *lane: {&px, &py, &pz, &vx, &vy, &vz, &qx, &qy, &qz, &fx, &fy, &fz, &invMass}) fn(*lane);
+        fn(asleep);
+        fn(state);
+    }
+};
@@ -0,0 +1,619 @@
+﻿#include "BroadPhase.hpp"
+#include "SweepAndPrune.hpp"
+#include "StaticBvh.hpp"
+#include "PairTable.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace {
+    // 规范化（确保 min <= max）
+    inline Aabb normalized(const Aabb &b) {
+        return Aabb{
+            XMFLOAT3{std::min(b.min.x, b.max.x), std::min(b.min.y, b.max.y), std::min(b.min.z, b.max.z)},
+            XMFLOAT3{std::max(b.min.x, b.max.x), std::max(b.min.y, b.max.y), std::max(b.min.z, b.max.z)}
+        };
+    }
+
+    inline bool overlaps(const Aabb &a, const Aabb &b) {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+               a.min.y <= b.max.y && b.min.y <= a.max.y &&
+               a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+
+    // 各策略共用的代理表：id → (collider, AABB, 碰撞过滤, 静态/休眠标记)，空闲 id 复用
+    class ProxyTable {
+    public:
+        struct Entry {
+            ColliderBase *collider = nullptr;
+            Aabb box{};
+            CollisionFilter filter{};
+            int32_t inner = -1; // 策略内部结构中的下标（如 SAP 代理 id）
+            bool isStatic = false;
+            bool sleeping = false;
+            bool alive = false;
+        };
+
+        int32_t add(ColliderBase *collider, const Aabb &box, bool isStatic, const CollisionFilter &filter) {
+            int32_t id;
+            if (!freeList_.empty()) {
+                id = freeList_.back();
+                freeList_.pop_back();
+            } else {
+                id = static_cast<int32_t>(entries_.size());
+                entries_.emplace_back();
+            }
+            Entry &e = entries_[id];
+            e.collider = collider;
+            e.box = normalized(box);
+            e.filter = filter;
+            e.inner = -1;
+            e.isStatic = isStatic;
+            e.alive = true;
+            if (isStatic) ++staticCount_;
+            return id;
+        }
+
+        void remove(int32_t id) {
+            if (!valid(id)) return;
+            if (entries_[id].isStatic) --staticCount_;
+            if (entries_[id].sleeping) --sleepingCount_;
+            entries_[id] = Entry{};
+            freeList_.push_back(id);
+        }
+
+        // 设置休眠标记；静态代理不休眠。返回标记是否变化
+        bool setSleeping(int32_t id, bool sleeping) {
+            if (!valid(id)) return false;
+            Entry &e = entries_[id];
+            if (e.isStatic || e.sleeping == sleeping) return false;
+            e.sleeping = sleeping;
+            if (sleeping) ++sleepingCount_;
+            else --sleepingCount_;
+            return true;
+        }
+
+        bool valid(int32_t id) const {
+            return id >= 0 && id < static_cast<int32_t>(entries_.size()) && entries_[id].alive;
+        }
+
+        Entry &operator[](int32_t id) { return entries_[id]; }
+        const Entry &operator[](int32_t id) const { return entries_[id]; }
+
+        int32_t capacity() const { return static_cast<int32_t>(entries_.size()); }
+        size_t count() const { return entries_.size() - freeList_.size(); }
+        size_t staticCount() const { return staticCount_; }
+        size_t sleepingCount() const { return sleepingCount_; }
+
+    private:
+        std::vector<Entry> entries_;
+        std::vector<int32_t> freeList_;
+        size_t staticCount_ = 0;
+        size_t sleepingCount_ = 0;
+    };
+
+    // ---------------- SAP（动态）+ 静态 BVH ----------------
+    class SapBroadPhase final : public IBroadPhase {
+    public:
+        BroadPhaseType type() const override { return BroadPhaseType::SweepAndPrune; }
+        const char *name() const override { return "SweepAndPrune"; }
+
+        ProxyId addProxy(ColliderBase *collider, const Aabb &box, bool isStatic,
+                         const CollisionFilter &filter) override {
+            const ProxyId id = proxies_.add(collider, box, isStatic, filter);
+            if (isStatic) {
+                // 静态代理不进 SAP，延迟到下一次 computePairs 统一重建 BVH
+                staticDirty_ = true;
+            } else if (batching_) {
+                // 批量中：暂不进 SAP（inner 保持 -1），endBatch 时统一插入
+                pendingAdds_.push_back(id);
+            } else {
+                proxies_[id].inner = sap_.addProxy(collider, proxies_[id].box, false, filter);
+            }
+            return id;
+        }
+
+        void removeProxy(ProxyId id) override {
+            if (!proxies_.valid(id)) return;
+            const auto &e = proxies_[id];
+            if (e.isStatic) staticDirty_ = true;
+            else if (e.inner < 0) pendingAdds_.erase(std::remove(pendingAdds_.begin(), pendingAdds_.end(), id),
+                                                     pendingAdds_.end()); // 同一批次内加入又移除
+            else if (batching_) pendingRemoves_.push_back(e.inner);
+            else sap_.removeProxy(e.inner);
+            proxies_.remove(id);
+        }
+
+        void updateProxy(ProxyId id, const Aabb &box) override {
+            if (!proxies_.valid(id)) return;
+            auto &e = proxies_[id];
+            e.box = normalized(box);
+            if (e.isStatic) staticDirty_ = true;
+            else if (e.inner >= 0) sap_.updateProxy(e.inner, e.box); // 待插入的代理在 endBatch 时取最新包围盒
+        }
+
+        void beginBatch() override { batching_ = true; }
+
+        void endBatch() override {
+            batching_ = false;
+            // 先删后加，释放的 SAP 槽位可被新代理复用
+            sap_.removeProxies(pendingRemoves_);
+            pendingRemoves_.clear();
+            if (pendingAdds_.empty()) return;
+            std::vector<SweepAndPrune::ProxyDesc> descs;
+            descs.reserve(pendingAdds_.size());
+            for (ProxyId id: pendingAdds_) {
+                const auto &e = proxies_[id];
+                descs.push_back(SweepAndPrune::ProxyDesc{e.collider, e.box, false, e.filter});
+            }
+            std::vector<SweepAndPrune::ProxyId> inner;
+            sap_.addProxies(descs, inner);
+            for (size_t i = 0; i < pendingAdds_.size(); ++i) {
+                auto &e = proxies_[pendingAdds_[i]];
+                e.inner = inner[i];
+                if (e.sleeping) sap_.setSleeping(e.inner, true);
+            }
+            pendingAdds_.clear();
+        }
+
+        ColliderBase *collider(ProxyId id) const override {
+            return proxies_.valid(id) ? proxies_[id].collider : nullptr;
+        }
+
+        void setProxyFilter(ProxyId id, const CollisionFilter &filter) override {
+            if (!proxies_.valid(id)) return;
+            auto &e = proxies_[id];
+            e.filter = filter;
+            if (e.inner >= 0) sap_.setFilter(e.inner, filter); // 待插入的代理在 endBatch 时取最新过滤
+        }
+
+        void setProxySleeping(ProxyId id, bool sleeping) override {
+            if (!proxies_.setSleeping(id, sleeping)) return;
+            const auto &e = proxies_[id];
+            if (e.inner >= 0) sap_.setSleeping(e.inner, sleeping); // 待插入的代理在 endBatch 时取最新标记
+        }
+
+        void computePairs(std::vector<ColliderPair> &out, BroadPhaseStats &stats) override {
+            stats.staticRebuilt = false;
+            if (staticDirty_) {
+                rebuildStatic();
+                staticDirty_ = false;
+                stats.staticRebuilt = true;
+            }
+
+            // 统计本步（含两次 step 之间注册/反注册引起的）重叠对增减
+            stats.pairsAdded = 0;
+            stats.pairsRemoved = 0;
+            for (const auto &ev: sap_.events()) {
+                if (ev.type == SweepAndPrune::PairEventType::Added) ++stats.pairsAdded;
+                else ++stats.pairsRemoved;
+            }
+            sap_.clearEvents();
+
+            out.clear();
+            size_t filtered = 0;
+            // 动态-动态：SAP 持久重叠对（双方都休眠的对跳过）
+            for (const auto &pr: sap_.pairs()) {
+                if (sap_.sleeping(pr.a) && sap_.sleeping(pr.b)) continue;
+                if (sap_.filter(pr.a).accepts(sap_.filter(pr.b))) out.emplace_back(sap_.collider(pr.a), sap_.collider(pr.b));
+                else ++filtered;
+            }
+            // 动态-静态：以每个醒着的 SAP 代理的 AABB 查询静态 BVH（按代理 id 顺序，结果确定）
+            if (!staticBvh_.empty()) {
+                sap_.forEachProxy([this, &out, &filtered](SweepAndPrune::ProxyId id, ColliderBase *c, const Aabb &box) {
+                    if (sap_.sleeping(id)) return;
+                    const CollisionFilter &f = sap_.filter(id);
+                    staticBvh_.query(box, [this, &out, &filtered, &f, c](const StaticBvh::Item &it) {
+                        if (f.accepts(proxies_[it.proxy].filter)) out.emplace_back(c, it.collider);
+                        else ++filtered;
+                    });
+                });
+            }
+            stats.pairsFiltered = filtered;
+
+            stats.proxyCount = proxies_.count();
+            stats.staticCount = proxies_.staticCount();
+            stats.sleepingCount = proxies_.sleepingCount();
+            stats.pairCount = out.size();
+        }
+
+    private:
+        void rebuildStatic() {
+            std::vector<StaticBvh::Item> items;
+            items.reserve(proxies_.staticCount());
+            for (ProxyId id = 0; id < proxies_.capacity(); ++id) {
+                const auto &e = proxies_[id];
+                if (e.alive && e.isStatic) items.push_back(StaticBvh::Item{e.box, e.collider, id});
+            }
+            staticBvh_.build(std::move(items));
+        }
+
+        ProxyTable proxies_;
+        SweepAndPrune sap_;
+        StaticBvh staticBvh_;
+        bool staticDirty_ = false;
+
+        // 批量增删（外层代理 id；移除记录 SAP 内部 id）
+        bool batching_ = false;
+        std::vector<ProxyId> pendingAdds_;
+        std::vector<SweepAndPrune::ProxyId> pendingRemoves_;
+    };
+
+    // ---------------- 动态 BVH（每步重建）+ 休眠 BVH（休眠集合变化时重建）+ 静态 BVH ----------------
+    class BvhBroadPhase final : public IBroadPhase {
+    public:
+        BroadPhaseType type() const override { return BroadPhaseType::Bvh; }
+        const char *name() const override { return "Bvh"; }
+
+        ProxyId addProxy(ColliderBase *collider, const Aabb &box, bool isStatic,
+                         const CollisionFilter &filter) override {
+            const ProxyId id = proxies_.add(collider, box, isStatic, filter);
+            if (isStatic) staticDirty_ = true;
+            return id;
+        }
+
+        void removeProxy(ProxyId id) override {
+            if (!proxies_.valid(id)) return;
+            if (proxies_[id].isStatic) staticDirty_ = true;
+            if (proxies_[id].sleeping) sleepingDirty_ = true;
+            proxies_.remove(id);
+        }
+
+        void updateProxy(ProxyId id, const Aabb &box) override {
+            if (!proxies_.valid(id)) return;
+            auto &e = proxies_[id];
+            e.box = normalized(box);
+            if (e.isStatic) staticDirty_ = true;
+            if (e.sleeping) sleepingDirty_ = true;
+        }
+
+        ColliderBase *collider(ProxyId id) const override {
+            return proxies_.valid(id) ? proxies_[id].collider : nullptr;
+        }
+
+        void setProxyFilter(ProxyId id, const CollisionFilter &filter) override {
+            if (proxies_.valid(id)) proxies_[id].filter = filter;
+        }
+
+        void setProxySleeping(ProxyId id, bool sleeping) override {
+            if (proxies_.setSleeping(id, sleeping)) sleepingDirty_ = true;
+        }
+
+        void computePairs(std::vector<ColliderPair> &out, BroadPhaseStats &stats) override {
+            stats.staticRebuilt = false;
+            stats.pairsAdded = 0;
+            stats.pairsRemoved = 0;
+
+            std::vector<StaticBvh::Item> statics;
+            std::vector<StaticBvh::Item> sleepers;
+            dynamicItems_.clear();
+            for (ProxyId id = 0; id < proxies_.capacity(); ++id) {
+                const auto &e = proxies_[id];
+                if (!e.alive) continue;
+                if (e.isStatic) {
+                    if (staticDirty_) statics.push_back(StaticBvh::Item{e.box, e.collider, id});
+                } else if (e.sleeping) {
+                    if (sleepingDirty_) sleepers.push_back(StaticBvh::Item{e.box, e.collider, id});
+                } else {
+                    dynamicItems_.push_back(StaticBvh::Item{e.box, e.collider, id});
+                }
+            }
+            if (staticDirty_) {
+                staticBvh_.build(std::move(statics));
+                staticDirty_ = false;
+                stats.staticRebuilt = true;
+            }
+            if (sleepingDirty_) {
+                sleepingTree_.build(std::move(sleepers));
+                sleepingDirty_ = false;
+            }
+            dynamicTree_.build(dynamicItems_);
+
+            out.clear();
+            size_t filtered = 0;
+            auto emit = [this, &out, &filtered](const StaticBvh::Item &d, const StaticBvh::Item &it) {
+                if (proxies_[d.proxy].filter.accepts(proxies_[it.proxy].filter)) out.emplace_back(d.collider, it.collider);
+                else ++filtered;
+            };
+            // 醒着-醒着：只输出 id 较大的一方，避免重复
+            for (const auto &d: dynamicItems_) {
+                dynamicTree_.query(d.box, [&emit, &d](const StaticBvh::Item &it) {
+                    if (it.proxy > d.proxy) emit(d, it);
+                });
+            }
+            // 醒着-休眠：休眠代理只作为查询目标
+            if (!sleepingTree_.empty()) {
+                for (const auto &d: dynamicItems_) {
+                    sleepingTree_.query(d.box, [&emit, &d](const StaticBvh::Item &it) { emit(d, it); });
+                }
+            }
+            // 动态-静态
+            if (!staticBvh_.empty()) {
+                for (const auto &d: dynamicItems_) {
+                    staticBvh_.query(d.box, [&emit, &d](const StaticBvh::Item &it) { emit(d, it); });
+                }
+            }
+            stats.pairsFiltered = filtered;
+
+            stats.proxyCount = proxies_.count();
+            stats.staticCount = proxies_.staticCount();
+            stats.sleepingCount = proxies_.sleepingCount();
+            stats.pairCount = out.size();
+        }
+
+    private:
+        ProxyTable proxies_;
+        StaticBvh staticBvh_;
+        StaticBvh dynamicTree_;
+        StaticBvh sleepingTree_;
+        std::vector<StaticBvh::Item> dynamicItems_; // 醒着的动态代理
+        bool staticDirty_ = false;
+        bool sleepingDirty_ = false;
+    };
+
+    // ---------------- 均匀网格空间哈希 ----------------
+    // 设计要点：
+    // - 格子坐标 (ix,iy,iz) 各取 21 位打包为 64 位键，网格无界且无哈希冲突；
+    // - 每个格子一个按代理 id 升序的桶，格子键 → 桶下标 用开放寻址表索引，空桶回收复用；
+    // - 入格增量维护：增删代理、休眠切换只改动其覆盖的格子，移动只在覆盖的格子范围变化时重新入格，
+    //   不存在整表重建，也没有每步排序；
+    // - 只有醒着的动态代理作为候选对来源；
+    // - 覆盖格子数过多的代理（超大包围盒）不入格，单独与其它代理逐一比较；
+    // - 候选对无需去重表：一对代理只在二者格子范围交集的最小角格子上输出，
+    //   两个醒着的动态代理只由 id 较小者输出。
+    class SpatialHashBroadPhase final : public IBroadPhase {
+    public:
+        explicit SpatialHashBroadPhase(float cellSize)
+            : cellSize_(cellSize > 0.0f ? cellSize : 1.0f), invCellSize_(1.0f / cellSize_) {
+        }
+
+        BroadPhaseType type() const override { return BroadPhaseType::SpatialHash; }
+        const char *name() const override { return "SpatialHash"; }
+
+        ProxyId addProxy(ColliderBase *collider, const Aabb &box, bool isStatic,
+                         const CollisionFilter &filter) override {
+            const ProxyId id = proxies_.add(collider, box, isStatic, filter);
+            if (static_cast<size_t>(id) >= bins_.size()) bins_.resize(static_cast<size_t>(id) + 1);
+            bin(id);
+            return id;
+        }
+
+        void removeProxy(ProxyId id) override {
+            if (!proxies_.valid(id)) return;
+            unbin(id);
+            proxies_.remove(id);
+        }
+
+        void updateProxy(ProxyId id, const Aabb &box) override {
+            if (!proxies_.valid(id)) return;
+            auto &e = proxies_[id];
+            e.box = normalized(box);
+            const CellRange r = cellRange(e.box);
+            if (r == bins_[id].range) return; // 覆盖的格子未变，桶无需改动
+            unbin(id);
+            bin(id);
+        }
+
+        ColliderBase *collider(ProxyId id) const override {
+            return proxies_.valid(id) ? proxies_[id].collider : nullptr;
+        }
+
+        void setProxyFilter(ProxyId id, const CollisionFilter &filter) override {
+            if (proxies_.valid(id)) proxies_[id].filter = filter;
+        }
+
+        void setProxySleeping(ProxyId id, bool sleeping) override {
+            if (!proxies_.valid(id) || proxies_[id].isStatic || proxies_[id].sleeping == sleeping) return;
+            unbin(id);
+            proxies_.setSleeping(id, sleeping);
+            bin(id);
+        }
+
+        void computePairs(std::vector<ColliderPair> &out, BroadPhaseStats &stats) override {
+            stats.staticRebuilt = staticChanged_;
+            staticChanged_ = false;
+            stats.pairsAdded = 0;
+            stats.pairsRemoved = 0;
+
+            out.clear();
+            size_t filtered = 0;
+            auto emit = [this, &out, &filtered](ProxyId d, ProxyId o) {
+                const auto &ed = proxies_[d];
+                const auto &eo = proxies_[o];
+                if (!overlaps(ed.box, eo.box)) return;
+                if (ed.filter.accepts(eo.filter)) out.emplace_back(ed.collider, eo.collider);
+                else ++filtered;
+            };
+
+            for (ProxyId d = 0; d < proxies_.capacity(); ++d) {
+                const auto &e = proxies_[d];
+                if (!e.alive || e.isStatic || e.sleeping) continue;
+
+                const Bin &bd = bins_[d];
+                if (bd.oversize) {
+                    // 超大动态代理：与全部代理逐一比较（两个醒着的超大代理之间由 id 较小者比较）
+                    for (ProxyId o = 0; o < proxies_.capacity(); ++o) {
+                        if (o == d || !proxies_[o].alive) continue;
+                        if (o < d && bins_[o].oversize && bins_[o].set == CellSet::Awake) continue;
+                        emit(d, o);
+                    }
+                    continue;
+                }
+                const CellRange &r = bd.range;
+                for (int32_t z = r.z0; z <= r.z1; ++z)
+                    for (int32_t y = r.y0; y <= r.y1; ++y)
+                        for (int32_t x = r.x0; x <= r.x1; ++x) {
+                            const uint32_t *bucket = cellIndex_.find(cellKey(x, y, z));
+                            if (!bucket) continue;
+                            for (ProxyId o: buckets_[*bucket]) {
+                                if (o == d) continue;
+                                const Bin &bo = bins_[o];
+                                if (bo.set == CellSet::Awake && o < d) continue;
+                                // 只在格子范围交集的最小角格子上输出，跨多格的一对不会重复
+                                const CellRange &ro = bo.range;
+                                if (x != std::max(r.x0, ro.x0) || y != std::max(r.y0, ro.y0) ||
+                                    z != std::max(r.z0, ro.z0))
+                                    continue;
+                                emit(d, o);
+                            }
+                        }
+                for (ProxyId o: oversize_[static_cast<int>(CellSet::Static)]) emit(d, o);
+                for (ProxyId o: oversize_[static_cast<int>(CellSet::Sleeping)]) emit(d, o);
+            }
+            stats.pairsFiltered = filtered;
+
+            stats.proxyCount = proxies_.count();
+            stats.staticCount = proxies_.staticCount();
+            stats.sleepingCount = proxies_.sleepingCount();
+            stats.pairCount = out.size();
+        }
+
+    private:
+        static constexpr int32_t MaxCellsPerProxy = 64;
+
+        // 入格的代理集合：静态 / 休眠的动态 / 醒着的动态
+        enum class CellSet { Static, Sleeping, Awake };
+
+        static CellSet cellSetOf(const ProxyTable::Entry &e) {
+            return e.isStatic ? CellSet::Static : e.sleeping ? CellSet::Sleeping : CellSet::Awake;
+        }
+
+        struct CellRange {
+            int32_t x0, y0, z0, x1, y1, z1;
+
+            int64_t count() const {
+                return static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+            }
+
+            bool operator==(const CellRange &o) const {
+                return x0 == o.x0 && y0 == o.y0 && z0 == o.z0 && x1 == o.x1 && y1 == o.y1 && z1 == o.z1;
+            }
+        };
+
+        // 代理当前的入格状态（按代理 id 索引）
+        struct Bin {
+            CellRange range{};
+            CellSet set = CellSet::Awake;
+            bool oversize = false;
+        };
+
+        int32_t cellCoord(float v) const {
+            return static_cast<int32_t>(std::floor(v * invCellSize_));
+        }
+
+        CellRange cellRange(const Aabb &b) const {
+            return CellRange{
+                cellCoord(b.min.x), cellCoord(b.min.y), cellCoord(b.min.z),
+                cellCoord(b.max.x), cellCoord(b.max.y), cellCoord(b.max.z)
+            };
+        }
+
+        static uint64_t cellKey(int32_t x, int32_t y, int32_t z) {
+            constexpr uint64_t mask = (1ull << 21) - 1;
+            constexpr int32_t bias = 1 << 20;
+            return ((static_cast<uint64_t>(x + bias) & mask) << 42) |
+                   ((static_cast<uint64_t>(y + bias) & mask) << 21) |
+                   (static_cast<uint64_t>(z + bias) & mask);
+        }
+
+        // 有序插入/删除（桶与超大代理列表均保持 id 升序，输出顺序与增删历史无关）
+        static void insertSorted(std::vector<ProxyId> &v, ProxyId id) {
+            v.insert(std::lower_bound(v.begin(), v.end(), id), id);
+        }
+
+        static void eraseSorted(std::vector<ProxyId> &v, ProxyId id) {
+            auto it = std::lower_bound(v.begin(), v.end(), id);
+            if (it != v.end() && *it == id) v.erase(it);
+        }
+
+        // 按代理当前的包围盒与状态入格
+        void bin(ProxyId id) {
+            const auto &e = proxies_[id];
+            Bin &b = bins_[id];
+            b.range = cellRange(e.box);
+            b.set = cellSetOf(e);
+            b.oversize = b.range.count() > MaxCellsPerProxy;
+            if (b.set == CellSet::Static) staticChanged_ = true;
+            if (b.oversize) {
+                insertSorted(oversize_[static_cast<int>(b.set)], id);
+                return;
+            }
+            const CellRange &r = b.range;
+            for (int32_t z = r.z0; z <= r.z1; ++z)
+                for (int32_t y = r.y0; y <= r.y1; ++y)
+                    for (int32_t x = r.x0; x <= r.x1; ++x) {
+                        const uint64_t key = cellKey(x, y, z);
+                        const uint32_t *found = cellIndex_.find(key);
+                        uint32_t bucket;
+                        if (found) {
+                            bucket = *found;
+                        } else if (!freeBuckets_.empty()) {
+                            bucket = freeBuckets_.back();
+                            freeBuckets_.pop_back();
+                            cellIndex_.insert(key, bucket);
+                        } else {
+                            bucket = static_cast<uint32_t>(buckets_.size());
+                            buckets_.emplace_back();
+                            cellIndex_.insert(key, bucket);
+                        }
+                        insertSorted(buckets_[bucket], id);
+                    }
+        }
+
+        // 按 bin 时记录的格子范围出格
+        void unbin(ProxyId id) {
+            const Bin &b = bins_[id];
+            if (b.set == CellSet::Static) staticChanged_ = true;
+            if (b.oversize) {
+                eraseSorted(oversize_[static_cast<int>(b.set)], id);
+                return;
+            }
+            const CellRange &r = b.range;
+            for (int32_t z = r.z0; z <= r.z1; ++z)
+                for (int32_t y = r.y0; y <= r.y1; ++y)
+                    for (int32_t x = r.x0; x <= r.x1; ++x) {
+                        const uint64_t key = cellKey(x, y, z);
+                        const uint32_t *found = cellIndex_.find(key);
+                        if (!found) continue;
+                        const uint32_t bucket = *found;
+                        eraseSorted(buckets_[bucket], id);
+                        if (buckets_[bucket].empty()) {
+                            cellIndex_.erase(key);
+                            freeBuckets_.push_back(bucket);
+                        }
+                    }
+        }
+
+        float cellSize_;
+        float invCellSize_;
+        ProxyTable proxies_;
+        std::vector<Bin> bins_;
+        PairTable cellIndex_; // 格子键 → buckets_ 下标
+        std::vector<std::vector<ProxyId>> buckets_;
+        std::vector<uint32_t> freeBuckets_;
+        std::vector<ProxyId> oversize_[3]; // 按 CellSet 分组的未入格超大代理
+        bool staticChanged_ = false;
+    };
+}
+
+std::unique_ptr<IBroadPhase> MakeSweepAndPruneBroadPhase() {
+    return std::make_unique<SapBroadPhase>();
+}
+
+std::unique_ptr<IBroadPhase> MakeSpatialHashBroadPhase(float cellSize) {
+    return std::make_unique<SpatialHashBroadPhase>(cellSize);
+}
+
+std::unique_ptr<IBroadPhase> MakeBvhBroadPhase() {
+    return std::make_unique<BvhBroadPhase>();
+}
+
+std::unique_ptr<IBroadPhase> MakeBroadPhase(BroadPhaseType type, float cellSize) {
+    switch (type) {
+        case BroadPhaseType::SpatialHash: return MakeSpatialHashBroadPhase(cellSize);
+        case BroadPhaseType::Bvh: return MakeBvhBroadPhase();
+        case BroadPhaseType::SweepAndPrune:
+        default: return MakeSweepAndPruneBroadPhase();
+    }
+}
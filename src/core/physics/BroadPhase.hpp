@@ -0,0 +1,80 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "Collider.hpp"
+
+// 广相策略类型（在 PhysicsWorld 构造时选定，便于同一场景下横向对比）
+enum class BroadPhaseType {
+    SweepAndPrune, // 动态：持久化三轴 SAP；静态：批量构建 BVH
+    SpatialHash, // 均匀网格空间哈希：格子增量维护，移动时仅在覆盖格子变化时重新入格
+    Bvh // 动态：每步重建 BVH；静态：批量构建 BVH
+};
+
+// 广相统计（每步刷新，用于性能输出）
+struct BroadPhaseStats {
+    size_t proxyCount = 0; // 广相内的代理数量（含静态）
+    size_t pairCount = 0; // 本步输出的候选对数量
+    size_t pairsFiltered = 0; // 本步 AABB 重叠、但被碰撞过滤拒绝的对（即省下的窄相调用）
+    size_t pairsAdded = 0; // 本步新增的持久重叠对（仅 SAP）
+    size_t pairsRemoved = 0; // 本步移除的持久重叠对（仅 SAP）
+    size_t proxiesUpdated = 0; // 本步更新 AABB 的代理数量
+    size_t staticCount = 0; // 静态代理数量
+    size_t sleepingCount = 0; // 休眠代理数量（不作为候选对来源）
+    bool staticRebuilt = false; // 本步是否重建了静态结构
+};
+
+// 广相策略接口
+// 约定：
+// - isStatic 为 true 的代理之间不产生候选对；静态代理极少变化，实现可对其批量构建/缓存；
+// - 输出候选对前按 CollisionFilter 过滤，双方不互相接受的对不输出（计入 pairsFiltered）；
+// - updateProxy 既用于每步移动的动态代理，也用于被外部传送的静态代理；
+// - 休眠代理不主动查询候选对，只作为醒着的代理的查询目标：休眠-静态、休眠-休眠之间不产生候选对；
+// - computePairs 输出顺序必须确定（不依赖指针值/哈希表遍历），保证同输入下结果一致。
+//   （PhysicsWorld 另按碰撞体 poolId 规范化顺序与朝向，不同策略之间结果也一致）
+class IBroadPhase {
+public:
+    using ProxyId = int32_t;
+    static constexpr ProxyId InvalidProxy = -1;
+
+    virtual ~IBroadPhase() = default;
+
+    virtual BroadPhaseType type() const = 0;
+
+    virtual const char *name() const = 0;
+
+    virtual ProxyId addProxy(ColliderBase *collider, const Aabb &box, bool isStatic, const CollisionFilter &filter) = 0;
+
+    virtual void removeProxy(ProxyId id) = 0;
+
+    virtual void updateProxy(ProxyId id, const Aabb &box) = 0;
+
+    virtual ColliderBase *collider(ProxyId id) const = 0;
+
+    // 更新代理的碰撞过滤（下一次 computePairs 生效）
+    virtual void setProxyFilter(ProxyId id, const CollisionFilter &filter) = 0;
+
+    // 标记代理休眠/唤醒（下一次 computePairs 生效）；静态代理忽略
+    virtual void setProxySleeping(ProxyId id, bool sleeping) = 0;
+
+    // 批量增删：beginBatch/endBatch 之间的 addProxy/removeProxy 可由实现延迟到 endBatch 一次性应用
+    // （代理 id 仍在调用时立即分配）；默认实现逐个即时生效
+    virtual void beginBatch() {}
+
+    virtual void endBatch() {}
+
+    // 生成本步候选对 ColliderPair（覆盖 out），并刷新统计中除 proxiesUpdated 外的字段
+    virtual void computePairs(std::vector<ColliderPair> &out, BroadPhaseStats &stats) = 0;
+};
+
+// 工厂：cellSize 仅对 SpatialHash 生效
+std::unique_ptr<IBroadPhase> MakeSweepAndPruneBroadPhase();
+
+std::unique_ptr<IBroadPhase> MakeSpatialHashBroadPhase(float cellSize);
+
+std::unique_ptr<IBroadPhase> MakeBvhBroadPhase();
+
+std::unique_ptr<IBroadPhase> MakeBroadPhase(BroadPhaseType type, float cellSize);
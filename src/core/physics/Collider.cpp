@@ -246,15 +246,14 @@ namespace {
     }
 
     // SAT 同时输出最浅穿透轴和深度（世界空间）
-    inline SatInfo ObbObbSatWithAxis(const ObbCollider &A, const ObbCollider &B) {
+    inline SatInfo ObbObbSatWithAxis(const ObbShape &A, const ObbShape &B) {
         SatInfo info{};
-        XMFLOAT3 CA = A.centerWorld();
-        XMFLOAT3 CB = B.centerWorld();
-        XMFLOAT3 EA = A.halfExtentsWorld();
-        XMFLOAT3 EB = B.halfExtentsWorld();
-        XMFLOAT3 a[3], b[3];
-        A.axesWorld(a);
-        B.axesWorld(b);
+        const XMFLOAT3 &CA = A.center;
+        const XMFLOAT3 &CB = B.center;
+        const XMFLOAT3 &EA = A.halfExtents;
+        const XMFLOAT3 &EB = B.halfExtents;
+        const XMFLOAT3 *a = A.axes;
+        const XMFLOAT3 *b = B.axes;
         float R[3][3];
         float AbsR[3][3];
         float minPen = std::numeric_limits<float>::infinity();
@@ -307,8 +306,14 @@ namespace {
                 XMFLOAT3 axis;
                 XMStoreFloat3(&axis, nrm);
                 float dist = XMVectorGetX(XMVector3Dot(tVec, nrm));
-                float ra = EA.y * AbsR[(i + 2) % 3][j] + EA.z * AbsR[(i + 1) % 3][j];
-                float rb = EB.y * AbsR[i][(j + 2) % 3] + EB.z * AbsR[i][(j + 1) % 3];
+                // 投影半径按未归一化的 a[i] x b[j] 求得，除以其长度与归一化的 dist 对齐
+                const float ea[3] = {EA.x, EA.y, EA.z};
+                const float eb[3] = {EB.x, EB.y, EB.z};
+                const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+                const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+                const float invLen = 1.0f / std::sqrt(len2);
+                float ra = (ea[i1] * AbsR[i2][j] + ea[i2] * AbsR[i1][j]) * invLen;
+                float rb = (eb[j1] * AbsR[i][j2] + eb[j2] * AbsR[i][j1]) * invLen;
                 if (!testAxis(axis, dist, ra, rb)) return info;
             }
         }
@@ -491,11 +496,29 @@ bool Intersect(const ColliderBase &A, const ColliderBase &B) {
     return false;
 }
 
+// ---- 形状快照 ----
+static SphereShape ShapeOf(const SphereCollider &S) {
+    return SphereShape{S.centerWorld(), S.radiusWorld()};
+}
+
+static ObbShape ShapeOf(const ObbCollider &B) {
+    ObbShape o{};
+    o.center = B.centerWorld();
+    B.axesWorld(o.axes);
+    o.halfExtents = B.halfExtentsWorld();
+    return o;
+}
+
+static CapsuleShape ShapeOf(const CapsuleCollider &C) {
+    auto seg = C.segmentWorld();
+    return CapsuleShape{seg.first, seg.second, C.radiusWorld()};
+}
+
 // ---- 带接触信息的相交 ----
-static void ComputeSphereSphere(const SphereCollider &A, const SphereCollider &B, OverlapResult &out) {
-    XMFLOAT3 ca = A.centerWorld();
-    XMFLOAT3 cb = B.centerWorld();
-    float ra = A.radiusWorld(), rb = B.radiusWorld();
+void ComputeContact(const SphereShape &A, const SphereShape &B, OverlapResult &out) {
+    const XMFLOAT3 &ca = A.center;
+    const XMFLOAT3 &cb = B.center;
+    float ra = A.radius, rb = B.radius;
     XMVECTOR v = XMVectorSubtract(Load3(cb), Load3(ca));
     float d = std::sqrt(std::max(0.0f, XMVectorGetX(XMVector3Dot(v, v))));
     XMFLOAT3 n{1, 0, 0};
@@ -511,24 +534,24 @@ static void ComputeSphereSphere(const SphereCollider &A, const SphereCollider &B
     out.pointOnB = XMFLOAT3{cb.x - n.x * rb, cb.y - n.y * rb, cb.z - n.z * rb};
 }
 
-static void ComputeSphereObb(const SphereCollider &S, const ObbCollider &B, OverlapResult &out) {
-    XMFLOAT3 axes[3];
-    B.axesWorld(axes);
-    XMFLOAT3 cB = B.centerWorld();
-    XMFLOAT3 he = B.halfExtentsWorld();
-    XMFLOAT3 cs = S.centerWorld();
-    float r = S.radiusWorld();
+void ComputeContact(const SphereShape &S, const ObbShape &B, OverlapResult &out) {
+    const XMFLOAT3 *axes = B.axes;
+    const XMFLOAT3 &cB = B.center;
+    const XMFLOAT3 &he = B.halfExtents;
+    const XMFLOAT3 &cs = S.center;
+    float r = S.radius;
     XMFLOAT3 q = ClosestPointOnObb(cs, cB, axes, he);
-    XMVECTOR diff = XMVectorSubtract(Load3(cs), Load3(q));
+    XMVECTOR diff = XMVectorSubtract(Load3(q), Load3(cs));
     float d2 = XMVectorGetX(XMVector3Dot(diff, diff));
     float d = std::sqrt(std::max(0.0f, d2));
     out.intersects = d <= r + GetPhysicsConfig().epsilon;
     if (!out.intersects) return;
     XMFLOAT3 n{0, 1, 0};
     if (d > GetPhysicsConfig().epsilon) {
+        // 球心 -> 盒上最近点
         XMStoreFloat3(&n, XMVectorScale(diff, 1.0f / d));
         out.penetration = std::max(0.0f, r - d);
-        out.pointOnA = XMFLOAT3{cs.x - n.x * r, cs.y - n.y * r, cs.z - n.z * r};
+        out.pointOnA = XMFLOAT3{cs.x + n.x * r, cs.y + n.y * r, cs.z + n.z * r};
         out.pointOnB = q;
         out.normal = n;
     } else {
@@ -544,32 +567,32 @@ static void ComputeSphereObb(const SphereCollider &S, const ObbCollider &B, Over
         int k = 0;
         if (dFace[1] < dFace[k]) k = 1;
         if (dFace[2] < dFace[k]) k = 2;
-        float s = (u[k] >= 0) ? 1.0f : -1.0f;
+        // 球从最近面推出（沿 -n），法线指向盒内
+        float s = (u[k] >= 0) ? -1.0f : 1.0f;
         XMFLOAT3 axis = axes[k];
         n = XMFLOAT3{axis.x * s, axis.y * s, axis.z * s};
         out.normal = n;
         out.penetration = r + dFace[k];
         out.pointOnB = XMFLOAT3{cs.x - n.x * dFace[k], cs.y - n.y * dFace[k], cs.z - n.z * dFace[k]};
-        out.pointOnA = XMFLOAT3{cs.x - n.x * r, cs.y - n.y * r, cs.z - n.z * r};
+        out.pointOnA = XMFLOAT3{cs.x + n.x * r, cs.y + n.y * r, cs.z + n.z * r};
     }
 }
 
-static void ComputeSphereCapsule(const SphereCollider &S, const CapsuleCollider &C, OverlapResult &out) {
-    auto seg = C.segmentWorld();
+void ComputeContact(const SphereShape &S, const CapsuleShape &C, OverlapResult &out) {
     // 最近点 q 在线段上
     // 重用 DistPointSegmentSq 但自己求 q
-    XMVECTOR P = Load3(S.centerWorld());
-    XMVECTOR A = Load3(seg.first);
-    XMVECTOR Bv = Load3(seg.second);
+    XMVECTOR P = Load3(S.center);
+    XMVECTOR A = Load3(C.p0);
+    XMVECTOR Bv = Load3(C.p1);
     XMVECTOR AB = XMVectorSubtract(Bv, A);
     XMVECTOR AP = XMVectorSubtract(P, A);
     float ab2 = XMVectorGetX(XMVector3Dot(AB, AB));
     float t = ab2 > 0 ? XMVectorGetX(XMVector3Dot(AP, AB)) / ab2 : 0.0f;
     t = Clamp(t, 0.0f, 1.0f);
     XMVECTOR Q = XMVectorAdd(A, XMVectorScale(AB, t));
-    XMVECTOR diff = XMVectorSubtract(P, Q);
+    XMVECTOR diff = XMVectorSubtract(Q, P); // 球心 -> 轴线上最近点
     float d = std::sqrt(std::max(0.0f, XMVectorGetX(XMVector3Dot(diff, diff))));
-    float rSum = S.radiusWorld() + C.radiusWorld();
+    float rSum = S.radius + C.radius;
     out.intersects = d <= rSum + GetPhysicsConfig().epsilon;
     if (!out.intersects) return;
     XMFLOAT3 n{1, 0, 0};
@@ -578,19 +601,17 @@ static void ComputeSphereCapsule(const SphereCollider &S, const CapsuleCollider
     out.penetration = std::max(0.0f, rSum - d);
     XMFLOAT3 q{};
     XMStoreFloat3(&q, Q);
-    XMFLOAT3 cs = S.centerWorld();
-    out.pointOnA = XMFLOAT3{cs.x - n.x * S.radiusWorld(), cs.y - n.y * S.radiusWorld(), cs.z - n.z * S.radiusWorld()};
-    out.pointOnB = XMFLOAT3{q.x + n.x * C.radiusWorld(), q.y + n.y * C.radiusWorld(), q.z + n.z * C.radiusWorld()};
+    const XMFLOAT3 &cs = S.center;
+    out.pointOnA = XMFLOAT3{cs.x + n.x * S.radius, cs.y + n.y * S.radius, cs.z + n.z * S.radius};
+    out.pointOnB = XMFLOAT3{q.x - n.x * C.radius, q.y - n.y * C.radius, q.z - n.z * C.radius};
 }
 
-static void ComputeCapsuleCapsule(const CapsuleCollider &A, const CapsuleCollider &B, OverlapResult &out) {
-    auto sa = A.segmentWorld();
-    auto sb = B.segmentWorld();
+void ComputeContact(const CapsuleShape &A, const CapsuleShape &B, OverlapResult &out) {
     XMFLOAT3 pa, pb;
     float s = 0, t = 0; // 最近点
-    float d2 = DistSegmentSegmentSq(sa.first, sa.second, sb.first, sb.second, &s, &t, &pa, &pb);
+    float d2 = DistSegmentSegmentSq(A.p0, A.p1, B.p0, B.p1, &s, &t, &pa, &pb);
     float d = std::sqrt(std::max(0.0f, d2));
-    float rSum = A.radiusWorld() + B.radiusWorld();
+    float rSum = A.radius + B.radius;
     out.intersects = d <= rSum + GetPhysicsConfig().epsilon;
     if (!out.intersects) return;
     XMFLOAT3 n{1, 0, 0};
@@ -598,56 +619,32 @@ static void ComputeCapsuleCapsule(const CapsuleCollider &A, const CapsuleCollide
     if (d > GetPhysicsConfig().epsilon) XMStoreFloat3(&n, XMVectorScale(diff, 1.0f / d));
     out.normal = n;
     out.penetration = std::max(0.0f, rSum - d);
-    out.pointOnA = XMFLOAT3{pa.x - n.x * A.radiusWorld(), pa.y - n.y * A.radiusWorld(), pa.z - n.z * A.radiusWorld()};
-    out.pointOnB = XMFLOAT3{pb.x + n.x * B.radiusWorld(), pb.y + n.y * B.radiusWorld(), pb.z + n.z * B.radiusWorld()};
+    out.pointOnA = XMFLOAT3{pa.x + n.x * A.radius, pa.y + n.y * A.radius, pa.z + n.z * A.radius};
+    out.pointOnB = XMFLOAT3{pb.x - n.x * B.radius, pb.y - n.y * B.radius, pb.z - n.z * B.radius};
 }
 
-static void ComputeObbObb(const ObbCollider &A, const ObbCollider &B, OverlapResult &out) {
+void ComputeContact(const ObbShape &A, const ObbShape &B, OverlapResult &out) {
     SatInfo si = ObbObbSatWithAxis(A, B);
     out.intersects = si.intersects;
     if (!si.intersects) return;
     // 法线方向应从 A 指向 B
-    XMVECTOR dC = XMVectorSubtract(Load3(B.centerWorld()), Load3(A.centerWorld()));
+    XMVECTOR dC = XMVectorSubtract(Load3(B.center), Load3(A.center));
     XMVECTOR nV = Load3(si.axis);
     float sign = XMVectorGetX(XMVector3Dot(dC, nV)) >= 0 ? 1.0f : -1.0f;
     XMFLOAT3 n = XMFLOAT3{si.axis.x * sign, si.axis.y * sign, si.axis.z * sign};
     out.normal = n;
     out.penetration = si.penetration;
-    // 近似接触点：用支持点
-    XMFLOAT3 axesA[3];
-    A.axesWorld(axesA);
-    XMFLOAT3 axesB[3];
-    B.axesWorld(axesB);
-    XMFLOAT3 pA = A.centerWorld();
-    XMFLOAT3 heA = A.halfExtentsWorld();
-    XMFLOAT3 pB = B.centerWorld();
-    XMFLOAT3 heB = B.halfExtentsWorld();
-    // support along -n for A, +n for B
-    // 手动实现支持点（见下方 SupportPointOnObb 实现）
-    // 复用函数
-    auto support = [](const XMFLOAT3 &c, const XMFLOAT3 axes[3], const XMFLOAT3 &he, const XMFLOAT3 &dir) {
-        XMVECTOR D = Load3(dir);
-        float s0 = XMVectorGetX(XMVector3Dot(D, Load3(axes[0]))) >= 0 ? 1.f : -1.f;
-        float s1 = XMVectorGetX(XMVector3Dot(D, Load3(axes[1]))) >= 0 ? 1.f : -1.f;
-        float s2 = XMVectorGetX(XMVector3Dot(D, Load3(axes[2]))) >= 0 ? 1.f : -1.f;
-        XMFLOAT3 o = c;
-        o.x += axes[0].x * he.x * s0 + axes[1].x * he.y * s1 + axes[2].x * he.z * s2;
-        o.y += axes[0].y * he.x * s0 + axes[1].y * he.y * s1 + axes[2].y * he.z * s2;
-        o.z += axes[0].z * he.x * s0 + axes[1].z * he.y * s1 + axes[2].z * he.z * s2;
-        return o;
-    };
+    // 近似接触点：各自伸入对方最深的支持点（A 沿 +n，B 沿 -n）
     XMFLOAT3 nNeg{-n.x, -n.y, -n.z};
-    out.pointOnA = support(pA, axesA, heA, nNeg);
-    out.pointOnB = support(pB, axesB, heB, n);
+    out.pointOnA = SupportPointOnObb(A.center, A.axes, A.halfExtents, n);
+    out.pointOnB = SupportPointOnObb(B.center, B.axes, B.halfExtents, nNeg);
 }
 
-static void ComputeObbCapsule(const ObbCollider &B, const CapsuleCollider &C, OverlapResult &out) {
+void ComputeContact(const ObbShape &B, const CapsuleShape &C, OverlapResult &out) {
     // 在 OBB 局部做最近点
-    XMFLOAT3 axes[3];
-    B.axesWorld(axes);
-    XMFLOAT3 cB = B.centerWorld();
-    XMFLOAT3 he = B.halfExtentsWorld();
-    auto seg = C.segmentWorld();
+    const XMFLOAT3 *axes = B.axes;
+    const XMFLOAT3 &cB = B.center;
+    const XMFLOAT3 &he = B.halfExtents;
     auto toLocal = [&](const XMFLOAT3 &p)-> XMFLOAT3 {
         XMVECTOR v = XMVectorSubtract(Load3(p), Load3(cB));
         return XMFLOAT3{
@@ -664,17 +661,17 @@ static void ComputeObbCapsule(const ObbCollider &B, const CapsuleCollider &C, Ov
             cB.z + axes[0].z * pL.x + axes[1].z * pL.y + axes[2].z * pL.z
         };
     };
-    XMFLOAT3 p0L = toLocal(seg.first);
-    XMFLOAT3 p1L = toLocal(seg.second);
+    XMFLOAT3 p0L = toLocal(C.p0);
+    XMFLOAT3 p1L = toLocal(C.p1);
     XMFLOAT3 pL, qL;
     float d2 = ClosestPtSegmentAabbLocal(p0L, p1L, he, pL, qL);
     float d = std::sqrt(std::max(0.0f, d2));
-    float r = C.radiusWorld();
+    float r = C.radius;
     out.intersects = d <= r + GetPhysicsConfig().epsilon;
     if (!out.intersects) return;
     XMFLOAT3 pw = toWorld(pL);
     XMFLOAT3 qw = toWorld(qL);
-    XMVECTOR diff = XMVectorSubtract(Load3(qw), Load3(pw));
+    XMVECTOR diff = XMVectorSubtract(Load3(pw), Load3(qw)); // 盒上最近点 -> 轴线上最近点
     XMFLOAT3 n{1, 0, 0};
     if (d > GetPhysicsConfig().epsilon) XMStoreFloat3(&n, XMVectorScale(diff, 1.0f / d));
     else {
@@ -690,8 +687,14 @@ static void ComputeObbCapsule(const ObbCollider &B, const CapsuleCollider &C, Ov
     }
     out.normal = n;
     out.penetration = std::max(0.0f, r - d);
-    out.pointOnA = XMFLOAT3{pw.x + n.x * r, pw.y + n.y * r, pw.z + n.z * r};
-    out.pointOnB = qw;
+    out.pointOnA = qw;
+    out.pointOnB = XMFLOAT3{pw.x - n.x * r, pw.y - n.y * r, pw.z - n.z * r};
+}
+
+void FlipContact(OverlapResult &out) {
+    if (!out.intersects) return;
+    out.normal = XMFLOAT3{-out.normal.x, -out.normal.y, -out.normal.z};
+    std::swap(out.pointOnA, out.pointOnB);
 }
 
 bool Intersect(const ColliderBase &A, const ColliderBase &B, OverlapResult &out) {
@@ -702,58 +705,52 @@ bool Intersect(const ColliderBase &A, const ColliderBase &B, OverlapResult &out)
         case ColliderType::Sphere:
             switch (tb) {
                 case ColliderType::Sphere:
-                    ComputeSphereSphere(static_cast<const SphereCollider &>(A), static_cast<const SphereCollider &>(B),
-                                        out);
+                    ComputeContact(ShapeOf(static_cast<const SphereCollider &>(A)),
+                                   ShapeOf(static_cast<const SphereCollider &>(B)), out);
                     return out.intersects;
                 case ColliderType::Obb:
-                    ComputeSphereObb(static_cast<const SphereCollider &>(A), static_cast<const ObbCollider &>(B), out);
+                    ComputeContact(ShapeOf(static_cast<const SphereCollider &>(A)),
+                                   ShapeOf(static_cast<const ObbCollider &>(B)), out);
                     return out.intersects;
                 case ColliderType::Capsule:
-                    ComputeSphereCapsule(static_cast<const SphereCollider &>(A),
-                                         static_cast<const CapsuleCollider &>(B), out);
+                    ComputeContact(ShapeOf(static_cast<const SphereCollider &>(A)),
+                                   ShapeOf(static_cast<const CapsuleCollider &>(B)), out);
                     return out.intersects;
             }
             break;
         case ColliderType::Obb:
             switch (tb) {
                 case ColliderType::Sphere:
-                    ComputeSphereObb(static_cast<const SphereCollider &>(B), static_cast<const ObbCollider &>(A), out);
-                    if (out.intersects) {
-                        // 方向需要从 A->B，当前计算的是 Sphere vs Obb，把法线取反
-                        out.normal = XMFLOAT3{-out.normal.x, -out.normal.y, -out.normal.z};
-                        std::swap(out.pointOnA, out.pointOnB);
-                    }
+                    // 方向需要从 A->B，当前计算的是 Sphere vs Obb，把法线取反
+                    ComputeContact(ShapeOf(static_cast<const SphereCollider &>(B)),
+                                   ShapeOf(static_cast<const ObbCollider &>(A)), out);
+                    FlipContact(out);
                     return out.intersects;
                 case ColliderType::Obb:
-                    ComputeObbObb(static_cast<const ObbCollider &>(A), static_cast<const ObbCollider &>(B), out);
+                    ComputeContact(ShapeOf(static_cast<const ObbCollider &>(A)),
+                                   ShapeOf(static_cast<const ObbCollider &>(B)), out);
                     return out.intersects;
                 case ColliderType::Capsule:
-                    ComputeObbCapsule(static_cast<const ObbCollider &>(A), static_cast<const CapsuleCollider &>(B),
-                                      out);
+                    ComputeContact(ShapeOf(static_cast<const ObbCollider &>(A)),
+                                   ShapeOf(static_cast<const CapsuleCollider &>(B)), out);
                     return out.intersects;
             }
             break;
         case ColliderType::Capsule:
             switch (tb) {
                 case ColliderType::Sphere:
-                    ComputeSphereCapsule(static_cast<const SphereCollider &>(B),
-                                         static_cast<const CapsuleCollider &>(A), out);
-                    if (out.intersects) {
-                        out.normal = XMFLOAT3{-out.normal.x, -out.normal.y, -out.normal.z};
-                        std::swap(out.pointOnA, out.pointOnB);
-                    }
+                    ComputeContact(ShapeOf(static_cast<const SphereCollider &>(B)),
+                                   ShapeOf(static_cast<const CapsuleCollider &>(A)), out);
+                    FlipContact(out);
                     return out.intersects;
                 case ColliderType::Obb:
-                    ComputeObbCapsule(static_cast<const ObbCollider &>(B), static_cast<const CapsuleCollider &>(A),
-                                      out);
-                    if (out.intersects) {
-                        out.normal = XMFLOAT3{-out.normal.x, -out.normal.y, -out.normal.z};
-                        std::swap(out.pointOnA, out.pointOnB);
-                    }
+                    ComputeContact(ShapeOf(static_cast<const ObbCollider &>(B)),
+                                   ShapeOf(static_cast<const CapsuleCollider &>(A)), out);
+                    FlipContact(out);
                     return out.intersects;
                 case ColliderType::Capsule:
-                    ComputeCapsuleCapsule(static_cast<const CapsuleCollider &>(A),
-                                          static_cast<const CapsuleCollider &>(B), out);
+                    ComputeContact(ShapeOf(static_cast<const CapsuleCollider &>(A)),
+                                   ShapeOf(static_cast<const CapsuleCollider &>(B)), out);
                     return out.intersects;
             }
             break;
@@ -9,8 +9,9 @@
 //   1) 局部偏移（position local offset）与局部旋转偏移（rotation local offset）
 //   2) 自身缩放（scale）
 //   3) Owner 的世界位姿（由上层注入，仅记录，不做权属）
-// - 上层（Scene/PhysicsWorld）在每帧同步时调用 setOwnerWorld... 接口注入 Owner 世界位姿；
-//   业务侧设置/读取 setPosition()/rotationEuler() 则表示局部偏移/局部旋转偏移，而非世界变换。
+// - 上层（Scene/PhysicsWorld）在每帧同步时调用 setOwnerWorldPose 注入 Owner 世界位姿（位置 + 四元数）；
+//   业务侧设置/读取 setPosition()/rotation() 则表示局部偏移/局部旋转偏移，而非世界变换。
+// - 旋转一律以四元数存储与传递；欧拉角接口只是换算包装（pitch, yaw, roll，弧度）。
 // - 首期算法仍然根据上述组合求得 centerWorld()/axesWorld()/segmentWorld() 等派生量。
 
 #include <cstdint>
@@ -19,8 +20,11 @@
 #include <memory>
 #include <DirectXMath.h>
 
+#include "Transform.hpp"
+
 // 前置声明，避免图形模块的包含循环
 struct Model;
+class ColliderPool;
 
 // 基础类型与配置
 enum class ColliderType { Sphere, Obb, Capsule };
@@ -38,6 +42,14 @@ struct OverlapResult {
     DirectX::XMFLOAT3 pointOnB{0, 0, 0};
 };
 
+// 碰撞过滤：layer 为所属层位，mask 为可与之产生候选对的层位；双方互相接受才成对
+struct CollisionFilter {
+    uint32_t layer = 1;
+    uint32_t mask = 0xffffffffu;
+
+    bool accepts(const CollisionFilter &o) const { return (layer & o.mask) != 0 && (o.layer & mask) != 0; }
+};
+
 // 全局数值精度配置（固定但可调）
 struct PhysicsConfig {
     float epsilon = 1e-5f;
@@ -56,20 +68,28 @@ public:
     // 类型查询
     virtual ColliderType kind() const = 0;
 
-    // 变换：局部偏移位置/局部偏移旋转（欧拉）/缩放。违反约束时返回 false 并且不改变内部状态。
-    // 注意：setPosition/setRotationEuler 语义已改为【局部偏移】而非世界！
+    // 变换：局部偏移位置/局部偏移旋转（四元数 x, y, z, w）/缩放。违反约束时返回 false 并且不改变内部状态。
+    // 注意：setPosition/setRotation 语义已改为【局部偏移】而非世界！
     virtual bool setPosition(const DirectX::XMFLOAT3 &posLocalOffset) = 0;
 
-    virtual bool setRotationEuler(const DirectX::XMFLOAT3 &rotEulerLocalOffset) = 0; // pitch, yaw, roll（弧度）
+    virtual bool setRotation(const DirectX::XMFLOAT4 &rotLocalOffset) = 0;
+
     virtual bool setScale(const DirectX::XMFLOAT3 &scale) = 0;
 
     // 读取当前局部偏移 TRS（非世界）
     virtual DirectX::XMFLOAT3 position() const = 0;
 
-    virtual DirectX::XMFLOAT3 rotationEuler() const = 0;
+    virtual DirectX::XMFLOAT4 rotation() const = 0;
 
     virtual DirectX::XMFLOAT3 scale() const = 0;
 
+    // 欧拉角包装（pitch, yaw, roll，弧度）
+    bool setRotationEuler(const DirectX::XMFLOAT3 &rotEulerLocalOffset) {
+        return setRotation(QuaternionFromEuler(rotEulerLocalOffset));
+    }
+
+    DirectX::XMFLOAT3 rotationEuler() const { return EulerFromQuaternion(rotation()); }
+
     // 世界矩阵（S*R*T），供渲染/调试；实现方可选择延迟更新或即时构造
     virtual DirectX::XMMATRIX world() const = 0;
 
@@ -106,15 +126,39 @@ public:
 
     virtual bool isStatic() const = 0;
 
+    // 层位与碰撞掩码：广相只输出双方互相接受的对（见 CollisionFilter，另受 WorldParams::layerMatrix 约束），
+    // 查询按 QueryFilter::layerMask 与 layer 判断是否命中。默认第 0 层、与所有层碰撞；
+    // 注册后修改需调用 PhysicsWorld::refreshCollisionFilter
+    virtual void setLayer(uint32_t layerBits) = 0;
+
+    virtual uint32_t layer() const = 0;
+
+    virtual void setCollisionMask(uint32_t maskBits) = 0;
+
+    virtual uint32_t collisionMask() const = 0;
+
     // —— 新增：Owner 世界位姿注入/读取 ——
     // 上层每帧应调用以下接口将 Owner 世界位姿写入 Collider（仅存储，不做所有权）。
+    // 朝向为四元数；与当前值逐分量相同时不重建旋转相关量。
     virtual void setOwnerWorldPosition(const DirectX::XMFLOAT3 &ownerPosW) = 0;
 
-    virtual void setOwnerWorldRotationEuler(const DirectX::XMFLOAT3 &ownerRotEulerW) = 0;
+    virtual void setOwnerWorldRotation(const DirectX::XMFLOAT4 &ownerRotW) = 0;
+
+    void setOwnerWorldPose(const DirectX::XMFLOAT3 &ownerPosW, const DirectX::XMFLOAT4 &ownerRotW) {
+        setOwnerWorldPosition(ownerPosW);
+        setOwnerWorldRotation(ownerRotW);
+    }
 
     virtual DirectX::XMFLOAT3 ownerWorldPosition() const = 0;
 
-    virtual DirectX::XMFLOAT3 ownerWorldRotationEuler() const = 0;
+    virtual DirectX::XMFLOAT4 ownerWorldRotation() const = 0;
+
+    // 欧拉角包装
+    void setOwnerWorldRotationEuler(const DirectX::XMFLOAT3 &ownerRotEulerW) {
+        setOwnerWorldRotation(QuaternionFromEuler(ownerRotEulerW));
+    }
+
+    DirectX::XMFLOAT3 ownerWorldRotationEuler() const { return EulerFromQuaternion(ownerWorldRotation()); }
 
     // 射线相交检测（用于鼠标拾取）
     // 返回是否相交，如果相交则 outDistance 为相交点到射线起点的距离
@@ -125,7 +169,16 @@ public:
     // —— 新增：获取世界位置和旋转（Owner世界变换 + 自身局部偏移） ——
     // 这些方法计算并返回碰撞体的最终世界位姿
     virtual DirectX::XMFLOAT3 getWorldPosition() const = 0;
-    virtual DirectX::XMFLOAT3 getWorldRotationEuler() const = 0;
+    virtual DirectX::XMFLOAT4 getWorldRotation() const = 0; // 局部旋转后接 Owner 旋转
+
+    DirectX::XMFLOAT3 getWorldRotationEuler() const { return EulerFromQuaternion(getWorldRotation()); }
+
+    // —— SoA 池绑定（由 PhysicsWorld 在注册/反注册时调用）——
+    // 绑定后本对象只是池中数据的句柄：Owner 世界位置与世界派生量（中心/轴/半尺寸/AABB）存放在池内并由池批量计算；
+    // 朝向、局部偏移、缩放变化时由实现重新推送旋转相关量。pool 为 nullptr 表示解绑（派生量回到即时计算）。
+    virtual void bindPool(ColliderPool *pool, uint32_t id) = 0;
+
+    virtual uint32_t poolId() const = 0; // 未绑定时为 0xffffffff
 };
 
 // Sphere：局部参数为 centerLocal（可选）+ radiusLocal；世界半径=radiusLocal*uniformScale
@@ -155,6 +208,41 @@ public:
     virtual float radiusWorld() const = 0;
 };
 
+// 世界空间形状快照：批量窄相直接以此为输入，不经过虚函数
+struct SphereShape {
+    DirectX::XMFLOAT3 center{0, 0, 0};
+    float radius = 0;
+};
+
+struct ObbShape {
+    DirectX::XMFLOAT3 center{0, 0, 0};
+    DirectX::XMFLOAT3 axes[3]{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    DirectX::XMFLOAT3 halfExtents{0, 0, 0};
+};
+
+struct CapsuleShape {
+    DirectX::XMFLOAT3 p0{0, 0, 0};
+    DirectX::XMFLOAT3 p1{0, 0, 0};
+    float radius = 0;
+};
+
+// 带接触信息的形状对检测，与 Intersect(A, B, out) 结果一致。约定（全部重载相同）：
+// normal 由 A 指向 B（B 沿 +n、A 沿 -n 可分离），pointOnA/pointOnB 分别在 A/B 上
+void ComputeContact(const SphereShape &a, const SphereShape &b, OverlapResult &out);
+
+void ComputeContact(const SphereShape &s, const ObbShape &b, OverlapResult &out);
+
+void ComputeContact(const SphereShape &s, const CapsuleShape &c, OverlapResult &out);
+
+void ComputeContact(const ObbShape &a, const ObbShape &b, OverlapResult &out);
+
+void ComputeContact(const ObbShape &b, const CapsuleShape &c, OverlapResult &out);
+
+void ComputeContact(const CapsuleShape &a, const CapsuleShape &b, OverlapResult &out);
+
+// 交换 A/B：法线取反、两触点互换（intersects 为 false 时不动）
+void FlipContact(OverlapResult &out);
+
 // 统一检测入口（仅声明，实现在 .cpp）
 bool Intersect(const ColliderBase &A, const ColliderBase &B); // 首期布尔相交
 bool Intersect(const ColliderBase &A, const ColliderBase &B, OverlapResult &out);
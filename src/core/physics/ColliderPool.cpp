@@ -0,0 +1,387 @@
+﻿#include "ColliderPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+using namespace DirectX;
+
+namespace {
+    // 数组均补齐到 4 的倍数，可整段按 4 路读写
+    inline XMVECTOR Load4(const float *p) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(p)); }
+    inline void Store4(float *p, FXMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(p), v); }
+
+    inline size_t RoundUp4(size_t n) { return (n + 3) & ~static_cast<size_t>(3); }
+
+    // 类型对 → 批次下标（调用方保证 a <= b）
+    inline int BatchIndex(ColliderType a, ColliderType b) {
+        static const int table[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+        return table[static_cast<int>(a)][static_cast<int>(b)];
+    }
+}
+
+// ---------------- Soa ----------------
+void ColliderPool::Soa::resizeLanes(size_t lanes) {
+    colliders.resize(lanes, nullptr);
+    ids.resize(lanes, InvalidId);
+    for (auto *v: {
+             &ownerX, &ownerY, &ownerZ, &offX, &offY, &offZ, &extX, &extY, &extZ, &cX, &cY, &cZ,
+             &minX, &minY, &minZ, &maxX, &maxY, &maxZ, &radius, &heX, &heY, &heZ, &segX, &segY, &segZ
+         }) {
+        v->resize(lanes, 0.0f);
+    }
+    for (auto &v: axes) v.resize(lanes, 0.0f);
+}
+
+uint32_t ColliderPool::Soa::push(ColliderBase *collider, Id id) {
+    if (count + 1 > colliders.size()) resizeLanes(RoundUp4(count + 1));
+    const uint32_t slot = count++;
+    colliders[slot] = collider;
+    ids[slot] = id;
+    return slot;
+}
+
+ColliderPool::Id ColliderPool::Soa::erase(uint32_t slot) {
+    const uint32_t last = count - 1;
+    Id moved = InvalidId;
+    auto move = [&](std::vector<float> &v) {
+        v[slot] = v[last];
+        v[last] = 0.0f;
+    };
+    if (slot != last) {
+        colliders[slot] = colliders[last];
+        ids[slot] = ids[last];
+        moved = ids[slot];
+    }
+    for (auto *v: {
+             &ownerX, &ownerY, &ownerZ, &offX, &offY, &offZ, &extX, &extY, &extZ, &cX, &cY, &cZ,
+             &minX, &minY, &minZ, &maxX, &maxY, &maxZ, &radius, &heX, &heY, &heZ, &segX, &segY, &segZ
+         }) {
+        move(*v);
+    }
+    for (auto &v: axes) move(v);
+    colliders[last] = nullptr;
+    ids[last] = InvalidId;
+    --count;
+    return moved;
+}
+
+void ColliderPool::Soa::refreshSlot(uint32_t i) {
+    cX[i] = ownerX[i] + offX[i];
+    cY[i] = ownerY[i] + offY[i];
+    cZ[i] = ownerZ[i] + offZ[i];
+    minX[i] = cX[i] - extX[i];
+    minY[i] = cY[i] - extY[i];
+    minZ[i] = cZ[i] - extZ[i];
+    maxX[i] = cX[i] + extX[i];
+    maxY[i] = cY[i] + extY[i];
+    maxZ[i] = cZ[i] + extZ[i];
+}
+
+void ColliderPool::Soa::refreshAll() {
+    // 4 路：center = owner + offset；aabb = center ± extent
+    for (size_t i = 0; i < count; i += 4) {
+        XMVECTOR cx = XMVectorAdd(Load4(&ownerX[i]), Load4(&offX[i]));
+        XMVECTOR cy = XMVectorAdd(Load4(&ownerY[i]), Load4(&offY[i]));
+        XMVECTOR cz = XMVectorAdd(Load4(&ownerZ[i]), Load4(&offZ[i]));
+        XMVECTOR ex = Load4(&extX[i]);
+        XMVECTOR ey = Load4(&extY[i]);
+        XMVECTOR ez = Load4(&extZ[i]);
+        Store4(&cX[i], cx);
+        Store4(&cY[i], cy);
+        Store4(&cZ[i], cz);
+        Store4(&minX[i], XMVectorSubtract(cx, ex));
+        Store4(&minY[i], XMVectorSubtract(cy, ey));
+        Store4(&minZ[i], XMVectorSubtract(cz, ez));
+        Store4(&maxX[i], XMVectorAdd(cx, ex));
+        Store4(&maxY[i], XMVectorAdd(cy, ey));
+        Store4(&maxZ[i], XMVectorAdd(cz, ez));
+    }
+    dirty = false;
+}
+
+// ---------------- 池 ----------------
+ColliderPool::Soa &ColliderPool::soa(ColliderType t) {
+    switch (t) {
+        case ColliderType::Sphere: return spheres_;
+        case ColliderType::Obb: return obbs_;
+        case ColliderType::Capsule: return capsules_;
+    }
+    return spheres_;
+}
+
+const ColliderPool::Soa &ColliderPool::soa(ColliderType t) const {
+    return const_cast<ColliderPool *>(this)->soa(t);
+}
+
+ColliderPool::Id ColliderPool::add(ColliderBase *collider) {
+    if (!collider) return InvalidId;
+    Id id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    } else {
+        id = static_cast<Id>(slots_.size());
+        slots_.emplace_back();
+    }
+    Slot &s = slots_[id];
+    s.type = collider->kind();
+    s.index = soa(s.type).push(collider, id);
+    s.alive = true;
+    collider->bindPool(this, id);
+    return id;
+}
+
+void ColliderPool::remove(Id id) {
+    if (!valid(id)) return;
+    Slot &s = slots_[id];
+    Soa &arr = soa(s.type);
+    if (ColliderBase *c = arr.colliders[s.index]) c->bindPool(nullptr, InvalidId);
+    const Id moved = arr.erase(s.index);
+    if (moved != InvalidId) slots_[moved].index = s.index;
+    s = Slot{};
+    freeIds_.push_back(id);
+}
+
+void ColliderPool::setOwnerPosition(Id id, const XMFLOAT3 &posW) {
+    if (!valid(id)) return;
+    const Slot &s = slots_[id];
+    Soa &arr = soa(s.type);
+    arr.ownerX[s.index] = posW.x;
+    arr.ownerY[s.index] = posW.y;
+    arr.ownerZ[s.index] = posW.z;
+    arr.refreshSlot(s.index);
+}
+
+void ColliderPool::writeOwnerPosition(Id id, const XMFLOAT3 &posW) {
+    if (!valid(id)) return;
+    const Slot &s = slots_[id];
+    Soa &arr = soa(s.type);
+    arr.ownerX[s.index] = posW.x;
+    arr.ownerY[s.index] = posW.y;
+    arr.ownerZ[s.index] = posW.z;
+    arr.dirty = true;
+}
+
+void ColliderPool::setShape(Id id, const ShapeCache &shape) {
+    if (!valid(id)) return;
+    const Slot &s = slots_[id];
+    Soa &arr = soa(s.type);
+    const uint32_t i = s.index;
+    arr.offX[i] = shape.offset.x;
+    arr.offY[i] = shape.offset.y;
+    arr.offZ[i] = shape.offset.z;
+    arr.extX[i] = shape.extent.x;
+    arr.extY[i] = shape.extent.y;
+    arr.extZ[i] = shape.extent.z;
+    for (int k = 0; k < 3; ++k) {
+        arr.axes[k * 3 + 0][i] = shape.axes[k].x;
+        arr.axes[k * 3 + 1][i] = shape.axes[k].y;
+        arr.axes[k * 3 + 2][i] = shape.axes[k].z;
+    }
+    arr.heX[i] = shape.halfExtents.x;
+    arr.heY[i] = shape.halfExtents.y;
+    arr.heZ[i] = shape.halfExtents.z;
+    arr.segX[i] = shape.halfSegment.x;
+    arr.segY[i] = shape.halfSegment.y;
+    arr.segZ[i] = shape.halfSegment.z;
+    arr.radius[i] = shape.radius;
+    arr.refreshSlot(i);
+}
+
+void ColliderPool::updateDerived() {
+    if (spheres_.dirty) spheres_.refreshAll();
+    if (obbs_.dirty) obbs_.refreshAll();
+    if (capsules_.dirty) capsules_.refreshAll();
+}
+
+XMFLOAT3 ColliderPool::ownerPosition(Id id) const {
+    if (!valid(id)) return XMFLOAT3{0, 0, 0};
+    const Slot &s = slots_[id];
+    const Soa &arr = soa(s.type);
+    return XMFLOAT3{arr.ownerX[s.index], arr.ownerY[s.index], arr.ownerZ[s.index]};
+}
+
+XMFLOAT3 ColliderPool::center(Id id) const {
+    if (!valid(id)) return XMFLOAT3{0, 0, 0};
+    const Slot &s = slots_[id];
+    const Soa &arr = soa(s.type);
+    return XMFLOAT3{arr.cX[s.index], arr.cY[s.index], arr.cZ[s.index]};
+}
+
+Aabb ColliderPool::aabb(Id id) const {
+    if (!valid(id)) return Aabb{};
+    const Slot &s = slots_[id];
+    const Soa &arr = soa(s.type);
+    const uint32_t i = s.index;
+    return Aabb{XMFLOAT3{arr.minX[i], arr.minY[i], arr.minZ[i]}, XMFLOAT3{arr.maxX[i], arr.maxY[i], arr.maxZ[i]}};
+}
+
+ColliderPool::ShapeCache ColliderPool::shape(Id id) const {
+    ShapeCache out{};
+    if (!valid(id)) return out;
+    const Slot &s = slots_[id];
+    const Soa &arr = soa(s.type);
+    const uint32_t i = s.index;
+    out.offset = XMFLOAT3{arr.offX[i], arr.offY[i], arr.offZ[i]};
+    out.extent = XMFLOAT3{arr.extX[i], arr.extY[i], arr.extZ[i]};
+    for (int k = 0; k < 3; ++k) {
+        out.axes[k] = XMFLOAT3{arr.axes[k * 3 + 0][i], arr.axes[k * 3 + 1][i], arr.axes[k * 3 + 2][i]};
+    }
+    out.halfExtents = XMFLOAT3{arr.heX[i], arr.heY[i], arr.heZ[i]};
+    out.halfSegment = XMFLOAT3{arr.segX[i], arr.segY[i], arr.segZ[i]};
+    out.radius = arr.radius[i];
+    return out;
+}
+
+SphereShape ColliderPool::sphereAt(uint32_t i) const {
+    const Soa &a = spheres_;
+    return SphereShape{XMFLOAT3{a.cX[i], a.cY[i], a.cZ[i]}, a.radius[i]};
+}
+
+ObbShape ColliderPool::obbAt(uint32_t i) const {
+    const Soa &a = obbs_;
+    ObbShape o{};
+    o.center = XMFLOAT3{a.cX[i], a.cY[i], a.cZ[i]};
+    for (int k = 0; k < 3; ++k) {
+        o.axes[k] = XMFLOAT3{a.axes[k * 3 + 0][i], a.axes[k * 3 + 1][i], a.axes[k * 3 + 2][i]};
+    }
+    o.halfExtents = XMFLOAT3{a.heX[i], a.heY[i], a.heZ[i]};
+    return o;
+}
+
+CapsuleShape ColliderPool::capsuleAt(uint32_t i) const {
+    const Soa &a = capsules_;
+    return CapsuleShape{
+        XMFLOAT3{a.cX[i] - a.segX[i], a.cY[i] - a.segY[i], a.cZ[i] - a.segZ[i]},
+        XMFLOAT3{a.cX[i] + a.segX[i], a.cY[i] + a.segY[i], a.cZ[i] + a.segZ[i]},
+        a.radius[i]
+    };
+}
+
+// ---------------- 窄相 ----------------
+template<typename GetA, typename GetB>
+void ColliderPool::collideScalar(const std::vector<BatchItem> &batch, GetA getA, GetB getB,
+                                 std::vector<OverlapResult> &out) const {
+    for (const auto &it: batch) {
+        OverlapResult &r = out[it.pair];
+        ComputeContact(getA(it.a), getB(it.b), r);
+        if (it.flipped) FlipContact(r);
+    }
+}
+
+void ColliderPool::collide(const std::vector<ColliderPair> &pairs, std::vector<OverlapResult> &out) {
+    out.assign(pairs.size(), OverlapResult{});
+    collideRange(pairs, 0, pairs.size(), out, batches_);
+}
+
+void ColliderPool::collideRange(const std::vector<ColliderPair> &pairs, size_t begin, size_t end,
+                                std::vector<OverlapResult> &out, Batches &scratch) const {
+    auto &batches = scratch.items;
+    for (auto &b: batches) b.clear();
+
+    for (size_t i = begin; i < end; ++i) {
+        ColliderBase *ca = pairs[i].first;
+        ColliderBase *cb = pairs[i].second;
+        if (!ca || !cb) continue;
+        const Id ia = ca->poolId();
+        const Id ib = cb->poolId();
+        if (!valid(ia) || !valid(ib)) {
+            // 未入池（不应出现）：退回虚函数路径
+            Intersect(*ca, *cb, out[i]);
+            continue;
+        }
+        Slot sa = slots_[ia];
+        Slot sb = slots_[ib];
+        const bool flipped = static_cast<int>(sa.type) > static_cast<int>(sb.type);
+        if (flipped) std::swap(sa, sb);
+        batches[BatchIndex(sa.type, sb.type)].push_back(
+            BatchItem{sa.index, sb.index, static_cast<uint32_t>(i), flipped});
+    }
+
+    collideSphereSphere(batches[0], out);
+    collideSphereObb(batches[1], out);
+    auto sphere = [this](uint32_t i) { return sphereAt(i); };
+    auto obb = [this](uint32_t i) { return obbAt(i); };
+    auto capsule = [this](uint32_t i) { return capsuleAt(i); };
+    collideScalar(batches[2], sphere, capsule, out);
+    collideScalar(batches[3], obb, obb, out);
+    collideScalar(batches[4], obb, capsule, out);
+    collideScalar(batches[5], capsule, capsule, out);
+}
+
+void ColliderPool::collideSphereSphere(const std::vector<BatchItem> &batch, std::vector<OverlapResult> &out) const {
+    const Soa &s = spheres_;
+    // 粗筛阈值比精确判定（d <= rA + rB + eps）略宽，SIMD 只负责剔除，命中项交给标量求接触
+    const XMVECTOR slack = XMVectorReplicate(2.0f * GetPhysicsConfig().epsilon);
+    for (size_t base = 0; base < batch.size(); base += 4) {
+        const size_t lanes = std::min<size_t>(4, batch.size() - base);
+        alignas(16) float ax[4]{}, ay[4]{}, az[4]{}, ar[4]{};
+        alignas(16) float bx[4]{}, by[4]{}, bz[4]{}, br[4]{};
+        for (size_t k = 0; k < lanes; ++k) {
+            const uint32_t a = batch[base + k].a, b = batch[base + k].b;
+            ax[k] = s.cX[a]; ay[k] = s.cY[a]; az[k] = s.cZ[a]; ar[k] = s.radius[a];
+            bx[k] = s.cX[b]; by[k] = s.cY[b]; bz[k] = s.cZ[b]; br[k] = s.radius[b];
+        }
+        XMVECTOR dx = XMVectorSubtract(Load4(bx), Load4(ax));
+        XMVECTOR dy = XMVectorSubtract(Load4(by), Load4(ay));
+        XMVECTOR dz = XMVectorSubtract(Load4(bz), Load4(az));
+        XMVECTOR d2 = XMVectorMultiplyAdd(dz, dz, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dx, dx)));
+        XMVECTOR rs = XMVectorAdd(XMVectorAdd(Load4(ar), Load4(br)), slack);
+        uint32_t hit[4];
+        XMStoreInt4(hit, XMVectorLessOrEqual(d2, XMVectorMultiply(rs, rs)));
+        for (size_t k = 0; k < lanes; ++k) {
+            if (!hit[k]) continue;
+            const BatchItem &it = batch[base + k];
+            ComputeContact(sphereAt(it.a), sphereAt(it.b), out[it.pair]);
+            if (it.flipped) FlipContact(out[it.pair]);
+        }
+    }
+}
+
+void ColliderPool::collideSphereObb(const std::vector<BatchItem> &batch, std::vector<OverlapResult> &out) const {
+    const Soa &s = spheres_;
+    const Soa &o = obbs_;
+    const XMVECTOR slack = XMVectorReplicate(2.0f * GetPhysicsConfig().epsilon);
+    for (size_t base = 0; base < batch.size(); base += 4) {
+        const size_t lanes = std::min<size_t>(4, batch.size() - base);
+        alignas(16) float dx[4]{}, dy[4]{}, dz[4]{}, r[4]{};
+        alignas(16) float ax[9][4]{};
+        alignas(16) float he[3][4]{};
+        for (size_t k = 0; k < lanes; ++k) {
+            const uint32_t a = batch[base + k].a, b = batch[base + k].b;
+            dx[k] = s.cX[a] - o.cX[b];
+            dy[k] = s.cY[a] - o.cY[b];
+            dz[k] = s.cZ[a] - o.cZ[b];
+            r[k] = s.radius[a];
+            for (int j = 0; j < 9; ++j) ax[j][k] = o.axes[j][b];
+            he[0][k] = o.heX[b];
+            he[1][k] = o.heY[b];
+            he[2][k] = o.heZ[b];
+        }
+        // 球心相对盒心的偏移 d，投影到三根轴后夹取到半尺寸，得到最近点偏移 q；残差 d - q 即球心到盒的距离向量
+        const XMVECTOR Dx = Load4(dx), Dy = Load4(dy), Dz = Load4(dz);
+        XMVECTOR qx = XMVectorZero(), qy = XMVectorZero(), qz = XMVectorZero();
+        for (int k = 0; k < 3; ++k) {
+            const XMVECTOR Ax = Load4(ax[k * 3 + 0]), Ay = Load4(ax[k * 3 + 1]), Az = Load4(ax[k * 3 + 2]);
+            const XMVECTOR e = Load4(he[k]);
+            XMVECTOR u = XMVectorMultiplyAdd(Dz, Az, XMVectorMultiplyAdd(Dy, Ay, XMVectorMultiply(Dx, Ax)));
+            u = XMVectorClamp(u, XMVectorNegate(e), e);
+            qx = XMVectorMultiplyAdd(Ax, u, qx);
+            qy = XMVectorMultiplyAdd(Ay, u, qy);
+            qz = XMVectorMultiplyAdd(Az, u, qz);
+        }
+        const XMVECTOR rx = XMVectorSubtract(Dx, qx);
+        const XMVECTOR ry = XMVectorSubtract(Dy, qy);
+        const XMVECTOR rz = XMVectorSubtract(Dz, qz);
+        XMVECTOR d2 = XMVectorMultiplyAdd(rz, rz, XMVectorMultiplyAdd(ry, ry, XMVectorMultiply(rx, rx)));
+        XMVECTOR rr = XMVectorAdd(Load4(r), slack);
+        uint32_t hit[4];
+        XMStoreInt4(hit, XMVectorLessOrEqual(d2, XMVectorMultiply(rr, rr)));
+        for (size_t k = 0; k < lanes; ++k) {
+            if (!hit[k]) continue;
+            const BatchItem &it = batch[base + k];
+            ComputeContact(sphereAt(it.a), obbAt(it.b), out[it.pair]);
+            if (it.flipped) FlipContact(out[it.pair]);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <cstdint>
+#include <DirectXMath.h>
+
+#include "Collider.hpp"
+
+// 碰撞体 SoA 池（PhysicsWorld 内部持有）
+// 设计要点：
+// - Sphere / OBB / Capsule 各自一组连续数组（分量拆开存放），数组长度补齐到 4 的倍数，便于 4 路 SIMD；
+// - 旋转相关量（Owner 原点→形状中心的世界偏移、世界轴、世界半尺寸、AABB 半尺寸）只在朝向/局部参数/缩放变化时
+//   由 Collider 实现推送（setShape），不再每次查询都由欧拉角重建矩阵；
+// - 每步只有 Owner 位置变化：writeOwnerPosition 批量写入后调用 updateDerived，以 4 路 DirectXMath 向量
+//   一次算出全部中心与 AABB；
+// - 窄相按类型对分桶（Sphere-Sphere、Sphere-OBB 等），同类批次直接读数组，球-球与球-OBB 先做 4 路 SIMD 粗筛；
+//   窄相对池只读，分桶放在调用方提供的 Batches 中，多线程可各自处理不相交的对区间；
+// - Id 稳定：删除时末尾元素换入空位，只更新 Id → 槽位表，已发出的 Id 不变。
+class ColliderPool {
+public:
+    using Id = uint32_t;
+    static constexpr Id InvalidId = 0xffffffffu;
+
+    // 旋转相关量（世界空间），由 Collider 实现在绑定时及朝向/局部参数/缩放变化时推送
+    struct ShapeCache {
+        DirectX::XMFLOAT3 offset{0, 0, 0}; // Owner 世界原点 → 形状中心（Capsule 为线段中点）
+        DirectX::XMFLOAT3 extent{0, 0, 0}; // 世界 AABB 半尺寸
+        DirectX::XMFLOAT3 axes[3]{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; // 世界单位轴（R = Rlocal * Rowner 的三行）
+        DirectX::XMFLOAT3 halfExtents{0, 0, 0}; // OBB 世界半尺寸
+        DirectX::XMFLOAT3 halfSegment{0, 0, 0}; // Capsule：中点 → p1 的世界向量
+        float radius = 0; // Sphere / Capsule 世界半径
+    };
+
+    // 加入并绑定（collider->bindPool 会推送当前 Owner 位置与 ShapeCache）
+    Id add(ColliderBase *collider);
+
+    // 解绑并移除
+    void remove(Id id);
+
+    bool valid(Id id) const { return id < slots_.size() && slots_[id].alive; }
+
+    size_t size() const { return spheres_.count + obbs_.count + capsules_.count; }
+
+    // —— 写入 ——
+    // 立即刷新该槽位的中心/AABB（单个 Collider 的 setOwnerWorldPosition 走此路径）
+    void setOwnerPosition(Id id, const DirectX::XMFLOAT3 &posW);
+
+    // 仅写入 Owner 位置，派生量延迟到 updateDerived（每步批量同步走此路径）
+    void writeOwnerPosition(Id id, const DirectX::XMFLOAT3 &posW);
+
+    void setShape(Id id, const ShapeCache &shape);
+
+    // 批量刷新所有被 writeOwnerPosition 改动过的类型数组
+    void updateDerived();
+
+    // —— 读取（调用方保证 updateDerived 之后再读）——
+    DirectX::XMFLOAT3 ownerPosition(Id id) const;
+
+    DirectX::XMFLOAT3 center(Id id) const;
+
+    Aabb aabb(Id id) const;
+
+    ShapeCache shape(Id id) const;
+
+    // 窄相批次条目：同类型对，a/b 为各自类型数组下标
+    struct BatchItem {
+        uint32_t a;
+        uint32_t b;
+        uint32_t pair; // 原始对下标
+        bool flipped; // 输入顺序与批次约定（Sphere < Obb < Capsule）相反
+    };
+
+    // 窄相分桶：SS, SO, SC, OO, OC, CC（每个并发调用方各持一份，跨步复用容量）
+    struct Batches {
+        std::vector<BatchItem> items[6];
+    };
+
+    // 窄相：对 pairs 中的每一对求接触，out[i] 与 pairs[i] 一一对应（未相交项 intersects=false）。
+    // 结果与逐对调用 Intersect(A, B, out) 一致，输出顺序与输入顺序相同。
+    void collide(const std::vector<ColliderPair> &pairs, std::vector<OverlapResult> &out);
+
+    // 只处理 pairs[begin, end)，结果写入 out[begin, end)（out 须已有 pairs.size() 项）。
+    // 不修改池，不同线程可用各自的 scratch 并发处理不相交区间。
+    void collideRange(const std::vector<ColliderPair> &pairs, size_t begin, size_t end,
+                      std::vector<OverlapResult> &out, Batches &scratch) const;
+
+private:
+    // 单一类型的 SoA 数组（三类共用同一布局，类型专有的数组在其他类型中保持为零）
+    struct Soa {
+        uint32_t count = 0;
+        bool dirty = false;
+        std::vector<ColliderBase *> colliders;
+        std::vector<Id> ids;
+        std::vector<float> ownerX, ownerY, ownerZ;
+        std::vector<float> offX, offY, offZ;
+        std::vector<float> extX, extY, extZ;
+        std::vector<float> cX, cY, cZ;
+        std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+        std::vector<float> radius;
+        std::vector<float> axes[9]; // a0.xyz, a1.xyz, a2.xyz
+        std::vector<float> heX, heY, heZ;
+        std::vector<float> segX, segY, segZ;
+
+        uint32_t push(ColliderBase *collider, Id id);
+
+        // 末尾换入 slot；返回被移动元素的 Id（无移动时为 InvalidId）
+        Id erase(uint32_t slot);
+
+        void resizeLanes(size_t lanes);
+
+        void refreshSlot(uint32_t slot);
+
+        void refreshAll();
+    };
+
+    struct Slot {
+        ColliderType type = ColliderType::Sphere;
+        uint32_t index = 0; // 类型数组中的下标
+        bool alive = false;
+    };
+
+    Soa &soa(ColliderType t);
+
+    const Soa &soa(ColliderType t) const;
+
+    SphereShape sphereAt(uint32_t i) const;
+
+    ObbShape obbAt(uint32_t i) const;
+
+    CapsuleShape capsuleAt(uint32_t i) const;
+
+    void collideSphereSphere(const std::vector<BatchItem> &batch, std::vector<OverlapResult> &out) const;
+
+    void collideSphereObb(const std::vector<BatchItem> &batch, std::vector<OverlapResult> &out) const;
+
+    template<typename GetA, typename GetB>
+    void collideScalar(const std::vector<BatchItem> &batch, GetA getA, GetB getB,
+                       std::vector<OverlapResult> &out) const;
+
+    Soa spheres_;
+    Soa obbs_;
+    Soa capsules_;
+    std::vector<Slot> slots_;
+    std::vector<Id> freeIds_;
+
+    // 单线程 collide 使用的分桶
+    Batches batches_;
+};
@@ -1,4 +1,5 @@
 ﻿#include "Collider.hpp"
+#include "ColliderPool.hpp"
 #include "Transform.hpp"
 #include <cmath>
 #include <algorithm>
@@ -9,30 +10,66 @@ static inline bool NearlyEqual(float a, float b, float eps) {
     return std::fabs(a - b) <= eps;
 }
 
-static XMMATRIX MakeWorld(const XMFLOAT3 &pos, const XMFLOAT3 &euler, const XMFLOAT3 &scl) {
-    XMMATRIX S = XMMatrixScaling(scl.x, scl.y, scl.z);
-    XMMATRIX R = XMMatrixRotationRollPitchYaw(euler.x, euler.y, euler.z);
-    XMMATRIX T = XMMatrixTranslation(pos.x, pos.y, pos.z);
-    return S * R * T;
-}
-
 namespace {
+    inline bool SameFloat3(const XMFLOAT3 &a, const XMFLOAT3 &b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    inline bool SameFloat4(const XMFLOAT4 &a, const XMFLOAT4 &b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+    }
+
+    // 旋转缓存的公共部分：世界轴取 R = Rlocal * Rowner 的三行，offset 为 Owner 朝向下的局部偏移
+    inline void BuildRotation(const XMFLOAT4 &ownerRot, const XMFLOAT4 &localRot, const XMFLOAT3 &localOffset,
+                              ColliderPool::ShapeCache &sc) {
+        XMMATRIX Rowner = XMMatrixRotationQuaternion(XMQuaternionNormalize(XMLoadFloat4(&ownerRot)));
+        XMMATRIX Rlocal = XMMatrixRotationQuaternion(XMQuaternionNormalize(XMLoadFloat4(&localRot)));
+        XMMATRIX R = Rlocal * Rowner;
+        XMStoreFloat3(&sc.axes[0], XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(1, 0, 0, 0), R)));
+        XMStoreFloat3(&sc.axes[1], XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(0, 1, 0, 0), R)));
+        XMStoreFloat3(&sc.axes[2], XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(0, 0, 1, 0), R)));
+        XMVECTOR off = XMVector3TransformNormal(XMVectorSet(localOffset.x, localOffset.y, localOffset.z, 0), Rowner);
+        XMStoreFloat3(&sc.offset, off);
+    }
+
+    // 由缓存的世界轴还原旋转矩阵（轴即 R 的行）
+    inline XMMATRIX RotationFromAxes(const XMFLOAT3 axes[3]) {
+        return XMMATRIX(XMVectorSet(axes[0].x, axes[0].y, axes[0].z, 0),
+                        XMVectorSet(axes[1].x, axes[1].y, axes[1].z, 0),
+                        XMVectorSet(axes[2].x, axes[2].y, axes[2].z, 0),
+                        XMVectorSet(0, 0, 0, 1));
+    }
+
+    inline XMFLOAT3 AddF3(const XMFLOAT3 &a, const XMFLOAT3 &b) { return XMFLOAT3{a.x + b.x, a.y + b.y, a.z + b.z}; }
+
+    // 世界朝向 = 局部旋转后接 Owner 旋转（与 R = Rlocal * Rowner 一致）
+    inline XMFLOAT4 ComposeRotation(const XMFLOAT4 &ownerRot, const XMFLOAT4 &localRot) {
+        XMFLOAT4 q;
+        XMStoreFloat4(&q, XMQuaternionNormalize(XMQuaternionMultiply(XMLoadFloat4(&localRot), XMLoadFloat4(&ownerRot))));
+        return q;
+    }
+
     class SphereColliderImpl final : public SphereCollider {
     public:
         explicit SphereColliderImpl(float rLocal)
             : m_radiusLocal(std::max(0.0f, rLocal)) {
+            rebuildShape();
         }
 
         ColliderType kind() const override { return ColliderType::Sphere; }
 
         // 局部偏移（相对 Owner）
         bool setPosition(const XMFLOAT3 &pos) override {
+            if (SameFloat3(m_localOffset, pos)) return true;
             m_localOffset = pos;
+            rebuildShape();
             return true;
         }
 
-        bool setRotationEuler(const XMFLOAT3 &rotEuler) override {
-            m_localRot = rotEuler;
+        bool setRotation(const XMFLOAT4 &rot) override {
+            if (SameFloat4(m_localRot, rot)) return true;
+            m_localRot = rot;
+            rebuildShape();
             return true;
         }
 
@@ -40,37 +77,31 @@ namespace {
             float eps = GetPhysicsConfig().epsilon;
             if (!NearlyEqual(scale.x, scale.y, eps) || !NearlyEqual(scale.x, scale.z, eps)) return false;
             if (scale.x <= 0 || scale.y <= 0 || scale.z <= 0) return false;
+            if (SameFloat3(m_scl, scale)) return true;
             m_scl = scale;
+            rebuildShape();
             return true;
         }
 
         XMFLOAT3 position() const override { return m_localOffset; }
-        XMFLOAT3 rotationEuler() const override { return m_localRot; }
+        XMFLOAT4 rotation() const override { return m_localRot; }
         XMFLOAT3 scale() const override { return m_scl; }
 
         // 组合 Owner 世界位姿 + 局部偏移/旋转
         XMMATRIX world() const override {
             XMMATRIX S = XMMatrixScaling(m_scl.x, m_scl.y, m_scl.z);
-            XMMATRIX Rowner = XMMatrixRotationRollPitchYaw(m_ownerRot.x, m_ownerRot.y, m_ownerRot.z);
-            XMMATRIX Rlocal = XMMatrixRotationRollPitchYaw(m_localRot.x, m_localRot.y, m_localRot.z);
-            XMMATRIX R = Rlocal * Rowner; // 先局部再跟随 Owner
-            // 世界中心 = ownerPos + Rowner * localOffset（Sphere 对旋转不敏感，仅用于偏移）
-            XMVECTOR off = XMVectorSet(m_localOffset.x, m_localOffset.y, m_localOffset.z, 0);
-            off = XMVector3TransformNormal(off, Rowner);
-            XMFLOAT3 centerW{m_ownerPos.x, m_ownerPos.y, m_ownerPos.z};
-            XMVECTOR c = XMVectorSet(centerW.x, centerW.y, centerW.z, 1.0f);
-            c = XMVectorAdd(c, off);
-            XMFLOAT3 cw{};
-            XMStoreFloat3(&cw, c);
+            XMFLOAT3 cw = centerWorld();
             XMMATRIX T = XMMatrixTranslation(cw.x, cw.y, cw.z);
-            return S * R * T;
+            return S * RotationFromAxes(m_shape.axes) * T;
         }
 
+        // 旋转相关缓存在位姿/局部参数/缩放实际变化时已即时重建，无需额外刷新
         bool updateDerived() override { return true; }
 
         Aabb aabb() const override {
+            if (m_pool) return m_pool->aabb(m_poolId);
             XMFLOAT3 c = centerWorld();
-            float r = radiusWorld();
+            float r = m_shape.radius;
             return {XMFLOAT3{c.x - r, c.y - r, c.z - r}, XMFLOAT3{c.x + r, c.y + r, c.z + r}};
         }
 
@@ -92,26 +123,34 @@ namespace {
         void setIsStatic(bool isStatic) override { m_isStatic = isStatic; }
         bool isStatic() const override { return m_isStatic; }
 
+        void setLayer(uint32_t layerBits) override { m_layer = layerBits; }
+        uint32_t layer() const override { return m_layer; }
+        void setCollisionMask(uint32_t maskBits) override { m_mask = maskBits; }
+        uint32_t collisionMask() const override { return m_mask; }
+
         // Sphere specifics
         float radiusLocal() const override { return m_radiusLocal; }
         float radiusWorld() const override { return m_radiusLocal * m_scl.x; }
 
         XMFLOAT3 centerWorld() const override {
-            XMMATRIX Rowner = XMMatrixRotationRollPitchYaw(m_ownerRot.x, m_ownerRot.y, m_ownerRot.z);
-            XMVECTOR off = XMVectorSet(m_localOffset.x, m_localOffset.y, m_localOffset.z, 0);
-            off = XMVector3TransformNormal(off, Rowner);
-            XMVECTOR base = XMVectorSet(m_ownerPos.x, m_ownerPos.y, m_ownerPos.z, 1.0f);
-            XMVECTOR c = XMVectorAdd(base, off);
-            XMFLOAT3 cw{};
-            XMStoreFloat3(&cw, c);
-            return cw;
+            if (m_pool) return m_pool->center(m_poolId);
+            return AddF3(m_ownerPos, m_shape.offset);
         }
 
         // Owner 世界位姿注入/读取
-        void setOwnerWorldPosition(const XMFLOAT3 &ownerPosW) override { m_ownerPos = ownerPosW; }
-        void setOwnerWorldRotationEuler(const XMFLOAT3 &ownerRotEulerW) override { m_ownerRot = ownerRotEulerW; }
-        XMFLOAT3 ownerWorldPosition() const override { return m_ownerPos; }
-        XMFLOAT3 ownerWorldRotationEuler() const override { return m_ownerRot; }
+        void setOwnerWorldPosition(const XMFLOAT3 &ownerPosW) override {
+            m_ownerPos = ownerPosW;
+            if (m_pool) m_pool->setOwnerPosition(m_poolId, ownerPosW);
+        }
+
+        void setOwnerWorldRotation(const XMFLOAT4 &ownerRotW) override {
+            if (SameFloat4(m_ownerRot, ownerRotW)) return; // 每帧都会注入，朝向未变时不重建旋转量
+            m_ownerRot = ownerRotW;
+            rebuildShape();
+        }
+
+        XMFLOAT3 ownerWorldPosition() const override { return m_pool ? m_pool->ownerPosition(m_poolId) : m_ownerPos; }
+        XMFLOAT4 ownerWorldRotation() const override { return m_ownerRot; }
 
         // 射线相交检测（球体）
         bool intersectsRay(const XMFLOAT3 &rayOrigin, const XMFLOAT3 &rayDir, float &outDistance) const override {
@@ -149,23 +188,37 @@ namespace {
         }
 
         // 获取世界旋转（Owner世界旋转 + 局部旋转）
-        XMFLOAT3 getWorldRotationEuler() const override {
-            // 组合旋转：局部旋转 * Owner旋转
-            // 对于欧拉角，简单相加（近似，严格应该用四元数）
-            return XMFLOAT3{
-                m_ownerRot.x + m_localRot.x,
-                m_ownerRot.y + m_localRot.y,
-                m_ownerRot.z + m_localRot.z
-            };
+        XMFLOAT4 getWorldRotation() const override { return ComposeRotation(m_ownerRot, m_localRot); }
+
+        // 池绑定：解绑时取回池中的 Owner 位置
+        void bindPool(ColliderPool *pool, uint32_t id) override {
+            if (m_pool && !pool) m_ownerPos = m_pool->ownerPosition(m_poolId);
+            m_pool = pool;
+            m_poolId = pool ? id : ColliderPool::InvalidId;
+            if (m_pool) {
+                m_pool->setOwnerPosition(m_poolId, m_ownerPos);
+                m_pool->setShape(m_poolId, m_shape);
+            }
         }
 
+        uint32_t poolId() const override { return m_poolId; }
+
     private:
+        // 重建旋转相关缓存并推送到池
+        void rebuildShape() {
+            const float r = radiusWorld();
+            BuildRotation(m_ownerRot, m_localRot, m_localOffset, m_shape);
+            m_shape.extent = XMFLOAT3{r, r, r};
+            m_shape.radius = r;
+            if (m_pool) m_pool->setShape(m_poolId, m_shape);
+        }
+
         // Owner 世界位姿
         XMFLOAT3 m_ownerPos{0, 0, 0};
-        XMFLOAT3 m_ownerRot{0, 0, 0};
+        XMFLOAT4 m_ownerRot{0, 0, 0, 1}; // 四元数
         // 局部偏移/旋转（相对 Owner）
         XMFLOAT3 m_localOffset{0, 0, 0};
-        XMFLOAT3 m_localRot{0, 0, 0};
+        XMFLOAT4 m_localRot{0, 0, 0, 1}; // 四元数
         XMFLOAT3 m_scl{1, 1, 1};
         float m_radiusLocal{0};
         bool m_dbgEnabled{false};
@@ -173,63 +226,62 @@ namespace {
         XMFLOAT3 m_ownerOffset{0, 0, 0};
         bool m_isTrigger{false};
         bool m_isStatic{false};
+        uint32_t m_layer{1};
+        uint32_t m_mask{0xffffffffu};
+        ColliderPool *m_pool{nullptr};
+        uint32_t m_poolId{ColliderPool::InvalidId};
+        ColliderPool::ShapeCache m_shape{}; // 旋转相关缓存（未绑定时也用于派生量查询）
     };
 
     class ObbColliderImpl final : public ObbCollider {
     public:
         explicit ObbColliderImpl(const XMFLOAT3 &heLocal) : m_halfLocal(heLocal) {
+            rebuildShape();
         }
 
         ColliderType kind() const override { return ColliderType::Obb; }
 
         bool setPosition(const XMFLOAT3 &pos) override {
+            if (SameFloat3(m_localOffset, pos)) return true;
             m_localOffset = pos;
+            rebuildShape();
             return true;
         }
 
-        bool setRotationEuler(const XMFLOAT3 &rotEuler) override {
-            m_localRot = rotEuler;
+        bool setRotation(const XMFLOAT4 &rot) override {
+            if (SameFloat4(m_localRot, rot)) return true;
+            m_localRot = rot;
+            rebuildShape();
             return true;
         }
 
         bool setScale(const XMFLOAT3 &scale) override {
             if (scale.x <= 0 || scale.y <= 0 || scale.z <= 0) return false;
+            if (SameFloat3(m_scl, scale)) return true;
             m_scl = scale;
+            rebuildShape();
             return true;
         }
 
         XMFLOAT3 position() const override { return m_localOffset; }
-        XMFLOAT3 rotationEuler() const override { return m_localRot; }
+        XMFLOAT4 rotation() const override { return m_localRot; }
         XMFLOAT3 scale() const override { return m_scl; }
 
         XMMATRIX world() const override {
             XMMATRIX S = XMMatrixScaling(m_scl.x, m_scl.y, m_scl.z);
-            XMMATRIX Rowner = XMMatrixRotationRollPitchYaw(m_ownerRot.x, m_ownerRot.y, m_ownerRot.z);
-            XMMATRIX Rlocal = XMMatrixRotationRollPitchYaw(m_localRot.x, m_localRot.y, m_localRot.z);
-            XMMATRIX R = Rlocal * Rowner;
-            XMVECTOR off = XMVectorSet(m_localOffset.x, m_localOffset.y, m_localOffset.z, 0);
-            off = XMVector3TransformNormal(off, Rowner);
-            XMVECTOR base = XMVectorSet(m_ownerPos.x, m_ownerPos.y, m_ownerPos.z, 1.0f);
-            XMVECTOR c = XMVectorAdd(base, off);
-            XMFLOAT3 cw{};
-            XMStoreFloat3(&cw, c);
+            XMFLOAT3 cw = centerWorld();
             XMMATRIX T = XMMatrixTranslation(cw.x, cw.y, cw.z);
-            return S * R * T;
+            return S * RotationFromAxes(m_shape.axes) * T;
         }
 
+        // 旋转相关缓存在位姿/局部参数/缩放实际变化时已即时重建，无需额外刷新
         bool updateDerived() override { return true; }
 
         Aabb aabb() const override {
-            // Use centerW and axesW with halfExtentsW to compute world-space AABB
+            if (m_pool) return m_pool->aabb(m_poolId);
+            // 世界 AABB 半尺寸已随旋转缓存求出
             XMFLOAT3 center = centerWorld();
-            XMFLOAT3 heW = halfExtentsWorld();
-            XMFLOAT3 axes[3];
-            axesWorld(axes);
-            // extents along world axes
-            XMFLOAT3 e{};
-            e.x = std::fabs(axes[0].x) * heW.x + std::fabs(axes[1].x) * heW.y + std::fabs(axes[2].x) * heW.z;
-            e.y = std::fabs(axes[0].y) * heW.x + std::fabs(axes[1].y) * heW.y + std::fabs(axes[2].y) * heW.z;
-            e.z = std::fabs(axes[0].z) * heW.x + std::fabs(axes[1].z) * heW.y + std::fabs(axes[2].z) * heW.z;
+            const XMFLOAT3 &e = m_shape.extent;
             return {
                 XMFLOAT3{center.x - e.x, center.y - e.y, center.z - e.z},
                 XMFLOAT3{center.x + e.x, center.y + e.y, center.z + e.z}
@@ -254,45 +306,38 @@ namespace {
         void setIsStatic(bool isStatic) override { m_isStatic = isStatic; }
         bool isStatic() const override { return m_isStatic; }
 
+        void setLayer(uint32_t layerBits) override { m_layer = layerBits; }
+        uint32_t layer() const override { return m_layer; }
+        void setCollisionMask(uint32_t maskBits) override { m_mask = maskBits; }
+        uint32_t collisionMask() const override { return m_mask; }
+
         // Owner 世界位姿注入/读取
-        void setOwnerWorldPosition(const XMFLOAT3 &ownerPosW) override { m_ownerPos = ownerPosW; }
-        void setOwnerWorldRotationEuler(const XMFLOAT3 &ownerRotEulerW) override { m_ownerRot = ownerRotEulerW; }
-        XMFLOAT3 ownerWorldPosition() const override { return m_ownerPos; }
-        XMFLOAT3 ownerWorldRotationEuler() const override { return m_ownerRot; }
+        void setOwnerWorldPosition(const XMFLOAT3 &ownerPosW) override {
+            m_ownerPos = ownerPosW;
+            if (m_pool) m_pool->setOwnerPosition(m_poolId, ownerPosW);
+        }
+
+        void setOwnerWorldRotation(const XMFLOAT4 &ownerRotW) override {
+            if (SameFloat4(m_ownerRot, ownerRotW)) return; // 每帧都会注入，朝向未变时不重建旋转量
+            m_ownerRot = ownerRotW;
+            rebuildShape();
+        }
+
+        XMFLOAT3 ownerWorldPosition() const override { return m_pool ? m_pool->ownerPosition(m_poolId) : m_ownerPos; }
+        XMFLOAT4 ownerWorldRotation() const override { return m_ownerRot; }
 
         // OBB specifics
         XMFLOAT3 centerWorld() const override {
-            XMMATRIX Rowner = XMMatrixRotationRollPitchYaw(m_ownerRot.x, m_ownerRot.y, m_ownerRot.z);
-            XMVECTOR off = XMVectorSet(m_localOffset.x, m_localOffset.y, m_localOffset.z, 0);
-            off = XMVector3TransformNormal(off, Rowner);
-            XMVECTOR base = XMVectorSet(m_ownerPos.x, m_ownerPos.y, m_ownerPos.z, 1.0f);
-            XMVECTOR c = XMVectorAdd(base, off);
-            XMFLOAT3 cw{};
-            XMStoreFloat3(&cw, c);
-            return cw;
+            if (m_pool) return m_pool->center(m_poolId);
+            return AddF3(m_ownerPos, m_shape.offset);
         }
 
         void axesWorld(XMFLOAT3 outAxes[3]) const override {
-            XMMATRIX Rowner = XMMatrixRotationRollPitchYaw(m_ownerRot.x, m_ownerRot.y, m_ownerRot.z);
-            XMMATRIX Rlocal = XMMatrixRotationRollPitchYaw(m_localRot.x, m_localRot.y, m_localRot.z);
-            XMMATRIX R = Rlocal * Rowner;
-            // Transform unit basis to get world-space orientation (ignoring scale and translation)
-            XMVECTOR x = XMVector3TransformNormal(XMVectorSet(1, 0, 0, 0), R);
-            XMVECTOR y = XMVector3TransformNormal(XMVectorSet(0, 1, 0, 0), R);
-            XMVECTOR z = XMVector3TransformNormal(XMVectorSet(0, 0, 1, 0), R);
-            XMStoreFloat3(&outAxes[0], XMVector3Normalize(x));
-            XMStoreFloat3(&outAxes[1], XMVector3Normalize(y));
-            XMStoreFloat3(&outAxes[2], XMVector3Normalize(z));
-        }
-
-        XMFLOAT3 halfExtentsWorld() const override {
-            return XMFLOAT3{
-                std::fabs(m_scl.x) * m_halfLocal.x,
-                std::fabs(m_scl.y) * m_halfLocal.y,
-                std::fabs(m_scl.z) * m_halfLocal.z
-            };
+            for (int i = 0; i < 3; ++i) outAxes[i] = m_shape.axes[i];
         }
 
+        XMFLOAT3 halfExtentsWorld() const override { return m_shape.halfExtents; }
+
         // 射线相交检测（OBB）- 使用 Slab 方法
         bool intersectsRay(const XMFLOAT3 &rayOrigin, const XMFLOAT3 &rayDir, float &outDistance) const override {
             XMFLOAT3 center = centerWorld();
@@ -342,21 +387,45 @@ namespace {
         }
 
         // 获取世界旋转（Owner世界旋转 + 局部旋转）
-        XMFLOAT3 getWorldRotationEuler() const override {
-            // 组合旋转：局部旋转 * Owner旋转
-            // 对于欧拉角，简单相加（近似，严格应该用四元数）
-            return XMFLOAT3{
-                m_ownerRot.x + m_localRot.x,
-                m_ownerRot.y + m_localRot.y,
-                m_ownerRot.z + m_localRot.z
-            };
+        XMFLOAT4 getWorldRotation() const override { return ComposeRotation(m_ownerRot, m_localRot); }
+
+        // 池绑定：解绑时取回池中的 Owner 位置
+        void bindPool(ColliderPool *pool, uint32_t id) override {
+            if (m_pool && !pool) m_ownerPos = m_pool->ownerPosition(m_poolId);
+            m_pool = pool;
+            m_poolId = pool ? id : ColliderPool::InvalidId;
+            if (m_pool) {
+                m_pool->setOwnerPosition(m_poolId, m_ownerPos);
+                m_pool->setShape(m_poolId, m_shape);
+            }
         }
 
+        uint32_t poolId() const override { return m_poolId; }
+
     private:
+        // 重建旋转相关缓存并推送到池
+        void rebuildShape() {
+            ColliderPool::ShapeCache &sc = m_shape;
+            BuildRotation(m_ownerRot, m_localRot, m_localOffset, sc);
+            const XMFLOAT3 he{
+                std::fabs(m_scl.x) * m_halfLocal.x,
+                std::fabs(m_scl.y) * m_halfLocal.y,
+                std::fabs(m_scl.z) * m_halfLocal.z
+            };
+            const XMFLOAT3 *ax = sc.axes;
+            sc.halfExtents = he;
+            sc.extent = XMFLOAT3{
+                std::fabs(ax[0].x) * he.x + std::fabs(ax[1].x) * he.y + std::fabs(ax[2].x) * he.z,
+                std::fabs(ax[0].y) * he.x + std::fabs(ax[1].y) * he.y + std::fabs(ax[2].y) * he.z,
+                std::fabs(ax[0].z) * he.x + std::fabs(ax[1].z) * he.y + std::fabs(ax[2].z) * he.z
+            };
+            if (m_pool) m_pool->setShape(m_poolId, sc);
+        }
+
         XMFLOAT3 m_ownerPos{0, 0, 0};
-        XMFLOAT3 m_ownerRot{0, 0, 0};
+        XMFLOAT4 m_ownerRot{0, 0, 0, 1}; // 四元数
         XMFLOAT3 m_localOffset{0, 0, 0};
-        XMFLOAT3 m_localRot{0, 0, 0};
+        XMFLOAT4 m_localRot{0, 0, 0, 1}; // 四元数
         XMFLOAT3 m_scl{1, 1, 1};
         XMFLOAT3 m_halfLocal{0.5f, 0.5f, 0.5f};
         bool m_dbgEnabled{false};
@@ -364,23 +433,33 @@ namespace {
         XMFLOAT3 m_ownerOffset{0, 0, 0};
         bool m_isTrigger{false};
         bool m_isStatic{false};
+        uint32_t m_layer{1};
+        uint32_t m_mask{0xffffffffu};
+        ColliderPool *m_pool{nullptr};
+        uint32_t m_poolId{ColliderPool::InvalidId};
+        ColliderPool::ShapeCache m_shape{}; // 旋转相关缓存（未绑定时也用于派生量查询）
     };
 
     class CapsuleColliderImpl final : public CapsuleCollider {
     public:
         CapsuleColliderImpl(const XMFLOAT3 &p0Local, const XMFLOAT3 &p1Local, float radiusLocal)
             : m_p0Local(p0Local), m_p1Local(p1Local), m_radiusLocal(std::max(0.0f, radiusLocal)) {
+            rebuildShape();
         }
 
         ColliderType kind() const override { return ColliderType::Capsule; }
 
         bool setPosition(const XMFLOAT3 &pos) override {
+            if (SameFloat3(m_localOffset, pos)) return true;
             m_localOffset = pos;
+            rebuildShape();
             return true;
         }
 
-        bool setRotationEuler(const XMFLOAT3 &rotEuler) override {
-            m_localRot = rotEuler;
+        bool setRotation(const XMFLOAT4 &rot) override {
+            if (SameFloat4(m_localRot, rot)) return true;
+            m_localRot = rot;
+            rebuildShape();
             return true;
         }
 
@@ -401,38 +480,32 @@ namespace {
                 // 与Z轴对齐：要求 x==y
                 if (!NearlyEqual(scale.x, scale.y, eps)) return false;
             }
+            if (SameFloat3(m_scl, scale)) return true;
             m_scl = scale;
+            rebuildShape();
             return true;
         }
 
         XMFLOAT3 position() const override { return m_localOffset; }
-        XMFLOAT3 rotationEuler() const override { return m_localRot; }
+        XMFLOAT4 rotation() const override { return m_localRot; }
         XMFLOAT3 scale() const override { return m_scl; }
 
         XMMATRIX world() const override {
             XMMATRIX S = XMMatrixScaling(m_scl.x, m_scl.y, m_scl.z);
-            XMMATRIX Rowner = XMMatrixRotationRollPitchYaw(m_ownerRot.x, m_ownerRot.y, m_ownerRot.z);
-            XMMATRIX Rlocal = XMMatrixRotationRollPitchYaw(m_localRot.x, m_localRot.y, m_localRot.z);
-            XMMATRIX R = Rlocal * Rowner;
-            XMVECTOR off = XMVectorSet(m_localOffset.x, m_localOffset.y, m_localOffset.z, 0);
-            off = XMVector3TransformNormal(off, Rowner);
-            XMVECTOR base = XMVectorSet(m_ownerPos.x, m_ownerPos.y, m_ownerPos.z, 1.0f);
-            XMVECTOR c = XMVectorAdd(base, off);
-            XMFLOAT3 cw{};
-            XMStoreFloat3(&cw, c);
-            XMMATRIX T = XMMatrixTranslation(cw.x, cw.y, cw.z);
-            return S * R * T;
+            // 平移取 Owner 位置 + 旋转后的局部偏移（即线段中点减去 m_segMid）
+            XMFLOAT3 c = segmentCenter();
+            XMMATRIX T = XMMatrixTranslation(c.x - m_segMid.x, c.y - m_segMid.y, c.z - m_segMid.z);
+            return S * RotationFromAxes(m_shape.axes) * T;
         }
 
+        // 旋转相关缓存在位姿/局部参数/缩放实际变化时已即时重建，无需额外刷新
         bool updateDerived() override { return true; }
 
         Aabb aabb() const override {
-            auto seg = segmentWorld();
-            XMFLOAT3 p0 = seg.first, p1 = seg.second;
-            float r = radiusWorld();
-            XMFLOAT3 mn{std::min(p0.x, p1.x) - r, std::min(p0.y, p1.y) - r, std::min(p0.z, p1.z) - r};
-            XMFLOAT3 mx{std::max(p0.x, p1.x) + r, std::max(p0.y, p1.y) + r, std::max(p0.z, p1.z) + r};
-            return {mn, mx};
+            if (m_pool) return m_pool->aabb(m_poolId);
+            const XMFLOAT3 c = segmentCenter();
+            const XMFLOAT3 &e = m_shape.extent;
+            return {XMFLOAT3{c.x - e.x, c.y - e.y, c.z - e.z}, XMFLOAT3{c.x + e.x, c.y + e.y, c.z + e.z}};
         }
 
         void setDebugEnabled(bool enabled) override { m_dbgEnabled = enabled; }
@@ -453,11 +526,25 @@ namespace {
         void setIsStatic(bool isStatic) override { m_isStatic = isStatic; }
         bool isStatic() const override { return m_isStatic; }
 
+        void setLayer(uint32_t layerBits) override { m_layer = layerBits; }
+        uint32_t layer() const override { return m_layer; }
+        void setCollisionMask(uint32_t maskBits) override { m_mask = maskBits; }
+        uint32_t collisionMask() const override { return m_mask; }
+
         // Owner 世界位姿注入/读取
-        void setOwnerWorldPosition(const XMFLOAT3 &ownerPosW) override { m_ownerPos = ownerPosW; }
-        void setOwnerWorldRotationEuler(const XMFLOAT3 &ownerRotEulerW) override { m_ownerRot = ownerRotEulerW; }
-        XMFLOAT3 ownerWorldPosition() const override { return m_ownerPos; }
-        XMFLOAT3 ownerWorldRotationEuler() const override { return m_ownerRot; }
+        void setOwnerWorldPosition(const XMFLOAT3 &ownerPosW) override {
+            m_ownerPos = ownerPosW;
+            if (m_pool) m_pool->setOwnerPosition(m_poolId, ownerPosW);
+        }
+
+        void setOwnerWorldRotation(const XMFLOAT4 &ownerRotW) override {
+            if (SameFloat4(m_ownerRot, ownerRotW)) return; // 每帧都会注入，朝向未变时不重建旋转量
+            m_ownerRot = ownerRotW;
+            rebuildShape();
+        }
+
+        XMFLOAT3 ownerWorldPosition() const override { return m_pool ? m_pool->ownerPosition(m_poolId) : m_ownerPos; }
+        XMFLOAT4 ownerWorldRotation() const override { return m_ownerRot; }
 
         // 射线相交检测（Capsule）- 简化版：先检测与线段端点球体相交
         bool intersectsRay(const XMFLOAT3 &rayOrigin, const XMFLOAT3 &rayDir, float &outDistance) const override {
@@ -518,41 +605,32 @@ namespace {
         }
 
         // 获取世界旋转（Owner世界旋转 + 局部旋转）
-        XMFLOAT3 getWorldRotationEuler() const override {
-            // 组合旋转：局部旋转 * Owner旋转
-            // 对于欧拉角，简单相加（近似，严格应该用四元数）
-            return XMFLOAT3{
-                m_ownerRot.x + m_localRot.x,
-                m_ownerRot.y + m_localRot.y,
-                m_ownerRot.z + m_localRot.z
-            };
-        }
+        XMFLOAT4 getWorldRotation() const override { return ComposeRotation(m_ownerRot, m_localRot); }
 
         // Capsule specifics
         std::pair<XMFLOAT3, XMFLOAT3> segmentWorld() const override {
-            XMMATRIX S = XMMatrixScaling(m_scl.x, m_scl.y, m_scl.z);
-            XMMATRIX Rowner = XMMatrixRotationRollPitchYaw(m_ownerRot.x, m_ownerRot.y, m_ownerRot.z);
-            XMMATRIX Rlocal = XMMatrixRotationRollPitchYaw(m_localRot.x, m_localRot.y, m_localRot.z);
-            XMMATRIX R = Rlocal * Rowner;
-            XMVECTOR off = XMVectorSet(m_localOffset.x, m_localOffset.y, m_localOffset.z, 0);
-            off = XMVector3TransformNormal(off, Rowner);
-            XMVECTOR base = XMVectorSet(m_ownerPos.x, m_ownerPos.y, m_ownerPos.z, 1.0f);
-            XMVECTOR c = XMVectorAdd(base, off);
-            XMFLOAT3 cw{};
-            XMStoreFloat3(&cw, c);
-            XMMATRIX T = XMMatrixTranslation(cw.x, cw.y, cw.z);
-            XMMATRIX M = S * R * T;
-            XMVECTOR p0 = XMVectorSet(m_p0Local.x, m_p0Local.y, m_p0Local.z, 1.0f);
-            XMVECTOR p1 = XMVectorSet(m_p1Local.x, m_p1Local.y, m_p1Local.z, 1.0f);
-            p0 = XMVector3TransformCoord(p0, M);
-            p1 = XMVector3TransformCoord(p1, M);
-            XMFLOAT3 o0{}, o1{};
-            XMStoreFloat3(&o0, p0);
-            XMStoreFloat3(&o1, p1);
-            return {o0, o1};
-        }
-
-        float radiusWorld() const override {
+            const XMFLOAT3 c = segmentCenter();
+            const XMFLOAT3 &h = m_shape.halfSegment;
+            return {XMFLOAT3{c.x - h.x, c.y - h.y, c.z - h.z}, XMFLOAT3{c.x + h.x, c.y + h.y, c.z + h.z}};
+        }
+
+        float radiusWorld() const override { return m_shape.radius; }
+
+        // 池绑定：解绑时取回池中的 Owner 位置
+        void bindPool(ColliderPool *pool, uint32_t id) override {
+            if (m_pool && !pool) m_ownerPos = m_pool->ownerPosition(m_poolId);
+            m_pool = pool;
+            m_poolId = pool ? id : ColliderPool::InvalidId;
+            if (m_pool) {
+                m_pool->setOwnerPosition(m_poolId, m_ownerPos);
+                m_pool->setShape(m_poolId, m_shape);
+            }
+        }
+
+        uint32_t poolId() const override { return m_poolId; }
+
+    private:
+        float computeRadiusWorld() const {
             // 选择半径方向缩放（与长轴正交的等比尺度）
             XMFLOAT3 axis = localAxisUnit();
             float ax = std::fabs(axis.x), ay = std::fabs(axis.y), az = std::fabs(axis.z);
@@ -568,7 +646,30 @@ namespace {
             return m_radiusLocal * rScale;
         }
 
-    private:
+        // 重建旋转相关缓存并推送到池：线段端点经 S*R 变换，中点并入偏移，半段向量单独保存
+        void rebuildShape() {
+            ColliderPool::ShapeCache &sc = m_shape;
+            BuildRotation(m_ownerRot, m_localRot, m_localOffset, sc);
+            XMMATRIX SR = XMMatrixScaling(m_scl.x, m_scl.y, m_scl.z) * RotationFromAxes(sc.axes);
+            XMVECTOR p0 = XMVector3TransformNormal(XMLoadFloat3(&m_p0Local), SR);
+            XMVECTOR p1 = XMVector3TransformNormal(XMLoadFloat3(&m_p1Local), SR);
+            XMFLOAT3 half{};
+            XMStoreFloat3(&m_segMid, XMVectorScale(XMVectorAdd(p0, p1), 0.5f));
+            XMStoreFloat3(&half, XMVectorScale(XMVectorSubtract(p1, p0), 0.5f));
+            const float r = computeRadiusWorld();
+            sc.offset = AddF3(sc.offset, m_segMid);
+            sc.halfSegment = half;
+            sc.radius = r;
+            sc.extent = XMFLOAT3{std::fabs(half.x) + r, std::fabs(half.y) + r, std::fabs(half.z) + r};
+            if (m_pool) m_pool->setShape(m_poolId, sc);
+        }
+
+        // 线段中点（世界）
+        XMFLOAT3 segmentCenter() const {
+            if (m_pool) return m_pool->center(m_poolId);
+            return AddF3(m_ownerPos, m_shape.offset);
+        }
+
         XMFLOAT3 localAxisUnit() const {
             XMVECTOR p0 = XMVectorSet(m_p0Local.x, m_p0Local.y, m_p0Local.z, 0);
             XMVECTOR p1 = XMVectorSet(m_p1Local.x, m_p1Local.y, m_p1Local.z, 0);
@@ -580,9 +681,9 @@ namespace {
         }
 
         XMFLOAT3 m_ownerPos{0, 0, 0};
-        XMFLOAT3 m_ownerRot{0, 0, 0};
+        XMFLOAT4 m_ownerRot{0, 0, 0, 1}; // 四元数
         XMFLOAT3 m_localOffset{0, 0, 0};
-        XMFLOAT3 m_localRot{0, 0, 0};
+        XMFLOAT4 m_localRot{0, 0, 0, 1}; // 四元数
         XMFLOAT3 m_scl{1, 1, 1};
         XMFLOAT3 m_p0Local{0, -0.5f, 0};
         XMFLOAT3 m_p1Local{0, 0.5f, 0};
@@ -592,6 +693,12 @@ namespace {
         XMFLOAT3 m_ownerOffset{0, 0, 0};
         bool m_isTrigger{false};
         bool m_isStatic{false};
+        uint32_t m_layer{1};
+        uint32_t m_mask{0xffffffffu};
+        ColliderPool *m_pool{nullptr};
+        uint32_t m_poolId{ColliderPool::InvalidId};
+        ColliderPool::ShapeCache m_shape{}; // 旋转相关缓存（未绑定时也用于派生量查询）
+        XMFLOAT3 m_segMid{0, 0, 0}; // S*R 变换后的线段中点（相对局部偏移点）
     };
 } // namespace
 
@@ -1,5 +1,7 @@
 ﻿#include "ContactSolver.hpp"
+#include "WorkerPool.hpp"
 #include <algorithm>
+#include <bit>
 #include <cmath>
 
 using namespace DirectX;
@@ -31,67 +33,276 @@ static inline XMFLOAT3 norm3(const XMFLOAT3 &a) {
     return mul3(a, 1.0f / L);
 }
 
-static void ResolveOne(BodyState &A, BodyState &B, const OverlapResult &C, const SolverParams &P) {
-    // 统一法线朝向：A -> B
-    XMFLOAT3 n = C.normal;
-    XMFLOAT3 ab = sub3(C.pointOnB, C.pointOnA);
-    if (dot3(n, ab) < 0) n = mul3(n, -1.0f);
-    n = norm3(n);
-
-    float invA = A.invMass, invB = B.invMass;
-    if (invA + invB == 0.0f) return;
-
-    XMFLOAT3 vRel = sub3(B.v, A.v);
-    float vn = dot3(vRel, n);
-    if (vn < 0.0f) {
-        // 法向冲量
-        float e = std::min(A.restitution, B.restitution);
-        float j = -(1.0f + e) * vn / (invA + invB);
-        A.v = sub3(A.v, mul3(n, j * invA));
-        B.v = add3(B.v, mul3(n, j * invB));
-
-        // 动摩擦（简化版本）
-        vRel = sub3(B.v, A.v);
-        XMFLOAT3 vt = sub3(vRel, mul3(n, dot3(vRel, n)));
-        float vtLen = len3(vt);
-        if (vtLen > 1e-6f) {
-            XMFLOAT3 t = mul3(vt, 1.0f / vtLen);
-            float jt = -dot3(vRel, t) / (invA + invB);
-            float mu = 0.5f * (A.muK + B.muK);
-            float jtMax = mu * j;
-            if (jt > jtMax) jt = jtMax;
-            else if (jt < -jtMax) jt = -jtMax;
-            A.v = sub3(A.v, mul3(t, jt * invA));
-            B.v = add3(B.v, mul3(t, jt * invB));
+// 对 B 施加 +impulse、对 A 施加 -impulse（不可动的一侧不写：静态体被多个岛共享，并行解算时只读）
+static inline void ApplyImpulse(XMFLOAT3 &vA, XMFLOAT3 &vB, float invMassA, float invMassB,
+                                const XMFLOAT3 &impulse) {
+    if (invMassA > 0.0f) vA = sub3(vA, mul3(impulse, invMassA));
+    if (invMassB > 0.0f) vB = add3(vB, mul3(impulse, invMassB));
+}
+
+// 颜色位用尽的接触归入溢出批，溢出批在每次迭代末尾顺序解算
+static constexpr int kMaxColors = 64;
+
+float ContactSolver::solvePoint(Point &pt, XMFLOAT3 &vA, XMFLOAT3 &vB) {
+    // 法向
+    const float vn = dot3(sub3(vB, vA), pt.n);
+    const float oldN = pt.normalImpulse;
+    pt.normalImpulse = std::max(0.0f, oldN + (pt.target - vn) / pt.invMassSum);
+    const float dN = pt.normalImpulse - oldN;
+    if (dN != 0.0f) ApplyImpulse(vA, vB, pt.invMassA, pt.invMassB, mul3(pt.n, dN));
+
+    // 切向（库仑摩擦）
+    const XMFLOAT3 vRel = sub3(vB, vA);
+    const XMFLOAT3 vt = sub3(vRel, mul3(pt.n, dot3(vRel, pt.n)));
+    const XMFLOAT3 oldT = pt.tangentImpulse;
+    XMFLOAT3 newT = sub3(oldT, mul3(vt, 1.0f / pt.invMassSum));
+    const float maxT = pt.mu * pt.normalImpulse;
+    const float lenT = len3(newT);
+    if (lenT > maxT) newT = lenT > 1e-9f ? mul3(newT, maxT / lenT) : XMFLOAT3{0, 0, 0};
+    pt.tangentImpulse = newT;
+    const XMFLOAT3 dT = sub3(newT, oldT);
+    ApplyImpulse(vA, vB, pt.invMassA, pt.invMassB, dT);
+    return std::fabs(dN) + len3(dT);
+}
+
+void ContactSolver::solveIsland(int k, const std::vector<ContactItem> &contacts,
+                                const std::vector<int> &islandStart, const std::vector<int> &islandContacts,
+                                const SolverParams &params) {
+    const int iterations = std::max(0, params.iterations);
+    float *residuals = islandResiduals_.data() + static_cast<size_t>(k) * static_cast<size_t>(iterations);
+    for (int it = 0; it < iterations; ++it) {
+        float residual = 0.0f;
+        for (int j = islandStart[k]; j < islandStart[k + 1]; ++j) {
+            const int i = islandContacts[j];
+            Point &pt = points_[i];
+            if (pt.invMassSum <= 0.0f) continue;
+            residual += solvePoint(pt, velocities_[contacts[i].ia], velocities_[contacts[i].ib]);
         }
+        residuals[it] = residual;
+        islandIterations_[k] = it + 1;
+        if (residual < params.tolerance) break;
     }
+}
 
-    // 位置校正（比例分离）
-    float corr = std::max(0.0f, C.penetration - P.slop) * P.beta;
-    if (corr > 0.0f) {
-        float sumInv = invA + invB;
-        if (sumInv > 0.0f) {
-            A.p = sub3(A.p, mul3(n, corr * (invA / sumInv)));
-            B.p = add3(B.p, mul3(n, corr * (invB / sumInv)));
+void ContactSolver::solveColoredIsland(int k, const std::vector<ContactItem> &contacts,
+                                       const std::vector<int> &islandStart, const std::vector<int> &islandContacts,
+                                       const SolverParams &params, WorkerPool &workers) {
+    const int begin = islandStart[k];
+    const int end = islandStart[k + 1];
+
+    // 贪心着色（按岛内接触顺序）：取两侧动态体都未占用的最小颜色；静态体不参与冲突
+    if (bodyColors_.size() < velocities_.size()) bodyColors_.resize(velocities_.size(), 0);
+    int colors = 0;
+    for (int j = begin; j < end; ++j) {
+        const int i = islandContacts[j];
+        pointResidual_[i] = 0.0f;
+        const Point &pt = points_[i];
+        if (pt.invMassSum <= 0.0f) {
+            contactColor_[i] = -1;
+            continue;
+        }
+        const int ia = contacts[i].ia;
+        const int ib = contacts[i].ib;
+        const bool dynA = pt.invMassA > 0.0f;
+        const bool dynB = pt.invMassB > 0.0f;
+        const uint64_t used = (dynA ? bodyColors_[ia] : 0) | (dynB ? bodyColors_[ib] : 0);
+        const int c = std::countr_one(used); // used 全满时为 64，即溢出批
+        if (c < kMaxColors) {
+            if (dynA) bodyColors_[ia] |= uint64_t{1} << c;
+            if (dynB) bodyColors_[ib] |= uint64_t{1} << c;
+        }
+        contactColor_[i] = c;
+        colors = std::max(colors, c + 1);
+    }
+
+    // 计数排序分批（批内保持岛内顺序），并清掉本岛占用的颜色位
+    colorStart_.assign(static_cast<size_t>(colors) + 1, 0);
+    for (int j = begin; j < end; ++j) {
+        const int c = contactColor_[islandContacts[j]];
+        if (c >= 0) ++colorStart_[static_cast<size_t>(c) + 1];
+    }
+    for (int c = 0; c < colors; ++c) colorStart_[c + 1] += colorStart_[c];
+    colorContacts_.resize(static_cast<size_t>(colorStart_[colors]));
+    colorCursor_.assign(colorStart_.begin(), colorStart_.end() - 1);
+    for (int j = begin; j < end; ++j) {
+        const int i = islandContacts[j];
+        const int c = contactColor_[i];
+        if (c < 0) continue;
+        colorContacts_[colorCursor_[c]++] = i;
+        bodyColors_[contacts[i].ia] = 0;
+        bodyColors_[contacts[i].ib] = 0;
+    }
+    stats_.colorBatches += static_cast<size_t>(colors);
+    if (colors > kMaxColors) {
+        stats_.overflowContacts += static_cast<size_t>(colorStart_[kMaxColors + 1] - colorStart_[kMaxColors]);
+    }
+
+    // 迭代：批与批之间顺序，批内并行；残差按岛内顺序求和，与区间划分无关
+    size_t batchBegin = 0;
+    const WorkerPool::RangeFn batch = [&](int, size_t b, size_t e) {
+        for (size_t j = b; j < e; ++j) {
+            const int i = colorContacts_[batchBegin + j];
+            pointResidual_[i] = solvePoint(points_[i], velocities_[contacts[i].ia], velocities_[contacts[i].ib]);
+        }
+    };
+    const size_t minPerJob = static_cast<size_t>(std::max(1, params.minContactsPerJob));
+    const int iterations = std::max(0, params.iterations);
+    float *residuals = islandResiduals_.data() + static_cast<size_t>(k) * static_cast<size_t>(iterations);
+    for (int it = 0; it < iterations; ++it) {
+        for (int c = 0; c < colors; ++c) {
+            batchBegin = static_cast<size_t>(colorStart_[c]);
+            const size_t n = static_cast<size_t>(colorStart_[c + 1] - colorStart_[c]);
+            if (c == kMaxColors) batch(0, 0, n);
+            else workers.parallelFor(n, minPerJob, batch);
         }
+        float residual = 0.0f;
+        for (int j = begin; j < end; ++j) residual += pointResidual_[islandContacts[j]];
+        residuals[it] = residual;
+        islandIterations_[k] = it + 1;
+        if (residual < params.tolerance) break;
     }
 }
 
 void ContactSolver::solve(std::vector<ContactItem> &contacts,
-                          std::vector<BodyState> &bodies,
-                          const SolverParams &params) {
-    if (contacts.empty()) return;
+                          BodyStore &bodies,
+                          const std::vector<int> &islandStart,
+                          const std::vector<int> &islandContacts,
+                          const SolverParams &params,
+                          float dt,
+                          WorkerPool &workers) {
+    stats_.contactCount = contacts.size();
+    stats_.warmStarted = 0;
+    stats_.iterations = 0;
+    stats_.residuals.clear();
+    stats_.islandTasks = 0;
+    stats_.coloredIslands = 0;
+    stats_.colorBatches = 0;
+    stats_.overflowContacts = 0;
+    stats_.threads = 1;
+    if (contacts.empty() || dt <= 0.0f) {
+        cache_.clear();
+        return;
+    }
+
+    // 1) 预处理：取速度、法线、有效质量、目标法向速度、摩擦系数
+    points_.assign(contacts.size(), Point{});
+    touched_.clear();
+    if (velocities_.size() < bodies.size()) velocities_.resize(bodies.size());
+    const float invDt = 1.0f / dt;
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        const ContactItem &ct = contacts[i];
+        Point &pt = points_[i];
+        pt.invMassA = bodies.invMass[ct.ia];
+        pt.invMassB = bodies.invMass[ct.ib];
+        pt.invMassSum = pt.invMassA + pt.invMassB;
+        if (pt.invMassSum <= 0.0f) continue;
+        pt.n = norm3(ct.c.normal);
+        const XMFLOAT3 vA = velocities_[ct.ia] = bodies.velocity(ct.ia);
+        const XMFLOAT3 vB = velocities_[ct.ib] = bodies.velocity(ct.ib);
+        const BodyState &A = bodies.state[ct.ia];
+        const BodyState &B = bodies.state[ct.ib];
+
+        // 本步已发生的位移（静态体无上一位置，视为 0）
+        const XMFLOAT3 driftA = pt.invMassA > 0.0f
+                                    ? sub3(bodies.position(ct.ia), bodies.prevPosition(ct.ia))
+                                    : XMFLOAT3{0, 0, 0};
+        const XMFLOAT3 driftB = pt.invMassB > 0.0f
+                                    ? sub3(bodies.position(ct.ib), bodies.prevPosition(ct.ib))
+                                    : XMFLOAT3{0, 0, 0};
+        const float vn0 = dot3(sub3(vB, vA), pt.n);
+        pt.target = dot3(sub3(driftB, driftA), pt.n) * invDt +
+                    params.beta * std::max(0.0f, ct.c.penetration - params.slop) * invDt;
+        if (vn0 < -params.restitutionThreshold) {
+            // 恢复系数取参与运动一方的值（双方都动态时取较小者）
+            float e = 1.0f;
+            if (pt.invMassA > 0.0f) e = std::min(e, A.restitution);
+            if (pt.invMassB > 0.0f) e = std::min(e, B.restitution);
+            pt.target = std::max(pt.target, -e * vn0);
+        }
+        pt.mu = std::min(A.muK, B.muK);
+
+        if (pt.invMassA > 0.0f) touched_.push_back(ct.ia);
+        if (pt.invMassB > 0.0f) touched_.push_back(ct.ib);
+    }
+
+    // 2) 暖启动：本步接触按 key 排序后与上一步缓存归并匹配
+    if (params.warmStart && !cache_.empty()) {
+        order_.resize(contacts.size());
+        for (size_t i = 0; i < order_.size(); ++i) order_[i] = static_cast<uint32_t>(i);
+        std::sort(order_.begin(), order_.end(), [&contacts](uint32_t a, uint32_t b) {
+            return contacts[a].key != contacts[b].key ? contacts[a].key < contacts[b].key : a < b;
+        });
+        size_t c = 0;
+        for (uint32_t i: order_) {
+            const uint64_t key = contacts[i].key;
+            while (c < cache_.size() && cache_[c].key < key) ++c;
+            if (c == cache_.size()) break;
+            if (cache_[c].key != key) continue;
+            Point &pt = points_[i];
+            // 法线明显变化（绕过棱角等）时旧冲量不再适用
+            if (pt.invMassSum <= 0.0f || dot3(cache_[c].normal, pt.n) < 0.95f) continue;
+            pt.normalImpulse = cache_[c].normalImpulse;
+            pt.tangentImpulse = cache_[c].tangentImpulse;
+            ApplyImpulse(velocities_[contacts[i].ia], velocities_[contacts[i].ib], pt.invMassA, pt.invMassB,
+                         add3(mul3(pt.n, pt.normalImpulse), pt.tangentImpulse));
+            ++stats_.warmStarted;
+        }
+    }
 
-    // 可选：按穿透深度排序以加快收敛
-    std::stable_sort(contacts.begin(), contacts.end(), [](const ContactItem &a, const ContactItem &b) {
-        return a.c.penetration > b.c.penetration;
+    // 3) 按岛迭代：大岛着色分批（批内并行），其余岛按接触数从大到小作为任务分发
+    const int islands = std::max(0, static_cast<int>(islandStart.size()) - 1);
+    const int iterations = std::max(0, params.iterations);
+    islandIterations_.assign(static_cast<size_t>(islands), 0);
+    islandResiduals_.assign(static_cast<size_t>(islands) * static_cast<size_t>(iterations), 0.0f);
+    contactColor_.resize(contacts.size());
+    pointResidual_.resize(contacts.size());
+    taskIslands_.clear();
+    for (int k = 0; k < islands; ++k) {
+        const int n = islandStart[k + 1] - islandStart[k];
+        if (n == 0) continue;
+        if (n >= std::max(1, params.colorThreshold)) {
+            solveColoredIsland(k, contacts, islandStart, islandContacts, params, workers);
+            ++stats_.coloredIslands;
+        } else {
+            taskIslands_.push_back(k);
+        }
+    }
+    std::stable_sort(taskIslands_.begin(), taskIslands_.end(), [&islandStart](int a, int b) {
+        return islandStart[a + 1] - islandStart[a] > islandStart[b + 1] - islandStart[b];
     });
+    stats_.islandTasks = taskIslands_.size();
+    stats_.threads = std::max(1, workers.runTasks(taskIslands_.size(), [&](int, size_t t) {
+        solveIsland(taskIslands_[t], contacts, islandStart, islandContacts, params);
+    }));
 
-    for (int it = 0; it < params.iterations; ++it) {
-        for (auto &ct: contacts) {
-            BodyState &A = bodies[ct.ia];
-            BodyState &B = bodies[ct.ib];
-            ResolveOne(A, B, ct.c, params);
+    // 汇总收敛曲线（按岛下标顺序累加）
+    for (int k = 0; k < islands; ++k) stats_.iterations = std::max(stats_.iterations, islandIterations_[k]);
+    stats_.residuals.assign(static_cast<size_t>(stats_.iterations), 0.0f);
+    for (int k = 0; k < islands; ++k) {
+        for (int it = 0; it < islandIterations_[k]; ++it) {
+            stats_.residuals[it] += islandResiduals_[static_cast<size_t>(k) * static_cast<size_t>(iterations) + it];
         }
     }
+
+    // 4) 接触中的动态体写回速度，并按解算后的速度从上一位置重新积分
+    std::sort(touched_.begin(), touched_.end());
+    touched_.erase(std::unique(touched_.begin(), touched_.end()), touched_.end());
+    for (int bi: touched_) {
+        const XMFLOAT3 &v = velocities_[bi];
+        bodies.setVelocity(bi, v);
+        bodies.setPosition(bi, add3(bodies.prevPosition(bi), mul3(v, dt)));
+    }
+
+    // 5) 输出并缓存累计冲量（按 key 升序）
+    next_.clear();
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        const Point &pt = points_[i];
+        contacts[i].normalImpulse = pt.normalImpulse;
+        if (pt.invMassSum <= 0.0f) continue;
+        next_.push_back(CachedImpulse{contacts[i].key, pt.n, pt.normalImpulse, pt.tangentImpulse});
+    }
+    std::stable_sort(next_.begin(), next_.end(), [](const CachedImpulse &a, const CachedImpulse &b) {
+        return a.key < b.key;
+    });
+    std::swap(cache_, next_);
 }
@@ -2,25 +2,36 @@
 #pragma execution_character_set("utf-8")
 
 #include <vector>
+#include <cstdint>
 #include <DirectXMath.h>
 #include "Collider.hpp"
+#include "BodyStore.hpp"
+
+class WorkerPool;
 
 // 与 PhysicsWorld 协作的最小联系结构
 struct SolverParams {
-    int iterations = 8; // 冲量迭代次数
+    int iterations = 8; // 冲量迭代次数（上限）
     float slop = 0.01f; // 穿透容差
-    float beta = 0.4f; // 位置校正比例
+    float beta = 0.4f; // 位置校正比例（每步消除超出 slop 的穿透的比例）
+    float restitutionThreshold = 0.5f; // 法向接近速度超过该值才反弹，低速接触直接贴合（避免静止抖动）
+    float tolerance = 1e-4f; // 单次迭代冲量变化总和低于该值时视为收敛，提前结束
+    bool warmStart = true; // 以上一步同一对的累计冲量作为初值
+    int colorThreshold = 256; // 岛内接触数达到该值时按图着色分批并行解算，否则整岛作为一个任务
+    int minContactsPerJob = 64; // 着色批内每个并行区间的最少接触数
 };
 
-// PhysicsWorld 内部用于解算的体状态镜像
-struct BodyState {
-    DirectX::XMFLOAT3 p{0, 0, 0};
-    DirectX::XMFLOAT3 v{0, 0, 0};
-    DirectX::XMFLOAT3 pPrev{0, 0, 0}; // 上一帧位置（用于碰撞回退）
-    float invMass = 1.0f;
-    float restitution = 0.2f;
-    float muS = 0.6f;
-    float muK = 0.5f;
+// 解算统计（每步刷新）
+struct SolverStats {
+    size_t contactCount = 0;
+    size_t warmStarted = 0; // 命中接触缓存的数量
+    int iterations = 0; // 实际迭代次数（各岛的最大值）
+    std::vector<float> residuals; // 每次迭代的冲量变化总和（各岛求和，已收敛的岛记 0）
+    size_t islandTasks = 0; // 整岛作为任务解算的岛数
+    size_t coloredIslands = 0; // 着色分批解算的大岛数
+    size_t colorBatches = 0; // 大岛的着色批数之和
+    size_t overflowContacts = 0; // 颜色位用尽、归入溢出批顺序解算的接触数
+    int threads = 1; // 小岛任务实际参与的线程数
 };
 
 // 单个接触约束（已过滤 trigger）
@@ -30,11 +41,86 @@ struct ContactItem {
     OverlapResult c; // 接触数据（法线、点、穿透）
     ColliderBase *ca = nullptr; // 可选：用于事件/调试
     ColliderBase *cb = nullptr;
+    uint64_t key = 0; // collider 对的键（池 Id），跨帧匹配接触缓存
+    float normalImpulse = 0.0f; // 解算输出：累计法向冲量（> 0 表示发生了碰撞响应）
 };
 
+// 迭代冲量解算器（顺序冲量 + 接触缓存暖启动）
+// - 法线约定与窄相输出一致：c.normal 由 A 指向 B，dot(vB - vA, n) < 0 表示正在接近；
+// - 检测发生在积分后的位置上：目标法向速度保证“上一位置 + v*dt”处穿透不超过 slop（超出部分按 beta 逐步消除），
+//   接近速度超过 restitutionThreshold 时按恢复系数反弹；摩擦为库仑摩擦锥内的切向冲量；
+// - 接触涉及的体的速度先取到 velocities_（按体下标的 AoS），迭代只读写这份，结束后写回 BodyStore；
+// - 解算后接触中的动态体按新速度从上一位置重新积分；
+// - 每对接触的累计法向/切向冲量按 key 缓存到下一步（有序数组，按 key 归并匹配），法线变化较大时丢弃；
+// - 按岛独立迭代（各岛各自判定收敛）：岛 k 的接触为 islandContacts[islandStart[k], islandStart[k+1])。
+//   小岛按接触数从大到小作为任务交给 WorkerPool::runTasks；接触数达到 colorThreshold 的大岛按图着色分批，
+//   同一批内的接触不共享动态体，批内用 parallelFor 并行。是否着色只取决于接触数，结果与线程数无关。
 class ContactSolver {
 public:
     void solve(std::vector<ContactItem> &contacts,
-               std::vector<BodyState> &bodies,
-               const SolverParams &params);
+               BodyStore &bodies,
+               const std::vector<int> &islandStart,
+               const std::vector<int> &islandContacts,
+               const SolverParams &params,
+               float dt,
+               WorkerPool &workers);
+
+    const SolverStats &stats() const { return stats_; }
+
+    // 丢弃接触缓存（世界重置时）
+    void clearCache() { cache_.clear(); }
+
+private:
+    struct CachedImpulse {
+        uint64_t key = 0;
+        DirectX::XMFLOAT3 normal{0, 0, 0};
+        float normalImpulse = 0.0f;
+        DirectX::XMFLOAT3 tangentImpulse{0, 0, 0};
+    };
+
+    // 单个接触的解算数据（与 contacts 一一对应）
+    struct Point {
+        DirectX::XMFLOAT3 n{0, 0, 0};
+        float invMassA = 0.0f;
+        float invMassB = 0.0f;
+        float invMassSum = 0.0f; // 0 表示两侧都不可动，跳过
+        float target = 0.0f; // 目标法向相对速度
+        float mu = 0.0f;
+        float normalImpulse = 0.0f;
+        DirectX::XMFLOAT3 tangentImpulse{0, 0, 0};
+    };
+
+    // 单个接触的一次迭代（法向 + 摩擦），返回冲量变化量
+    static float solvePoint(Point &pt, DirectX::XMFLOAT3 &vA, DirectX::XMFLOAT3 &vB);
+
+    // 顺序迭代整个岛 k
+    void solveIsland(int k, const std::vector<ContactItem> &contacts,
+                     const std::vector<int> &islandStart, const std::vector<int> &islandContacts,
+                     const SolverParams &params);
+
+    // 着色分批迭代大岛 k
+    void solveColoredIsland(int k, const std::vector<ContactItem> &contacts,
+                            const std::vector<int> &islandStart, const std::vector<int> &islandContacts,
+                            const SolverParams &params, WorkerPool &workers);
+
+    std::vector<CachedImpulse> cache_; // 上一步的累计冲量（按 key 升序）
+    std::vector<CachedImpulse> next_;
+    std::vector<Point> points_;
+    std::vector<uint32_t> order_; // 按 key 排序的接触下标（匹配缓存用）
+    std::vector<int> touched_; // 本步需要重新积分的动态体
+    std::vector<DirectX::XMFLOAT3> velocities_; // 解算用速度（按体下标，仅接触涉及的体有效）
+
+    // 按岛迭代
+    std::vector<int> taskIslands_; // 作为任务解算的岛（接触数降序）
+    std::vector<int> islandIterations_; // 各岛实际迭代次数
+    std::vector<float> islandResiduals_; // 岛 k 第 it 次迭代的残差：[k * iterations + it]
+
+    // 图着色（大岛）
+    std::vector<uint64_t> bodyColors_; // 体已占用的颜色位
+    std::vector<int> contactColor_;
+    std::vector<int> colorStart_;
+    std::vector<int> colorContacts_;
+    std::vector<int> colorCursor_;
+    std::vector<float> pointResidual_; // 着色迭代时各接触的残差，按岛内顺序求和（与分区方式无关）
+    SolverStats stats_{};
 };
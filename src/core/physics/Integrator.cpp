@@ -0,0 +1,158 @@
+﻿#include "Integrator.hpp"
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INTEGRATE_SSE2 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+void IntegrateScalar(BodyStore &b, const IntegrateParams &params, size_t begin, size_t end) {
+    const float dt = params.dt;
+    const DirectX::XMFLOAT3 &g = params.gravity;
+    for (size_t i = begin; i < end; ++i) {
+        const float im = b.invMass[i];
+        if (im <= 0.0f || b.asleep[i]) continue; // 静态 / 休眠
+
+        // v += (g + f/m) * dt
+        float vx = b.vx[i] + (g.x + b.fx[i] * im) * dt;
+        float vy = b.vy[i] + (g.y + b.fy[i] * im) * dt;
+        float vz = b.vz[i] + (g.z + b.fz[i] * im) * dt;
+        // clamp speed
+        const float L = std::sqrt(vx * vx + vy * vy + vz * vz);
+        if (L > params.maxSpeed) {
+            const float s = params.maxSpeed / L;
+            vx = vx * s;
+            vy = vy * s;
+            vz = vz * s;
+        }
+        // 保存积分前的位置，p += v*dt
+        b.qx[i] = b.px[i];
+        b.qy[i] = b.py[i];
+        b.qz[i] = b.pz[i];
+        b.px[i] = b.px[i] + vx * dt;
+        b.py[i] = b.py[i] + vy * dt;
+        b.pz[i] = b.pz[i] + vz * dt;
+        b.vx[i] = vx;
+        b.vy[i] = vy;
+        b.vz[i] = vz;
+    }
+}
+
+#if defined(__AVX2__)
+namespace {
+    // 8 体一组；返回处理到的位置
+    size_t IntegrateAvx2(BodyStore &b, const IntegrateParams &params, size_t i, size_t end) {
+        const __m256 dt = _mm256_set1_ps(params.dt);
+        const __m256 gx = _mm256_set1_ps(params.gravity.x);
+        const __m256 gy = _mm256_set1_ps(params.gravity.y);
+        const __m256 gz = _mm256_set1_ps(params.gravity.z);
+        const __m256 maxSpeed = _mm256_set1_ps(params.maxSpeed);
+        const __m256 zero = _mm256_setzero_ps();
+        for (; i + 8 <= end; i += 8) {
+            const __m256 im = _mm256_loadu_ps(&b.invMass[i]);
+            const __m256i sleeping = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&b.asleep[i]));
+            const __m256 active = _mm256_and_ps(
+                _mm256_cmp_ps(im, zero, _CMP_GT_OQ),
+                _mm256_castsi256_ps(_mm256_cmpeq_epi32(sleeping, _mm256_setzero_si256())));
+            if (_mm256_movemask_ps(active) == 0) continue; // 整组静态/休眠
+
+            const __m256 vx0 = _mm256_loadu_ps(&b.vx[i]);
+            const __m256 vy0 = _mm256_loadu_ps(&b.vy[i]);
+            const __m256 vz0 = _mm256_loadu_ps(&b.vz[i]);
+            __m256 vx = _mm256_add_ps(vx0, _mm256_mul_ps(_mm256_add_ps(gx, _mm256_mul_ps(_mm256_loadu_ps(&b.fx[i]), im)), dt));
+            __m256 vy = _mm256_add_ps(vy0, _mm256_mul_ps(_mm256_add_ps(gy, _mm256_mul_ps(_mm256_loadu_ps(&b.fy[i]), im)), dt));
+            __m256 vz = _mm256_add_ps(vz0, _mm256_mul_ps(_mm256_add_ps(gz, _mm256_mul_ps(_mm256_loadu_ps(&b.fz[i]), im)), dt));
+
+            const __m256 L = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)),
+                                                          _mm256_mul_ps(vz, vz)));
+            const __m256 clamp = _mm256_cmp_ps(L, maxSpeed, _CMP_GT_OQ);
+            const __m256 s = _mm256_div_ps(maxSpeed, L);
+            vx = _mm256_blendv_ps(vx, _mm256_mul_ps(vx, s), clamp);
+            vy = _mm256_blendv_ps(vy, _mm256_mul_ps(vy, s), clamp);
+            vz = _mm256_blendv_ps(vz, _mm256_mul_ps(vz, s), clamp);
+
+            const __m256 px = _mm256_loadu_ps(&b.px[i]);
+            const __m256 py = _mm256_loadu_ps(&b.py[i]);
+            const __m256 pz = _mm256_loadu_ps(&b.pz[i]);
+            _mm256_storeu_ps(&b.qx[i], _mm256_blendv_ps(_mm256_loadu_ps(&b.qx[i]), px, active));
+            _mm256_storeu_ps(&b.qy[i], _mm256_blendv_ps(_mm256_loadu_ps(&b.qy[i]), py, active));
+            _mm256_storeu_ps(&b.qz[i], _mm256_blendv_ps(_mm256_loadu_ps(&b.qz[i]), pz, active));
+            _mm256_storeu_ps(&b.px[i], _mm256_blendv_ps(px, _mm256_add_ps(px, _mm256_mul_ps(vx, dt)), active));
+            _mm256_storeu_ps(&b.py[i], _mm256_blendv_ps(py, _mm256_add_ps(py, _mm256_mul_ps(vy, dt)), active));
+            _mm256_storeu_ps(&b.pz[i], _mm256_blendv_ps(pz, _mm256_add_ps(pz, _mm256_mul_ps(vz, dt)), active));
+            _mm256_storeu_ps(&b.vx[i], _mm256_blendv_ps(vx0, vx, active));
+            _mm256_storeu_ps(&b.vy[i], _mm256_blendv_ps(vy0, vy, active));
+            _mm256_storeu_ps(&b.vz[i], _mm256_blendv_ps(vz0, vz, active));
+        }
+        return i;
+    }
+}
+#endif
+
+#if defined(INTEGRATE_SSE2)
+namespace {
+    inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // 4 体一组；返回处理到的位置
+    size_t IntegrateSse2(BodyStore &b, const IntegrateParams &params, size_t i, size_t end) {
+        const __m128 dt = _mm_set1_ps(params.dt);
+        const __m128 gx = _mm_set1_ps(params.gravity.x);
+        const __m128 gy = _mm_set1_ps(params.gravity.y);
+        const __m128 gz = _mm_set1_ps(params.gravity.z);
+        const __m128 maxSpeed = _mm_set1_ps(params.maxSpeed);
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= end; i += 4) {
+            const __m128 im = _mm_loadu_ps(&b.invMass[i]);
+            const __m128i sleeping = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&b.asleep[i]));
+            const __m128 active = _mm_and_ps(_mm_cmpgt_ps(im, zero),
+                                             _mm_castsi128_ps(_mm_cmpeq_epi32(sleeping, _mm_setzero_si128())));
+            if (_mm_movemask_ps(active) == 0) continue; // 整组静态/休眠
+
+            const __m128 vx0 = _mm_loadu_ps(&b.vx[i]);
+            const __m128 vy0 = _mm_loadu_ps(&b.vy[i]);
+            const __m128 vz0 = _mm_loadu_ps(&b.vz[i]);
+            __m128 vx = _mm_add_ps(vx0, _mm_mul_ps(_mm_add_ps(gx, _mm_mul_ps(_mm_loadu_ps(&b.fx[i]), im)), dt));
+            __m128 vy = _mm_add_ps(vy0, _mm_mul_ps(_mm_add_ps(gy, _mm_mul_ps(_mm_loadu_ps(&b.fy[i]), im)), dt));
+            __m128 vz = _mm_add_ps(vz0, _mm_mul_ps(_mm_add_ps(gz, _mm_mul_ps(_mm_loadu_ps(&b.fz[i]), im)), dt));
+
+            const __m128 L = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)),
+                                                    _mm_mul_ps(vz, vz)));
+            const __m128 clamp = _mm_cmpgt_ps(L, maxSpeed);
+            const __m128 s = _mm_div_ps(maxSpeed, L);
+            vx = Select(clamp, _mm_mul_ps(vx, s), vx);
+            vy = Select(clamp, _mm_mul_ps(vy, s), vy);
+            vz = Select(clamp, _mm_mul_ps(vz, s), vz);
+
+            const __m128 px = _mm_loadu_ps(&b.px[i]);
+            const __m128 py = _mm_loadu_ps(&b.py[i]);
+            const __m128 pz = _mm_loadu_ps(&b.pz[i]);
+            _mm_storeu_ps(&b.qx[i], Select(active, px, _mm_loadu_ps(&b.qx[i])));
+            _mm_storeu_ps(&b.qy[i], Select(active, py, _mm_loadu_ps(&b.qy[i])));
+            _mm_storeu_ps(&b.qz[i], Select(active, pz, _mm_loadu_ps(&b.qz[i])));
+            _mm_storeu_ps(&b.px[i], Select(active, _mm_add_ps(px, _mm_mul_ps(vx, dt)), px));
+            _mm_storeu_ps(&b.py[i], Select(active, _mm_add_ps(py, _mm_mul_ps(vy, dt)), py));
+            _mm_storeu_ps(&b.pz[i], Select(active, _mm_add_ps(pz, _mm_mul_ps(vz, dt)), pz));
+            _mm_storeu_ps(&b.vx[i], Select(active, vx, vx0));
+            _mm_storeu_ps(&b.vy[i], Select(active, vy, vy0));
+            _mm_storeu_ps(&b.vz[i], Select(active, vz, vz0));
+        }
+        return i;
+    }
+}
+#endif
+
+void IntegrateSimd(BodyStore &b, const IntegrateParams &params, size_t begin, size_t end) {
+    size_t i = begin;
+#if defined(__AVX2__)
+    i = IntegrateAvx2(b, params, i, end);
+#endif
+#if defined(INTEGRATE_SSE2)
+    i = IntegrateSse2(b, params, i, end);
+#endif
+    IntegrateScalar(b, params, i, end);
+}
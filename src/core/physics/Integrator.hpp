@@ -0,0 +1,20 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <DirectXMath.h>
+#include "BodyStore.hpp"
+
+// 积分参数
+struct IntegrateParams {
+    DirectX::XMFLOAT3 gravity{0, -9.8f, 0};
+    float maxSpeed = 50.0f;
+    float dt = 0.0f;
+};
+
+// 半隐式欧拉积分 [begin, end) 内醒着的动态体（静态/休眠体不变）：
+//   q = p；v += (g + f * invMass) * dt；|v| 超过 maxSpeed 时等比缩到 maxSpeed；p += v * dt
+// IntegrateScalar 为逐体的参考实现；IntegrateSimd 每次处理 4 个体（SSE2），编译器开启 AVX2 时每次 8 个，
+// 尾部不足一组的体走参考实现。两者逐项运算顺序相同，不做乘加融合时结果逐位一致。
+void IntegrateScalar(BodyStore &bodies, const IntegrateParams &params, size_t begin, size_t end);
+
+void IntegrateSimd(BodyStore &bodies, const IntegrateParams &params, size_t begin, size_t end);
@@ -0,0 +1,70 @@
+﻿#include "PairTable.hpp"
+
+bool PairTable::insert(uint64_t key, uint32_t value) {
+    if ((size_ + 1) * 2 > slots_.size()) {
+        rehash(slots_.empty() ? 64 : slots_.size() * 2);
+    }
+    size_t i = slotFor(key);
+    while (true) {
+        Slot &s = slots_[i];
+        if (s.key == key) {
+            s.value = value;
+            return false;
+        }
+        if (s.key == EmptyKey) {
+            s.key = key;
+            s.value = value;
+            ++size_;
+            return true;
+        }
+        i = (i + 1) & mask_;
+    }
+}
+
+bool PairTable::erase(uint64_t key) {
+    if (slots_.empty()) return false;
+    size_t i = slotFor(key);
+    while (true) {
+        if (slots_[i].key == EmptyKey) return false;
+        if (slots_[i].key == key) break;
+        i = (i + 1) & mask_;
+    }
+
+    // 后移回填：把后续探测链上“理想位置不在 (hole, j] 区间内”的槽位前移
+    size_t hole = i;
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask_;
+        if (slots_[j].key == EmptyKey) break;
+        const size_t ideal = slotFor(slots_[j].key);
+        const bool between = (hole <= j) ? (hole < ideal && ideal <= j) : (hole < ideal || ideal <= j);
+        if (between) continue;
+        slots_[hole] = slots_[j];
+        hole = j;
+    }
+    slots_[hole] = Slot{};
+    --size_;
+    return true;
+}
+
+void PairTable::clear() {
+    if (size_ == 0) return;
+    for (auto &s: slots_) s = Slot{};
+    size_ = 0;
+}
+
+void PairTable::reserve(size_t count) {
+    size_t cap = 64;
+    while (cap < count * 2) cap *= 2;
+    if (cap > slots_.size()) rehash(cap);
+}
+
+void PairTable::rehash(size_t newCapacity) {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(newCapacity, Slot{});
+    mask_ = newCapacity - 1;
+    size_ = 0;
+    for (const auto &s: old) {
+        if (s.key != EmptyKey) insert(s.key, s.value);
+    }
+}
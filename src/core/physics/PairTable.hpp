@@ -0,0 +1,70 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 扁平开放寻址表：64 位键 → 32 位值（用于重叠对去重/索引）
+// 设计要点：
+// - 线性探测，容量恒为 2 的幂，负载因子上限 1/2；
+// - 删除采用后移回填（backward shift），无墓碑，查找链始终紧凑；
+// - 键 EmptyKey 保留为空槽标记（代理 id 均非负，打包后的键不会等于它）。
+class PairTable {
+public:
+    static constexpr uint64_t EmptyKey = ~0ull;
+
+    // 查找：命中返回值指针，否则返回 nullptr
+    const uint32_t *find(uint64_t key) const {
+        if (slots_.empty()) return nullptr;
+        size_t i = slotFor(key);
+        while (true) {
+            const Slot &s = slots_[i];
+            if (s.key == key) return &s.value;
+            if (s.key == EmptyKey) return nullptr;
+            i = (i + 1) & mask_;
+        }
+    }
+
+    bool contains(uint64_t key) const { return find(key) != nullptr; }
+
+    // 插入或覆盖；返回 true 表示新插入
+    bool insert(uint64_t key, uint32_t value);
+
+    // 删除；返回 true 表示键存在并已删除
+    bool erase(uint64_t key);
+
+    // 清空但保留容量（每帧重复使用时无需重新分配）
+    void clear();
+
+    void reserve(size_t count);
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // 有序对打包为键（a、b 为非负 id，与顺序无关）
+    static uint64_t makeKey(int32_t a, int32_t b) {
+        if (a > b) { const int32_t t = a; a = b; b = t; }
+        return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+    }
+
+private:
+    struct Slot {
+        uint64_t key = EmptyKey;
+        uint32_t value = 0;
+    };
+
+    size_t slotFor(uint64_t key) const {
+        // 64 位混合（splitmix64 末段），避免相邻 id 聚集到同一探测链
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return static_cast<size_t>(key) & mask_;
+    }
+
+    void rehash(size_t newCapacity);
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+};
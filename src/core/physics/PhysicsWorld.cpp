@@ -1,5 +1,8 @@
 ﻿#include "PhysicsWorld.hpp"
+#include "Integrator.hpp"
+#include "ShapeCast.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <tuple>
 
@@ -11,7 +14,37 @@ static inline XMFLOAT3 mul3(const XMFLOAT3 &a, float s) { return {a.x * s, a.y *
 static inline float dot3(const XMFLOAT3 &a, const XMFLOAT3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
 static inline float len3(const XMFLOAT3 &a) { return std::sqrt(std::max(0.0f, dot3(a, a))); }
 
-void PhysicsWorld::setParams(const WorldParams &p) { params_ = p; }
+PhysicsWorld::PhysicsWorld() : PhysicsWorld(WorldParams{}) {
+}
+
+PhysicsWorld::PhysicsWorld(const WorldParams &p) : params_(p) {
+    broadphase_ = MakeBroadPhase(params_.broadPhase, params_.broadPhaseCellSize);
+    workers_ = std::make_unique<WorkerPool>(params_.narrowPhaseThreads);
+}
+
+void PhysicsWorld::setParams(const WorldParams &p) {
+    const WorldParams prev = params_;
+    params_ = p;
+    if (p.narrowPhaseThreads != prev.narrowPhaseThreads) {
+        workers_ = std::make_unique<WorkerPool>(params_.narrowPhaseThreads);
+    }
+    if (p.layerMatrix != prev.layerMatrix) {
+        for (const auto &cr: colliderRecs_) {
+            if (cr.collider && cr.proxy != IBroadPhase::InvalidProxy) {
+                broadphase_->setProxyFilter(cr.proxy, filterOf(cr.collider));
+            }
+        }
+    }
+    if (p.broadPhase == prev.broadPhase && p.broadPhaseCellSize == prev.broadPhaseCellSize) return;
+    if (pool_.size() == 0) {
+        // 尚无代理：可安全切换策略
+        broadphase_ = MakeBroadPhase(params_.broadPhase, params_.broadPhaseCellSize);
+    } else {
+        // 已有代理：保持原策略，参数回写为实际生效的值
+        params_.broadPhase = prev.broadPhase;
+        params_.broadPhaseCellSize = prev.broadPhaseCellSize;
+    }
+}
 
 void PhysicsWorld::registerEntity(EntityId e, RigidBody *rb, std::span<ColliderBase *> cols) {
     // 为该实体分配/获取 body 索引：
@@ -23,15 +56,15 @@ void PhysicsWorld::registerEntity(EntityId e, RigidBody *rb, std::span<ColliderB
         if (idx < 0) {
             idx = static_cast<int>(bodies_.size());
             BodyState bs{};
-            bs.p = rb->position;
-            bs.v = rb->velocity;
-            bs.invMass = rb->invMass;
             bs.restitution = rb->restitution>0?rb->restitution:params().defaultRestitution;
             bs.muS = rb->muS>0?rb->muS:params().frictionCoefficient;
             bs.muK = rb->muK>0?rb->muK:params().frictionCoefficient;
-            bodies_.push_back(bs);
+            bs.pSynced = rb->position;
+            bs.ccd = rb->ccd;
+            bodies_.push(bs, rb->position, rb->velocity, rb->invMass);
             bodyRefs_.push_back(rb);
             collidersByBody_.emplace_back();
+            bodyOwner_.push_back(e);
             rb->bodyIdx = idx;
         }
     } else {
@@ -41,96 +74,185 @@ void PhysicsWorld::registerEntity(EntityId e, RigidBody *rb, std::span<ColliderB
         // 若该实体有 collider，可从第一个 collider 的 Owner 世界位置取初始位置，否则默认 (0,0,0)
         DirectX::XMFLOAT3 p0{0, 0, 0};
         if (!cols.empty() && cols[0]) p0 = cols[0]->ownerWorldPosition();
-        bs.p = p0;
-        bs.v = DirectX::XMFLOAT3{0, 0, 0};
-        bs.invMass = 0.0f; // 静态
-        bodies_.push_back(bs);
+        bs.pSynced = p0;
+        bodies_.push(bs, p0, DirectX::XMFLOAT3{0, 0, 0}, 0.0f); // 静态
         bodyRefs_.push_back(nullptr); // 无写回目标
         collidersByBody_.emplace_back();
+        bodyOwner_.push_back(e);
     }
 
-    entity2bodyIdx_[e] = idx;
+    // 实体记录（重复注册时沿用已有记录，collider 追加）
+    uint32_t slot = entityIndex_.find(e);
+    if (slot == SparseIndex::Invalid) {
+        slot = static_cast<uint32_t>(entityRecs_.size());
+        entityRecs_.emplace_back();
+        entityRecs_.back().id = e;
+        entityIndex_.set(e, slot);
+    }
+    EntityRecord &rec = entityRecs_[slot];
+    rec.body = idx;
 
     // 绑定 Colliders
-    auto &list = entity2colliders_[e];
     for (auto *c: cols) {
         if (!c) continue;
-        colliders_.push_back(c);
-        col2bodyIdx_[c] = idx;
-        col2entity_[c] = e;
-        list.push_back(c);
+        rec.colliders.push_back(c);
         collidersByBody_[idx].push_back(c);
+        const ColliderPool::Id id = pool_.add(c);
         // 立即同步 BodyState 世界位置到 Collider 的 Owner 世界位置（世界由 Owner 决定）
-        if (rb) {
-            c->setOwnerWorldPosition(bodies_[idx].p);
-            c->updateDerived();
+        if (rb) c->setOwnerWorldPosition(bodies_.position(idx));
+        if (id >= colliderRecs_.size()) colliderRecs_.resize(static_cast<size_t>(id) + 1);
+        ColliderRecord &cr = colliderRecs_[id];
+        cr.collider = c;
+        cr.entity = e;
+        cr.body = idx;
+        cr.proxy = broadphase_->addProxy(c, c->aabb(), c->isStatic(), filterOf(c));
+        cr.dynamicSlot = -1;
+        if (!c->isStatic()) {
+            cr.dynamicSlot = static_cast<int32_t>(dynamicColliders_.size());
+            dynamicColliders_.push_back(id);
         }
     }
+    // 给休眠体追加碰撞体：唤醒其岛（新碰撞体还不在查询快照中，休眠期间无法被 wakeBodiesTouching 找到）
+    if (rb) wakeBody(idx);
+}
+
+void PhysicsWorld::refreshCollisionFilter(EntityId e) {
+    const uint32_t slot = entityIndex_.find(e);
+    if (slot == SparseIndex::Invalid) return;
+    for (auto *c: entityRecs_[slot].colliders) {
+        const ColliderRecord &cr = colliderRecs_[c->poolId()];
+        if (cr.proxy != IBroadPhase::InvalidProxy) broadphase_->setProxyFilter(cr.proxy, filterOf(c));
+        if (cr.body >= 0 && bodies_.asleep[cr.body]) querySleepingDirty_ = true; // 快照条目带有 layer
+    }
+}
+
+CollisionFilter PhysicsWorld::filterOf(const ColliderBase *c) const {
+    CollisionFilter f{};
+    f.layer = c->layer();
+    uint32_t allowed = 0;
+    for (uint32_t bits = f.layer, i = 0; bits != 0; bits >>= 1, ++i) {
+        if (bits & 1u) allowed |= params_.layerMatrix[i];
+    }
+    f.mask = c->collisionMask() & allowed;
+    return f;
 }
 
 void PhysicsWorld::unregisterEntity(EntityId e) {
-    auto itE = entity2colliders_.find(e);
-    if (itE == entity2colliders_.end()) return;
+    const uint32_t slot = entityIndex_.find(e);
+    if (slot == SparseIndex::Invalid) return;
+    const int bidx = entityRecs_[slot].body;
 
     // 移除该实体的 colliders
-    auto &cols = itE->second;
-    for (auto *c: cols) {
-        // 从 colliders_ 移除
-        colliders_.erase(std::remove(colliders_.begin(), colliders_.end(), c), colliders_.end());
-        // 从 body列表 移除
-        auto itB = col2bodyIdx_.find(c);
-        if (itB != col2bodyIdx_.end()) {
-            int bidx = itB->second;
-            auto &byBody = collidersByBody_[bidx];
+    for (auto *c: entityRecs_[slot].colliders) {
+        // 靠在该 collider 上的休眠体需要重新下落
+        wakeBodiesTouching(c->aabb());
+        const ColliderPool::Id id = c->poolId();
+        ColliderRecord &cr = colliderRecs_[id];
+        // 从 body列表 移除（每个体只有少量 collider）
+        if (cr.body >= 0 && cr.body < static_cast<int>(collidersByBody_.size())) {
+            auto &byBody = collidersByBody_[cr.body];
             byBody.erase(std::remove(byBody.begin(), byBody.end(), c), byBody.end());
         }
-        // 清理映射
-        col2bodyIdx_.erase(c);
-        col2entity_.erase(c);
+        // 移出广相（其参与的重叠对一并移除）
+        if (cr.proxy != IBroadPhase::InvalidProxy) broadphase_->removeProxy(cr.proxy);
+        if (cr.dynamicSlot >= 0) {
+            const ColliderPool::Id moved = dynamicColliders_.back();
+            dynamicColliders_[cr.dynamicSlot] = moved;
+            colliderRecs_[moved].dynamicSlot = cr.dynamicSlot;
+            dynamicColliders_.pop_back();
+            if (cr.body >= 0 && bodies_.asleep[cr.body]) querySleepingDirty_ = true;
+        }
+        cr = ColliderRecord{};
+        // 解绑 SoA 池（Owner 位置取回到 collider 自身），池 Id 随后可被复用
+        pool_.remove(id);
+    }
+
+    // 实体记录：末尾换入空位
+    const uint32_t lastSlot = static_cast<uint32_t>(entityRecs_.size()) - 1;
+    if (slot != lastSlot) {
+        entityRecs_[slot] = std::move(entityRecs_[lastSlot]);
+        entityIndex_.set(entityRecs_[slot].id, slot);
     }
-    cols.clear();
-    entity2colliders_.erase(itE);
+    entityRecs_.pop_back();
+    entityIndex_.erase(e);
 
     // 如果该实体对应的 body 不再被任何 collider 引用，则删除该 body（保持稠密数组）
-    auto itBI = entity2bodyIdx_.find(e);
-    if (itBI != entity2bodyIdx_.end()) {
-        int bidx = itBI->second;
-        entity2bodyIdx_.erase(itBI);
-
-        bool referenced = false;
-        for (auto &kv: col2bodyIdx_) {
-            if (kv.second == bidx) {
-                referenced = true;
-                break;
-            }
+    if (bidx >= 0 && bidx < static_cast<int>(bodies_.size()) && collidersByBody_[bidx].empty()) {
+        // 刚体不再对应任何体（之后若重新注册则新建）
+        if (RigidBody *rb = bodyRefs_[bidx]) rb->bodyIdx = -1;
+        if (batchDepth_ > 0) {
+            // 批量中：只断开写回，压缩推迟到 commitBatch
+            bodyRefs_[bidx] = nullptr;
+            deadBodies_.push_back(bidx);
+        } else {
+            removeBody(bidx);
         }
-        if (!referenced && bidx >= 0 && bidx < static_cast<int>(bodies_.size())) {
-            // 交换到末尾并弹出
-            int last = static_cast<int>(bodies_.size()) - 1;
-            if (bidx != last) {
-                std::swap(bodies_[bidx], bodies_[last]);
-                std::swap(bodyRefs_[bidx], bodyRefs_[last]);
-                std::swap(collidersByBody_[bidx], collidersByBody_[last]);
-
-                // 更新交换后体的 bodyIdx 与所有映射到 last 的 collider 的体索引
-                RigidBody *swappedRb = bodyRefs_[bidx];
-                if (swappedRb) swappedRb->bodyIdx = bidx;
-                for (auto *c: collidersByBody_[bidx]) {
-                    col2bodyIdx_[c] = bidx;
-                }
-                // 同时需要更新与该体绑定的实体的 entity2bodyIdx_
-                if (!collidersByBody_[bidx].empty()) {
-                    auto *c0 = collidersByBody_[bidx][0];
-                    auto itEnt = col2entity_.find(c0);
-                    if (itEnt != col2entity_.end()) entity2bodyIdx_[itEnt->second] = bidx;
-                }
-            }
+    }
+}
 
-            bodies_.pop_back();
-            bodyRefs_.pop_back();
-            collidersByBody_.pop_back();
+void PhysicsWorld::removeBody(int bidx) {
+    if (bodies_.asleep[bidx]) {
+        unlinkSleeping(bidx);
+        --sleepingCount_;
+    }
+    // 交换到末尾并弹出
+    const int last = static_cast<int>(bodies_.size()) - 1;
+    if (bidx != last) {
+        bodies_.swap(bidx, last);
+        // 换入的体若在休眠岛中，链表邻居改指新下标（单体岛自环）
+        BodyState &moved = bodies_.state[bidx];
+        if (moved.sleepNext >= 0) {
+            if (moved.sleepNext == last) moved.sleepNext = bidx;
+            if (moved.sleepPrev == last) moved.sleepPrev = bidx;
+            bodies_.state[moved.sleepNext].sleepPrev = bidx;
+            bodies_.state[moved.sleepPrev].sleepNext = bidx;
+        }
+        std::swap(bodyRefs_[bidx], bodyRefs_[last]);
+        std::swap(collidersByBody_[bidx], collidersByBody_[last]);
+        std::swap(bodyOwner_[bidx], bodyOwner_[last]);
+
+        // 更新交换后体的 bodyIdx、其 collider 记录与引用该体的实体记录
+        RigidBody *swappedRb = bodyRefs_[bidx];
+        if (swappedRb) swappedRb->bodyIdx = bidx;
+        auto retarget = [this, last, bidx](EntityId owner) {
+            EntityRecord *er = findEntity(owner);
+            if (er && er->body == last) er->body = bidx;
+        };
+        for (auto *c: collidersByBody_[bidx]) {
+            ColliderRecord &cr = record(c);
+            cr.body = bidx;
+            retarget(cr.entity);
         }
+        retarget(bodyOwner_[bidx]);
     }
+
+    bodies_.pop_back();
+    bodyRefs_.pop_back();
+    collidersByBody_.pop_back();
+    bodyOwner_.pop_back();
+}
+
+void PhysicsWorld::beginBatch() {
+    if (batchDepth_++ == 0) broadphase_->beginBatch();
+}
+
+void PhysicsWorld::commitBatch() {
+    if (batchDepth_ <= 0 || --batchDepth_ > 0) return;
+
+    // 空体从大到小压缩：换入的末尾体必定存活（更大的空体已先弹出），已有下标不失效
+    std::sort(deadBodies_.begin(), deadBodies_.end(), std::greater<int>());
+    deadBodies_.erase(std::unique(deadBodies_.begin(), deadBodies_.end()), deadBodies_.end());
+    for (int bidx: deadBodies_) {
+        if (bidx < static_cast<int>(bodies_.size()) && collidersByBody_[bidx].empty()) removeBody(bidx);
+    }
+    deadBodies_.clear();
+
+    broadphase_->endBatch();
+}
+
+PhysicsWorld::EntityRecord *PhysicsWorld::findEntity(EntityId e) {
+    const uint32_t slot = entityIndex_.find(e);
+    return slot != SparseIndex::Invalid ? &entityRecs_[slot] : nullptr;
 }
 
 uint64_t PhysicsWorld::PairKey(EntityId a, EntityId b) {
@@ -155,363 +277,672 @@ void PhysicsWorld::step(float dt) {
     // }
     // syncBackAndDispatch(dt);
 
-    // 移除substep,在非CCD下无必要,并且只有最后一步的currTriggers_会被派发
+    // 移除substep,在非CCD下无必要,并且只有最后一步的接触会被派发
     // 这导致了只有运动响应但是没有事件的问题
 
+    pullBodyInputs();
     integrate(dt);
+    selectCcdBodies();
     syncBodiesToColliders();
     broadPhase();
     narrowPhase();
-    solveContacts();
+    continuousCollision();
+    wakeTouchedSleepers();
+    buildIslands();
+    solveContacts(dt);
+    updateSleep();
     positionalCorrection();
     syncBackAndDispatch(dt);
-
+    buildQuerySnapshot();
 
 }
 
 void PhysicsWorld::syncOwnerTransform(EntityId e,
                                       const DirectX::XMFLOAT3 &posW,
-                                      const DirectX::XMFLOAT3 &rotEulerW,
+                                      const DirectX::XMFLOAT4 &rotW,
                                       bool resetVelocityOnChange) {
     // 找到该实体的 body 索引
-    auto itB = entity2bodyIdx_.find(e);
-    if (itB == entity2bodyIdx_.end()) return;
-    int bidx = itB->second;
+    const EntityRecord *er = findEntity(e);
+    if (!er) return;
+    int bidx = er->body;
     if (bidx < 0 || bidx >= static_cast<int>(bodies_.size())) return;
 
-    auto &bs = bodies_[bidx];
+    BodyState &bs = bodies_.state[bidx];
     const float eps = GetPhysicsConfig().epsilon;
     auto diff = [](const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b) -> DirectX::XMFLOAT3 {
         return DirectX::XMFLOAT3{a.x - b.x, a.y - b.y, a.z - b.z};
     };
-    DirectX::XMFLOAT3 d = diff(bs.p, posW);
+    DirectX::XMFLOAT3 d = diff(bodies_.position(bidx), posW);
     bool posDifferent = (std::fabs(d.x) > eps) || (std::fabs(d.y) > eps) || (std::fabs(d.z) > eps);
 
     if (posDifferent) {
         // 覆盖 BodyState 位置
-        bs.p = posW;
+        bodies_.setPosition(bidx, posW);
+        bs.pSynced = posW;
         if (resetVelocityOnChange) {
-            bs.v = DirectX::XMFLOAT3{0, 0, 0};
+            bodies_.setVelocity(bidx, DirectX::XMFLOAT3{0, 0, 0});
         }
         // 写回 RigidBody 镜像
         if (bidx < static_cast<int>(bodyRefs_.size())) {
             if (RigidBody *rb = bodyRefs_[bidx]) {
-                rb->position = bs.p;
-                if (resetVelocityOnChange) rb->velocity = bs.v;
+                rb->position = posW;
+                if (resetVelocityOnChange) rb->velocity = DirectX::XMFLOAT3{0, 0, 0};
             }
         }
     }
 
-    // 无论是否位置改变，都将 Owner 的朝向写入 collider；位置若改变也同步位置
+    // 无论是否位置改变，都将 Owner 的朝向写入 collider（朝向未变时 collider 内部跳过重建）；位置若改变也同步位置
+    // 仅在位姿实际变化时登记为脏代理
+    // 位姿被外部改动：动态体唤醒其所在的岛；静态体唤醒旧、新位置上靠着它的休眠体
+    const bool isDynamic = bodies_.isDynamic(bidx);
+    bool anyMoved = false;
     if (bidx < static_cast<int>(collidersByBody_.size())) {
         for (auto *c: collidersByBody_[bidx]) {
             if (!c) continue;
-            if (posDifferent) c->setOwnerWorldPosition(bs.p);
-            c->setOwnerWorldRotationEuler(rotEulerW);
-            c->updateDerived();
+            const DirectX::XMFLOAT4 r = c->ownerWorldRotation();
+            bool rotDifferent = (std::fabs(r.x - rotW.x) > eps) || (std::fabs(r.y - rotW.y) > eps) ||
+                                (std::fabs(r.z - rotW.z) > eps) || (std::fabs(r.w - rotW.w) > eps);
+            const bool moved = posDifferent || rotDifferent;
+            const Aabb oldBox = c->aabb();
+            // 写入位姿时池中该槽位的中心/AABB 立即刷新，之后 aabb() 即新位姿
+            if (posDifferent) c->setOwnerWorldPosition(posW);
+            c->setOwnerWorldRotation(rotW);
+            if (!moved) continue;
+            anyMoved = true;
+            dirtyProxies_.push_back(record(c).proxy);
+            if (!isDynamic) {
+                wakeBodiesTouching(oldBox);
+                wakeBodiesTouching(c->aabb());
+            }
         }
     }
+    if (anyMoved && isDynamic) wakeBody(bidx);
 }
 
 void PhysicsWorld::integrate(float dt) {
-    for (size_t i = 0; i < bodies_.size(); ++i) {
-        auto &b = bodies_[i];
-        if (b.invMass <= 0.0f) continue; // 静态
-
-        // 保存积分前的位置（用于碰撞回退）
-        b.pPrev = b.p;
-
-        // v += g*dt
-        b.v = add3(b.v, mul3(params_.gravity, dt));
-        // clamp speed
-        float L = len3(b.v);
-        if (L > params_.maxSpeed) {
-            float s = params_.maxSpeed / L;
-            b.v = mul3(b.v, s);
-        }
-        // p += v*dt
-        b.p = add3(b.p, mul3(b.v, dt));
+    // 重力 + 外力、限速，保存积分前位置（解算后从这里重新积分）；静态/休眠体跳过
+    IntegrateParams ip{};
+    ip.gravity = params_.gravity;
+    ip.maxSpeed = params_.maxSpeed;
+    ip.dt = dt;
+    if (params_.vectorizedIntegrate) IntegrateSimd(bodies_, ip, 0, bodies_.size());
+    else IntegrateScalar(bodies_, ip, 0, bodies_.size());
+}
+
+bool PhysicsWorld::syncBodyColliders(size_t i) {
+    BodyState &bs = bodies_.state[i];
+    const XMFLOAT3 p = bodies_.position(i);
+    // 精确比较：只要位置有任何变化就必须同步，否则 AABB 与 BodyState 会不一致
+    if (p.x == bs.pSynced.x && p.y == bs.pSynced.y && p.z == bs.pSynced.z) return false;
+    bs.pSynced = p;
+    if (i >= collidersByBody_.size()) return true;
+    const bool isDynamic = bodies_.isDynamic(i);
+    for (auto *c: collidersByBody_[i]) {
+        if (!c) continue;
+        pool_.writeOwnerPosition(c->poolId(), p);
+        if (!isDynamic) continue; // 非动态体的位姿变化由 syncOwnerTransform 登记
+        dirtyProxies_.push_back(record(c).proxy);
     }
+    return true;
 }
 
 // 在进行广相/窄相前，将 BodyState 的位置写回到对应的 Collider，刷新 AABB
 void PhysicsWorld::syncBodiesToColliders() {
-    // 遍历每个刚体，将镜像位置 p 写回其绑定的所有 Collider
-    const size_t count = bodies_.size();
-    for (size_t i = 0; i < count; ++i) {
-        const XMFLOAT3 p = bodies_[i].p;
-        if (i >= collidersByBody_.size()) continue;
-        auto &cols = collidersByBody_[i];
-        for (auto *c: cols) {
-            if (!c) continue;
-            c->setOwnerWorldPosition(p);
-            c->updateDerived();
-        }
+    // 仅位置有变化的体写入池中其绑定的 Collider（静止/静态体跳过），再批量刷新派生量
+    bool any = false;
+    for (size_t i = 0; i < bodies_.size(); ++i) {
+        if (syncBodyColliders(i)) any = true;
     }
+    if (any) pool_.updateDerived();
 }
 
 void PhysicsWorld::broadPhase() {
-    pairs_.clear();
-
-    const size_t n = colliders_.size();
-    if (n == 0) return;
-
-    // 小规模时直接使用 O(n^2) 便于省去常数开销
-    if (n <= 8) {
-        overlapAll(colliders_, pairs_);
-        return;
+    bpStats_.proxiesUpdated = 0;
+
+    // 只刷新位姿有变化的代理：移动过的动态体 + 外部改动过位姿的实体（传送/转向）
+    // 同一代理可能被多处登记，排序去重后按 id 顺序更新（与登记顺序无关）
+    std::sort(dirtyProxies_.begin(), dirtyProxies_.end());
+    dirtyProxies_.erase(std::unique(dirtyProxies_.begin(), dirtyProxies_.end()), dirtyProxies_.end());
+    for (auto id: dirtyProxies_) {
+        ColliderBase *c = broadphase_->collider(id);
+        if (!c) continue;
+        Aabb box = c->aabb();
+        // CCD 体：AABB 扩展到整段位移，候选对覆盖扫掠范围
+        const int bidx = record(c).body;
+        if (bidx >= 0 && bodies_.state[bidx].ccdSlot >= 0) {
+            const XMFLOAT3 d = sub3(bodies_.position(bidx), bodies_.prevPosition(bidx));
+            box.min = XMFLOAT3{std::min(box.min.x, box.min.x - d.x), std::min(box.min.y, box.min.y - d.y),
+                               std::min(box.min.z, box.min.z - d.z)};
+            box.max = XMFLOAT3{std::max(box.max.x, box.max.x - d.x), std::max(box.max.y, box.max.y - d.y),
+                               std::max(box.max.z, box.max.z - d.z)};
+        }
+        broadphase_->updateProxy(id, box);
+        ++bpStats_.proxiesUpdated;
     }
+    dirtyProxies_.clear();
 
-    struct BoxItem {
-        ColliderBase *c;
-        float minX, maxX, minY, maxY, minZ, maxZ;
-    };
+    broadphase_->computePairs(pairs_, bpStats_);
 
-    std::vector<BoxItem> items;
-    items.reserve(n);
-    for (auto *c: colliders_) {
-        if (!c) continue;
-        Aabb b = c->aabb();
-        // 规范化（确保 min <= max）
-        float mnx = std::min(b.min.x, b.max.x);
-        float mny = std::min(b.min.y, b.max.y);
-        float mnz = std::min(b.min.z, b.max.z);
-        float mxx = std::max(b.min.x, b.max.x);
-        float mxy = std::max(b.min.y, b.max.y);
-        float mxz = std::max(b.min.z, b.max.z);
-        items.push_back(BoxItem{c, mnx, mxx, mny, mxy, mnz, mxz});
-    }
-
-    // 按 minX 排序（Sweep & Prune 单轴）
-    std::sort(items.begin(), items.end(), [](const BoxItem &a, const BoxItem &b) {
-        if (a.minX == b.minX) return a.maxX < b.maxX;
-        return a.minX < b.minX;
+    // 各策略输出的顺序与朝向不同：按碰撞体 poolId 规范化（小者在前、按对排序），
+    // 窄相/解算只看到与策略无关的同一序列，不同广相下模拟结果逐位一致。
+    // 含静态体的对排在最后：顺序冲量解算中地面接触最后修正，堆叠才能收敛静止
+    for (auto &p: pairs_) {
+        if (p.first->poolId() > p.second->poolId()) std::swap(p.first, p.second);
+    }
+    std::sort(pairs_.begin(), pairs_.end(), [](const ColliderPair &a, const ColliderPair &b) {
+        const bool sa = a.first->isStatic() || a.second->isStatic();
+        const bool sb = b.first->isStatic() || b.second->isStatic();
+        if (sa != sb) return sb;
+        if (a.first->poolId() != b.first->poolId()) return a.first->poolId() < b.first->poolId();
+        return a.second->poolId() < b.second->poolId();
     });
 
-    // 活动集合：按 maxX 升序维护可快速剔除
-    struct ActiveItem {
-        BoxItem box;
+    // 休眠代理不作为广相来源：休眠-静态 / 休眠-休眠的对不会产生，也不做窄相。
+    // 上一步仍在接触、双方都不是醒着的动态体且至少一方休眠的对保持接触状态（不派发 Stay，也不派发 Exit）
+    carriedTriggers_.clear();
+    if (sleepingCount_ == 0) return;
+    auto bodyOf = [this](EntityId e) {
+        const EntityRecord *er = findEntity(e);
+        return er ? er->body : -1;
     };
-    std::vector<ActiveItem> active;
-    active.reserve(items.size());
+    for (const uint64_t key: lastTriggers_) {
+        const int ia = bodyOf(static_cast<EntityId>(key >> 32));
+        const int ib = bodyOf(static_cast<EntityId>(key & 0xffffffffu));
+        if (ia < 0 || ib < 0) continue;
+        if (isAwakeDynamic(ia) || isAwakeDynamic(ib)) continue;
+        if (bodies_.asleep[ia] || bodies_.asleep[ib]) carriedTriggers_.push_back(key); // lastTriggers_ 已升序
+    }
+}
 
-    auto overlap1D = [](float aMin, float aMax, float bMin, float bMax) -> bool {
-        return !(aMax < bMin || bMax < aMin);
-    };
+void PhysicsWorld::narrowPhase() {
+    using Clock = std::chrono::high_resolution_clock;
+    const auto start = Clock::now();
 
-    for (const auto &it: items) {
-        // 移除所有 maxX < 当前 minX 的活动项
-        const float curMinX = it.minX;
-        size_t write = 0;
-        for (size_t k = 0; k < active.size(); ++k) {
-            if (active[k].box.maxX >= curMinX) {
-                if (write != k) active[write] = active[k];
-                ++write;
-            }
-        }
-        active.resize(write);
-
-        // 与仍在活动集中的每个候选做 Y/Z 轴额外 AABB 重叠测试
-        for (const auto &aj: active) {
-            const BoxItem &bj = aj.box;
-            // X 已有重叠（因为在活动集合里），再测 Y/Z
-            if (overlap1D(it.minY, it.maxY, bj.minY, bj.maxY) &&
-                overlap1D(it.minZ, it.maxZ, bj.minZ, bj.maxZ)) {
-                // 优化：跳过静态-静态碰撞对
-                if (bj.c->isStatic() && it.c->isStatic()) {
-                    continue;
-                }
-                pairs_.emplace_back(bj.c, it.c);
-            }
-        }
+    contacts_.clear();
+    triggerHits_.clear();
+
+    // 候选对切成连续区间并行处理；各区间写入 overlaps_ 的不相交片段与自己的缓冲
+    overlaps_.assign(pairs_.size(), OverlapResult{});
+    const size_t minPerJob = static_cast<size_t>(std::max(1, params_.narrowPhaseMinPairsPerJob));
+    const int jobs = workers_->jobCount(pairs_.size(), minPerJob);
+    if (npBuffers_.size() < static_cast<size_t>(jobs)) npBuffers_.resize(static_cast<size_t>(jobs));
+    workers_->parallelFor(pairs_.size(), minPerJob, [this](int job, size_t begin, size_t end) {
+        narrowPhaseRange(npBuffers_[static_cast<size_t>(job)], begin, end);
+    });
 
-        // 将当前盒加入活动集
-        active.push_back(ActiveItem{it});
+    // 按区间顺序合并，等价于单线程按 pairs_ 顺序逐对处理
+    float busyMs = 0.0f;
+    size_t triggerCount = 0;
+    for (int j = 0; j < jobs; ++j) {
+        const auto &buf = npBuffers_[static_cast<size_t>(j)];
+        contacts_.insert(contacts_.end(), buf.contacts.begin(), buf.contacts.end());
+        triggerHits_.insert(triggerHits_.end(), buf.triggers.begin(), buf.triggers.end());
+        triggerCount += buf.triggers.size();
+        busyMs += buf.busyMs;
     }
+
+    const float wallMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    npStats_.threads = workers_->threadCount();
+    npStats_.jobs = jobs;
+    npStats_.pairCount = pairs_.size();
+    npStats_.contactCount = contacts_.size();
+    npStats_.triggerCount = triggerCount;
+    npStats_.wallMs = wallMs;
+    npStats_.busyMs = busyMs;
+    npStats_.efficiency = (jobs > 0 && wallMs > 0.0f) ? busyMs / (wallMs * static_cast<float>(jobs)) : 1.0f;
 }
 
-void PhysicsWorld::narrowPhase() {
-    contacts_.clear();
-    currTriggers_.clear();
-    triggerContactMap_.clear();
+void PhysicsWorld::narrowPhaseRange(NarrowPhaseBuffer &buf, size_t begin, size_t end) {
+    using Clock = std::chrono::high_resolution_clock;
+    const auto start = Clock::now();
+    buf.contacts.clear();
+    buf.triggers.clear();
+
+    // 按类型对批量求接触（结果与 pairs_ 顺序一致），再按原顺序分拣为 trigger / 解算接触
+    pool_.collideRange(pairs_, begin, end, overlaps_, buf.batches);
 
-    for (auto &pr: pairs_) {
-        ColliderBase *ca = pr.first;
-        ColliderBase *cb = pr.second;
-        if (!ca || !cb) continue;
-        OverlapResult out{};
-        if (!Intersect(*ca, *cb, out) || !out.intersects) continue;
+    auto testPair = [&](ColliderBase *ca, ColliderBase *cb, const OverlapResult &out) {
+        if (!ca || !cb) return;
+        if (!out.intersects) return;
 
         bool triggerPair = (ca->isTrigger() || cb->isTrigger());
 
-        // Trigger 对：立即添加到事件集合
+        // Trigger 对：记入本区间的触发缓冲，合并时加入事件集合
         if (triggerPair) {
-            EntityId ea = col2entity_[ca];
-            EntityId eb = col2entity_[cb];
-            uint64_t key = PairKey(ea, eb);
-            currTriggers_.insert(key);
-            triggerContactMap_[key] = out;
-            continue; // trigger 对不进入物理解算
+            uint64_t key = PairKey(record(ca).entity, record(cb).entity);
+            buf.triggers.push_back(TriggerHit{key, out, ca, cb, true, false});
+            return; // trigger 对不进入物理解算
         }
 
         // 非 trigger 对：先添加到 contacts_ 进行物理解算
-        // 稍后在 solveContacts() 中，只有真正产生碰撞响应的才会添加到 currTriggers_
-        int ia = col2bodyIdx_[ca];
-        int ib = col2bodyIdx_[cb];
+        // 稍后在 solveContacts() 中，只有真正产生碰撞响应的才会加入事件集合
+        int ia = record(ca).body;
+        int ib = record(cb).body;
         ContactItem item{};
         item.ia = ia;
         item.ib = ib;
         item.c = out;
         item.ca = ca;
         item.cb = cb;
+        item.key = PairKey(ca->poolId(), cb->poolId());
+        buf.contacts.push_back(item); // 窄相法线 ca -> cb，即解算器的 A -> B
+    };
+
+    for (size_t i = begin; i < end; ++i) {
+        testPair(pairs_[i].first, pairs_[i].second, overlaps_[i]);
+    }
+    buf.busyMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
 
-        // 统一法线方向为 A->B
-        XMFLOAT3 ab = sub3(out.pointOnB, out.pointOnA);
-        float d = dot3(out.normal, ab);
-        if (d < 0) {
-            item.c.normal = mul3(out.normal, -1.0f);
+void PhysicsWorld::selectCcdBodies() {
+    ccdBodies_.clear();
+    for (size_t i = 0; i < bodies_.size(); ++i) {
+        BodyState &b = bodies_.state[i];
+        b.ccdSlot = -1;
+        if (!b.ccd || !bodies_.isDynamic(i) || bodies_.asleep[i]) continue;
+        // 只有球形碰撞体做扫掠，以最小球半径判定位移是否足以穿透
+        float radius = 0.0f;
+        for (auto *c: collidersByBody_[i]) {
+            if (!c || c->kind() != ColliderType::Sphere) continue;
+            const float r = pool_.shape(c->poolId()).radius;
+            if (radius == 0.0f || r < radius) radius = r;
         }
-        contacts_.push_back(item);
+        if (radius <= 0.0f) continue;
+        if (len3(sub3(bodies_.position(i), bodies_.prevPosition(i))) <= params_.ccdMotionThreshold * radius) continue;
+        b.ccdSlot = static_cast<int>(ccdBodies_.size());
+        ccdBodies_.push_back(static_cast<int>(i));
     }
 }
 
-void PhysicsWorld::solveContacts() {
-    // 简化的碰撞响应：位置回退 + 速度反射
-    // 只有当物体实际向碰撞面移动时才处理
-    for (auto &contact: contacts_) {
-        int ia = contact.ia;
-        int ib = contact.ib;
-        if (ia < 0 || ib < 0) continue;
-        if (ia >= static_cast<int>(bodies_.size()) || ib >= static_cast<int>(bodies_.size())) continue;
-
-        BodyState &bodyA = bodies_[ia];
-        BodyState &bodyB = bodies_[ib];
-
-        // 法线方向（从 A 指向 B）
-        XMFLOAT3 normal = contact.c.normal;
-
-        // 只处理动态体
-        bool aIsDynamic = bodyA.invMass > 0.0f;
-        bool bIsDynamic = bodyB.invMass > 0.0f;
-
-        if (!aIsDynamic && !bIsDynamic) continue; // 两个都是静态体
-
-        // 标记是否发生了真实碰撞响应
-        bool collisionOccurred = false;
-
-        // 处理 A（如果是动态体）
-        if (aIsDynamic) {
-            // 检查 A 是否正在向 B 移动（速度朝向 B）
-            float vDotN = dot3(bodyA.v, normal);
-            // 小的负值阈值，避免静止时反复触发
-            if (vDotN < params().collisionVelocityThreshold) {
-                // A 正在明显向 B 移动
-                collisionOccurred = true;
-
-                // 1. 位置回退到上一帧
-                bodyA.p = bodyA.pPrev;
-
-                // 2. 速度沿法线方向反弹
-                float e = bodyA.restitution; // 恢复系数
-                XMFLOAT3 vNormal = mul3(normal, vDotN);
-                XMFLOAT3 vTangent = sub3(bodyA.v, vNormal);
-                // v' = vTangent - e * vNormal（保留切向，反转并缩放法向）
-                bodyA.v = sub3(vTangent, mul3(vNormal, e));
-            } else if (vDotN < 0) {
-                // 速度很小但仍在穿透，仅清零法线方向速度（贴地）
-                XMFLOAT3 vNormal = mul3(normal, vDotN);
-                bodyA.v = sub3(bodyA.v, vNormal);
+void PhysicsWorld::continuousCollision() {
+    if (ccdBodies_.empty()) return;
+    ccdHits_.assign(ccdBodies_.size(), CcdHit{});
+
+    // 候选对中一方属于 ccd 体的球形碰撞体时，沿本步位移扫掠；回调 fn(slot, pairIndex, self, other, t, contact)
+    auto sweepPairs = [this](bool triggers, auto &&fn) {
+        for (size_t i = 0; i < pairs_.size(); ++i) {
+            ColliderBase *ends[2] = {pairs_[i].first, pairs_[i].second};
+            if (!ends[0] || !ends[1]) continue;
+            if ((ends[0]->isTrigger() || ends[1]->isTrigger()) != triggers) continue;
+            for (int side = 0; side < 2; ++side) {
+                ColliderBase *self = ends[side];
+                ColliderBase *other = ends[1 - side];
+                const int ia = record(self).body;
+                const int ib = record(other).body;
+                if (ia < 0 || ia == ib || bodies_.state[ia].ccdSlot < 0) continue;
+                if (self->kind() != ColliderType::Sphere) continue;
+
+                const XMFLOAT3 d = sub3(bodies_.position(ia), bodies_.prevPosition(ia));
+                const XMFLOAT3 q0 = sub3(pool_.center(self->poolId()), d);
+                SweepTarget target{};
+                target.kind = other->kind();
+                target.center = pool_.center(other->poolId());
+                target.shape = pool_.shape(other->poolId());
+                const float r = pool_.shape(self->poolId()).radius;
+
+                float t = 0.0f;
+                XMFLOAT3 n{}, pointOnOther{};
+                if (!SweepSphere(q0, d, r, target, t, n, pointOnOther)) continue;
+
+                OverlapResult contact{};
+                contact.intersects = true;
+                contact.penetration = 0.0f;
+                // SweepSphere 给出对方外法线（other -> self）；接触按 self 为 A，法线取反为 A -> B
+                contact.normal = mul3(n, -1.0f);
+                contact.pointOnA = sub3(add3(q0, mul3(d, t)), mul3(n, r));
+                contact.pointOnB = pointOnOther;
+                fn(bodies_.state[ia].ccdSlot, i, self, other, t, contact);
             }
         }
+    };
 
-        // 处理 B（如果是动态体）
-        if (bIsDynamic) {
-            // B 的法线方向相反（从 B 指向 A）
-            XMFLOAT3 normalB = mul3(normal, -1.0f);
-            float vDotN = dot3(bodyB.v, normalB);
-            if (vDotN < params().collisionVelocityThreshold) {
-                // B 正在明显向 A 移动
-                collisionOccurred = true;
-
-                // 1. 位置回退
-                bodyB.p = bodyB.pPrev;
-
-                // 2. 速度反弹
-                float e = bodyB.restitution;
-                XMFLOAT3 vNormal = mul3(normalB, vDotN);
-                XMFLOAT3 vTangent = sub3(bodyB.v, vNormal);
-                bodyB.v = sub3(vTangent, mul3(vNormal, e));
-            } else if (vDotN < 0) {
-                // 速度很小但仍在穿透，仅清零法线方向速度
-                XMFLOAT3 vNormal = mul3(normalB, vDotN);
-                bodyB.v = sub3(bodyB.v, vNormal);
-            }
+    // 1) 实体对：取每个体最早的“迎面”接触（沿法线的位移超过容差，排除贴地滑行等擦边）
+    sweepPairs(false, [this](int slot, size_t pair, ColliderBase *self, ColliderBase *other, float t,
+                             const OverlapResult &contact) {
+        const int bi = ccdBodies_[slot];
+        if (dot3(contact.normal, sub3(bodies_.position(bi), bodies_.prevPosition(bi))) <= params_.penetrationSlop) return;
+        CcdHit &hit = ccdHits_[slot];
+        if (t >= hit.t) return;
+        hit.t = t;
+        hit.pair = pair;
+        hit.self = self;
+        hit.other = other;
+        hit.contact = contact;
+    });
+
+    // 2) 上一位置前移到首次接触处（解算后从这里重新积分）；离散检测未覆盖该对说明本步穿了过去，
+    //    体停在接触处并补一条接触交给 solveContacts 做反弹、派发事件
+    for (size_t slot = 0; slot < ccdBodies_.size(); ++slot) {
+        const CcdHit &hit = ccdHits_[slot];
+        if (hit.t > 1.0f) continue;
+        const int bi = ccdBodies_[slot];
+        const XMFLOAT3 prev = bodies_.prevPosition(bi);
+        const XMFLOAT3 impact = add3(prev, mul3(sub3(bodies_.position(bi), prev), hit.t));
+        bodies_.setPrevPosition(bi, impact);
+        if (overlaps_[hit.pair].intersects) continue;
+        bodies_.setPosition(bi, impact);
+
+        ContactItem item{};
+        item.ia = ccdBodies_[slot];
+        item.ib = record(hit.other).body;
+        item.c = hit.contact;
+        item.ca = hit.self;
+        item.cb = hit.other;
+        item.key = PairKey(hit.self->poolId(), hit.other->poolId());
+        contacts_.push_back(item);
+    }
+
+    // 3) trigger：扫掠路径（截止到停下处）碰到即记为本步重叠，高速穿过也能得到 Enter/Exit
+    sweepPairs(true, [this](int slot, size_t pair, ColliderBase *self, ColliderBase *other, float t,
+                            const OverlapResult &contact) {
+        if (overlaps_[pair].intersects) return; // 离散检测已记录
+        const CcdHit &hit = ccdHits_[slot];
+        if (hit.t <= 1.0f && !overlaps_[hit.pair].intersects && t > hit.t) return;
+        const uint64_t key = PairKey(record(self).entity, record(other).entity);
+        triggerHits_.push_back(TriggerHit{key, contact, self, other, true, true});
+    });
+}
+
+void PhysicsWorld::pullBodyInputs() {
+    for (size_t i = 0; i < bodies_.size(); ++i) {
+        RigidBody *rb = bodyRefs_[i];
+        if (!rb) continue;
+        const XMFLOAT3 &f = rb->forceAccum;
+        const bool forced = f.x != 0.0f || f.y != 0.0f || f.z != 0.0f;
+        bodies_.setForce(i, f);
+        if (forced) rb->clearForces();
+        if (!forced && !rb->velocityChanged) continue;
+        if (rb->velocityChanged) bodies_.setVelocity(i, rb->velocity);
+        rb->velocityChanged = false;
+        wakeBody(static_cast<int>(i));
+    }
+}
+
+void PhysicsWorld::wakeTouchedSleepers() {
+    if (sleepingCount_ == 0) return;
+    for (const auto &ct: contacts_) {
+        if (bodies_.asleep[ct.ia] && isAwakeDynamic(ct.ib)) wakeBody(ct.ia);
+        else if (bodies_.asleep[ct.ib] && isAwakeDynamic(ct.ia)) wakeBody(ct.ib);
+    }
+}
+
+void PhysicsWorld::wakeBody(int bidx) {
+    if (bidx < 0 || !bodies_.asleep[bidx]) return;
+    int i = bidx;
+    do {
+        BodyState &b = bodies_.state[i];
+        const int next = b.sleepNext;
+        bodies_.asleep[i] = 0;
+        setBodyProxiesSleeping(i, false);
+        b.restFrames = 0;
+        b.sleepPrev = b.sleepNext = -1;
+        --sleepingCount_;
+        i = next;
+    } while (i != bidx);
+}
+
+void PhysicsWorld::setBodyProxiesSleeping(int bidx, bool sleeping) {
+    querySleepingDirty_ = true;
+    for (auto *c: collidersByBody_[bidx]) {
+        const IBroadPhase::ProxyId proxy = record(c).proxy;
+        if (proxy != IBroadPhase::InvalidProxy) broadphase_->setProxySleeping(proxy, sleeping);
+    }
+}
+
+void PhysicsWorld::unlinkSleeping(int bidx) {
+    BodyState &b = bodies_.state[bidx];
+    if (b.sleepNext < 0) return;
+    if (b.sleepNext != bidx) {
+        bodies_.state[b.sleepPrev].sleepNext = b.sleepNext;
+        bodies_.state[b.sleepNext].sleepPrev = b.sleepPrev;
+    }
+    b.sleepPrev = b.sleepNext = -1;
+}
+
+void PhysicsWorld::wakeBodiesTouching(const Aabb &box) {
+    if (sleepingCount_ == 0) return;
+    // 快照之后反注册的实体查不到记录，跳过；之后注册的体尚未休眠过
+    query_.forEachDynamicOverlapping(box, [this](EntityId e) {
+        if (const EntityRecord *er = findEntity(e)) wakeBody(er->body);
+    });
+}
+
+void PhysicsWorld::buildIslands() {
+    const int n = static_cast<int>(bodies_.size());
+    islandParent_.resize(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) islandParent_[i] = i;
+    auto find = [this](int x) {
+        while (islandParent_[x] != x) {
+            islandParent_[x] = islandParent_[islandParent_[x]];
+            x = islandParent_[x];
         }
+        return x;
+    };
 
-        // 只有真正发生碰撞响应时，才添加到事件系统
-        if (collisionOccurred) {
-            EntityId ea = col2entity_[contact.ca];
-            EntityId eb = col2entity_[contact.cb];
-            uint64_t key = PairKey(ea, eb);
-            currTriggers_.insert(key);
-            triggerContactMap_[key] = contact.c;
+    // 只连接两侧都是醒着的动态体的接触；以较小下标为根，根即集合内最小下标
+    for (const auto &ct: contacts_) {
+        if (!isAwakeDynamic(ct.ia) || !isAwakeDynamic(ct.ib)) continue;
+        const int ra = find(ct.ia);
+        const int rb = find(ct.ib);
+        if (ra == rb) continue;
+        if (ra < rb) islandParent_[rb] = ra;
+        else islandParent_[ra] = rb;
+    }
+
+    // 岛编号按根（最小体下标）递增分配，结果只取决于体下标与连通关系
+    bodyIsland_.assign(static_cast<size_t>(n), -1);
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!isAwakeDynamic(i)) continue;
+        const int r = find(i);
+        bodyIsland_[i] = (r == i) ? count++ : bodyIsland_[r];
+    }
+
+    // 计数排序：按岛分组体与接触（组内保持原顺序）
+    auto group = [this, count](size_t items, std::vector<int> &start, std::vector<int> &out, auto &&islandOf) {
+        start.assign(static_cast<size_t>(count) + 1, 0);
+        for (size_t i = 0; i < items; ++i) {
+            const int k = islandOf(i);
+            if (k >= 0) ++start[static_cast<size_t>(k) + 1];
         }
+        for (int k = 0; k < count; ++k) start[k + 1] += start[k];
+        out.resize(static_cast<size_t>(start[count]));
+        islandCursor_.assign(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < items; ++i) {
+            const int k = islandOf(i);
+            if (k >= 0) out[islandCursor_[k]++] = static_cast<int>(i);
+        }
+    };
+    group(bodies_.size(), islandBodyStart_, islandBodies_, [this](size_t i) { return bodyIsland_[i]; });
+    group(contacts_.size(), islandContactStart_, islandContacts_, [this](size_t i) {
+        const int ka = bodyIsland_[contacts_[i].ia];
+        return ka >= 0 ? ka : bodyIsland_[contacts_[i].ib];
+    });
+
+    islandStats_.islandCount = static_cast<size_t>(count);
+    islandStats_.awakeBodies = islandBodies_.size();
+    islandStats_.largestIsland = 0;
+    for (int k = 0; k < count; ++k) {
+        islandStats_.largestIsland = std::max(islandStats_.largestIsland,
+                                              static_cast<size_t>(islandBodyStart_[k + 1] - islandBodyStart_[k]));
+    }
+}
+
+void PhysicsWorld::updateSleep() {
+    islandStats_.sleepingBodies = sleepingCount_;
+    if (!params_.enableSleeping) return;
+    const float v2 = params_.sleepVelocity * params_.sleepVelocity;
+    const int islands = static_cast<int>(islandBodyStart_.size()) - 1;
+    for (int k = 0; k < islands; ++k) {
+        bool rest = true;
+        for (int j = islandBodyStart_[k]; j < islandBodyStart_[k + 1]; ++j) {
+            const int bi = islandBodies_[j];
+            const XMFLOAT3 v = bodies_.velocity(bi);
+            BodyState &b = bodies_.state[bi];
+            b.restFrames = dot3(v, v) < v2 ? b.restFrames + 1 : 0;
+            if (b.restFrames < params_.sleepFrames) rest = false;
+        }
+        if (!rest) continue;
+        const int first = islandBodyStart_[k];
+        const int end = islandBodyStart_[k + 1];
+        for (int j = first; j < end; ++j) {
+            const int bi = islandBodies_[j];
+            bodies_.asleep[bi] = 1;
+            setBodyProxiesSleeping(bi, true);
+            bodies_.setVelocity(bi, XMFLOAT3{0, 0, 0});
+            bodies_.setPrevPosition(bi, bodies_.position(bi));
+            // 岛内的体按分组顺序首尾相连
+            BodyState &b = bodies_.state[bi];
+            b.sleepPrev = islandBodies_[j > first ? j - 1 : end - 1];
+            b.sleepNext = islandBodies_[j + 1 < end ? j + 1 : first];
+            ++sleepingCount_;
+        }
+    }
+    islandStats_.sleepingBodies = sleepingCount_;
+}
+
+void PhysicsWorld::solveContacts(float dt) {
+    // 迭代冲量解算（含暖启动、摩擦与穿透校正），按 buildIslands 的分组逐岛并行；
+    // 接触中的动态体位置按新速度重新积分
+    solver_.solve(contacts_, bodies_, islandContactStart_, islandContacts_, params_.solver, dt, *workers_);
+
+    // 只有真正产生碰撞响应（法向冲量 > 0）的接触才加入事件系统
+    for (const auto &contact: contacts_) {
+        if (contact.normalImpulse <= 0.0f) continue;
+        EntityId ea = record(contact.ca).entity;
+        EntityId eb = record(contact.cb).entity;
+        triggerHits_.push_back(TriggerHit{PairKey(ea, eb), contact.c, contact.ca, contact.cb, false, false});
     }
 }
 
 void PhysicsWorld::positionalCorrection() {
-    // 当前在 ContactSolver::ResolveOne 中已做比例分离，这里留空
+    // 穿透校正已并入 ContactSolver 的目标法向速度（slop/beta），这里留空
+}
+
+void PhysicsWorld::collectTriggers() {
+    // 同一对可能多次记录（多个碰撞体、CCD、解算接触）：取最后一条非 weak 记录的触点与碰撞体，全为 weak 时取第一条；
+    // 任一记录涉及 trigger 即视为 trigger 对
+    std::stable_sort(triggerHits_.begin(), triggerHits_.end(),
+                     [](const TriggerHit &x, const TriggerHit &y) { return x.key < y.key; });
+    size_t out = 0;
+    for (size_t i = 0; i < triggerHits_.size();) {
+        const uint64_t key = triggerHits_[i].key;
+        const TriggerHit *chosen = nullptr;
+        bool trigger = false;
+        for (; i < triggerHits_.size() && triggerHits_[i].key == key; ++i) {
+            if (!triggerHits_[i].weak || !chosen) chosen = &triggerHits_[i];
+            trigger = trigger || triggerHits_[i].trigger;
+        }
+        TriggerHit hit = *chosen; // 先取出再写回：out 不超过本组起点
+        hit.trigger = trigger;
+        // colliderA 归属 key 中较小的实体（接触随之翻转，法线仍由 colliderA 指向 colliderB）
+        if (hit.colliderA && record(hit.colliderA).entity != static_cast<EntityId>(key >> 32)) {
+            std::swap(hit.colliderA, hit.colliderB);
+            FlipContact(hit.contact);
+        }
+        triggerHits_[out++] = hit;
+    }
+    triggerHits_.resize(out);
 }
 
 void PhysicsWorld::syncBackAndDispatch(float /*dt*/) {
     // 写回刚体与碰撞体
+    bool any = false;
     for (size_t i = 0; i < bodies_.size(); ++i) {
         RigidBody *rb = bodyRefs_[i];
         if (!rb) continue;
-        const auto &bs = bodies_[i];
-        rb->position = bs.p;
-        rb->velocity = bs.v;
-        // 同步给其 colliders（仅更新 Owner 世界位置）
-        for (auto *c: collidersByBody_[i]) {
-            if (!c) continue;
-            c->setOwnerWorldPosition(bs.p);
-            c->updateDerived();
-        }
+        rb->position = bodies_.position(i);
+        rb->velocity = bodies_.velocity(i);
+        rb->sleeping = bodies_.asleep[i] != 0;
+        // 同步给其 colliders（仅更新 Owner 世界位置；解算未改动位置时跳过）
+        if (syncBodyColliders(i)) any = true;
     }
-
-    // 触发器事件分发
-    if (onTrigger_) {
-        // Enter
-        for (auto key: currTriggers_) {
-            if (lastTriggers_.find(key) == lastTriggers_.end()) {
-                // 解析 key 得到实体 id（这里只用于回调顺序一致性，简单处理）
-                EntityId a = static_cast<EntityId>(key >> 32);
-                EntityId b = static_cast<EntityId>(key & 0xffffffffu);
-                onTrigger_(a, b, TriggerPhase::Enter, triggerContactMap_[key]);
-            }
-        }
-        // Stay
-        for (auto key: currTriggers_) {
-            if (lastTriggers_.find(key) != lastTriggers_.end()) {
-                EntityId a = static_cast<EntityId>(key >> 32);
-                EntityId b = static_cast<EntityId>(key & 0xffffffffu);
-                onTrigger_(a, b, TriggerPhase::Stay, triggerContactMap_[key]);
+    if (any) pool_.updateDerived();
+
+    // 事件：本步与上一步的接触对均为升序数组，一次归并得到 Enter/Stay/Exit（按 key 升序）与新的状态数组
+    collectTriggers();
+    events_.clear();
+    nextTriggers_.clear();
+    nextTriggerFlags_.clear();
+    auto emit = [this](const TriggerHit &hit, TriggerPhase phase) {
+        CollisionEvent ev{};
+        ev.a = static_cast<EntityId>(hit.key >> 32);
+        ev.b = static_cast<EntityId>(hit.key & 0xffffffffu);
+        ev.phase = phase;
+        ev.trigger = hit.trigger;
+        ev.colliderA = hit.colliderA;
+        ev.colliderB = hit.colliderB;
+        ev.contact = hit.contact;
+        events_.push_back(ev);
+        nextTriggers_.push_back(hit.key);
+        nextTriggerFlags_.push_back(hit.trigger ? 1 : 0);
+    };
+    const auto &curr = triggerHits_;
+    size_t i = 0, j = 0, k = 0;
+    while (i < curr.size() || j < lastTriggers_.size()) {
+        if (j == lastTriggers_.size() || (i < curr.size() && curr[i].key < lastTriggers_[j])) {
+            emit(curr[i++], TriggerPhase::Enter);
+        } else if (i == curr.size() || lastTriggers_[j] < curr[i].key) {
+            const uint64_t key = lastTriggers_[j];
+            while (k < carriedTriggers_.size() && carriedTriggers_[k] < key) ++k;
+            if (k < carriedTriggers_.size() && carriedTriggers_[k] == key) {
+                // 因休眠跳过检测的对保持原状态，不派发事件
+                nextTriggers_.push_back(key);
+                nextTriggerFlags_.push_back(lastTriggerFlags_[j]);
+            } else {
+                CollisionEvent ev{};
+                ev.a = static_cast<EntityId>(key >> 32);
+                ev.b = static_cast<EntityId>(key & 0xffffffffu);
+                ev.phase = TriggerPhase::Exit;
+                ev.trigger = lastTriggerFlags_[j] != 0;
+                events_.push_back(ev);
             }
+            ++j;
+        } else {
+            emit(curr[i++], TriggerPhase::Stay);
+            ++j;
         }
-        // Exit
-        for (auto key: lastTriggers_) {
-            if (currTriggers_.find(key) == currTriggers_.end()) {
-                EntityId a = static_cast<EntityId>(key >> 32);
-                EntityId b = static_cast<EntityId>(key & 0xffffffffu);
-                OverlapResult dummy{}; // 退出一般无需触点
-                onTrigger_(a, b, TriggerPhase::Exit, dummy);
-            }
+    }
+    lastTriggers_.swap(nextTriggers_);
+    lastTriggerFlags_.swap(nextTriggerFlags_);
+    triggerHits_.clear();
+    contacts_.clear();
+}
+
+void PhysicsWorld::buildQuerySnapshot() {
+    auto entryOf = [this](const ColliderRecord &rec) {
+        const ColliderBase *c = rec.collider;
+        const ColliderPool::Id id = c->poolId();
+        SceneQuery::Entry e{};
+        e.geom.kind = c->kind();
+        e.geom.center = pool_.center(id);
+        e.geom.shape = pool_.shape(id);
+        e.box = pool_.aabb(id);
+        e.entity = rec.entity;
+        e.layer = c->layer();
+        e.trigger = c->isTrigger();
+        return e;
+    };
+    if (!queryStaticBuilt_ || bpStats_.staticRebuilt) {
+        queryEntries_.clear();
+        for (const ColliderRecord &rec: colliderRecs_) {
+            if (rec.collider && rec.dynamicSlot < 0) queryEntries_.push_back(entryOf(rec));
         }
+        query_.rebuildStatic(queryEntries_);
+        queryStaticBuilt_ = true;
     }
 
-    lastTriggers_ = currTriggers_;
-    currTriggers_.clear();
-    triggerContactMap_.clear();
-    contacts_.clear();
-    pairs_.clear();
-}
\ No newline at end of file
+    // 非静态碰撞体：醒着的每步重建；休眠的不移动，只在休眠集合变化后重建
+    queryEntries_.clear();
+    querySleepingEntries_.clear();
+    for (const ColliderPool::Id id: dynamicColliders_) {
+        const ColliderRecord &rec = colliderRecs_[id];
+        if (!bodies_.asleep[rec.body]) queryEntries_.push_back(entryOf(rec));
+        else if (querySleepingDirty_) querySleepingEntries_.push_back(entryOf(rec));
+    }
+    if (querySleepingDirty_) {
+        query_.rebuildSleeping(querySleepingEntries_);
+        querySleepingDirty_ = false;
+    }
+    query_.rebuildDynamic(queryEntries_);
+}
@@ -2,16 +2,20 @@
 #pragma execution_character_set("utf-8")
 
 #include <vector>
+#include <array>
 #include <span>
-#include <unordered_map>
-#include <unordered_set>
-#include <functional>
+#include <memory>
 #include <cstdint>
 #include <DirectXMath.h>
 
 #include "RigidBody.hpp"
 #include "Collider.hpp"
+#include "ColliderPool.hpp"
 #include "ContactSolver.hpp"
+#include "BroadPhase.hpp"
+#include "WorkerPool.hpp"
+#include "SparseIndex.hpp"
+#include "SceneQuery.hpp"
 
 // 简易实体标识（游戏层自行保证唯一性/稳定性）
 using EntityId = uint32_t;
@@ -20,14 +24,11 @@ using EntityId = uint32_t;
 struct WorldParams {
     DirectX::XMFLOAT3 gravity{0, -9.81f, 0};
     float maxSpeed = 100.0f; // 可选速度上限
+    // 积分走 SIMD 核（false 为逐体标量参考实现，结果相同，用于对照与排查）
+    bool vectorizedIntegrate = true;
 
-
-    // 碰撞法线速度阈值 (vDotN < threshold)
-    // 用于判定物体是否正在“撞向”彼此。值越接近0，越能捕捉到极低速的擦边碰撞。
-    float collisionVelocityThreshold = -0.001f;
-
-    // 穿透回退容差 (Penetration Tolerance)
-    // 允许的微小重叠量，防止由于浮点误差导致的物体在地面上高频“抖动”或不断触发回弹事件。
+    // 穿透容差 (Penetration Tolerance)
+    // CCD 判定“迎面”接触时沿法线的最小位移；解算器的穿透容差见 solver.slop
     float penetrationSlop = 0.005f;
 
     // 速度恢复系数 (Restitution) 的默认全局加权
@@ -37,24 +38,99 @@ struct WorldParams {
     // 摩擦力系数
     float frictionCoefficient = 0.3f;
 
+    // 广相策略（仅在 PhysicsWorld 构造时、或尚未注册任何碰撞体时生效）
+    BroadPhaseType broadPhase = BroadPhaseType::SweepAndPrune;
+    // 空间哈希格子边长：战场为 1x1x1 方块，子弹半径 0.25，默认取一个方块的尺寸
+    float broadPhaseCellSize = 1.0f;
+
+    // 层间碰撞矩阵：layerMatrix[i] 为第 i 层可与之产生候选对的层位，与碰撞体自身 collisionMask 取交；默认全部可碰撞
+    std::array<uint32_t, 32> layerMatrix = [] {
+        std::array<uint32_t, 32> m{};
+        m.fill(0xffffffffu);
+        return m;
+    }();
+
+    // 设置第 a 层与第 b 层是否碰撞（对称写入两行）
+    void setLayerCollision(int a, int b, bool collide) {
+        if (a < 0 || a >= 32 || b < 0 || b >= 32) return;
+        if (collide) {
+            layerMatrix[a] |= 1u << b;
+            layerMatrix[b] |= 1u << a;
+        } else {
+            layerMatrix[a] &= ~(1u << b);
+            layerMatrix[b] &= ~(1u << a);
+        }
+    }
+
+    // 物理线程数（含调用线程，窄相与按岛解算共用）：0 取硬件并发数，1 为单线程；结果与线程数无关
+    int narrowPhaseThreads = 0;
+    // 每个线程至少分到的候选对数量，对数太少时不拆分（避免同步开销大于收益）
+    int narrowPhaseMinPairsPerJob = 128;
+
+    // 连续碰撞检测：开启 RigidBody::ccd 的体单步位移超过其球半径的该比例时，做扫掠球 TOI 检测
+    float ccdMotionThreshold = 0.5f;
+
+    // 休眠：岛内所有动态体速度低于 sleepVelocity 持续 sleepFrames 步后整岛休眠（不积分、不参与检测），
+    // 受到接触、applyImpulse 或外部改动位姿时整岛唤醒
+    bool enableSleeping = true;
+    float sleepVelocity = 0.05f;
+    int sleepFrames = 30;
+
+    // 解算器参数（迭代上限/收敛阈值/穿透容差/校正比例/反弹速度阈值/暖启动）
+    SolverParams solver;
+
     //废弃
-    SolverParams solver; // 解算器参数（iterations/slop/beta）
+    // 碰撞法线速度阈值（旧的回退式解算使用）
+    float collisionVelocityThreshold = -0.001f;
     int substeps = 1;  //子步数量（>1 可减少穿透）
 };
 
+// 窄相统计（每步刷新，用于性能输出）
+struct NarrowPhaseStats {
+    int threads = 1; // 线程池线程数
+    int jobs = 0; // 本步实际切分的区间数
+    size_t pairCount = 0; // 输入候选对数量
+    size_t contactCount = 0; // 非 trigger 接触数量
+    size_t triggerCount = 0; // trigger 重叠数量
+    float wallMs = 0.0f; // 窄相总耗时（含合并）
+    float busyMs = 0.0f; // 各区间工作耗时之和
+    float efficiency = 1.0f; // 并行效率 = busyMs / (wallMs * jobs)
+};
+
+// 岛与休眠统计（每步刷新）
+struct IslandStats {
+    size_t islandCount = 0; // 本步醒着的岛数
+    size_t largestIsland = 0; // 最大岛的体数
+    size_t awakeBodies = 0; // 醒着的动态体
+    size_t sleepingBodies = 0; // 休眠的动态体
+};
+
 // 触发器事件类型
 enum class TriggerPhase { Enter, Stay, Exit };
 
-// 触发事件回调签名
-using TriggerCallback = std::function<void(EntityId a, EntityId b, TriggerPhase phase, const OverlapResult & contact)>;
+// 碰撞/触发事件：每步写入 PhysicsWorld 的连续事件缓冲（见 collisionEvents），a < b
+struct CollisionEvent {
+    EntityId a = 0;
+    EntityId b = 0;
+    TriggerPhase phase = TriggerPhase::Stay;
+    bool trigger = false; // 任一方碰撞体为 trigger（无物理响应）
+    // 本步产生该接触的碰撞体（分属 a、b）；Exit 时为 nullptr（实体可能已反注册）
+    ColliderBase *colliderA = nullptr;
+    ColliderBase *colliderB = nullptr;
+    OverlapResult contact{}; // 法线由 colliderA 指向 colliderB；Exit 时为空
+};
 
 // PhysicsWorld：
 // - 负责一帧内的编排（积分→检测→解算→同步/事件）
-// - 使用索引化稠密数组提升解算效率；通过映射维护 collider/entity 关系
+// - 使用索引化稠密数组提升解算效率；collider/entity 关系存放在按下标访问的记录表中（热路径无哈希）
 class PhysicsWorld {
 public:
-    PhysicsWorld() = default;
+    PhysicsWorld();
 
+    // 以给定参数构造（广相策略在此确定）
+    explicit PhysicsWorld(const WorldParams &p);
+
+    // 更新参数；若广相策略/格子尺寸变化且世界为空，则同时切换广相
     void setParams(const WorldParams &p);
 
     const WorldParams &params() const { return params_; }
@@ -64,69 +140,296 @@ public:
 
     void unregisterEntity(EntityId e);
 
+    // 注册后修改了实体碰撞体的 layer/collisionMask 时调用，使广相过滤在下一步生效
+    void refreshCollisionFilter(EntityId e);
+
+    // 批量注册/反注册：beginBatch 与 commitBatch 之间的 registerEntity/unregisterEntity 立即更新记录表，
+    // 但广相结构的增删与空体的压缩推迟到 commitBatch 一次完成（大量生成/销毁时避免逐个 O(N) 调整）。
+    // 可嵌套，最外层 commitBatch 生效；批量期间不应调用 step。
+    void beginBatch();
+
+    void commitBatch();
+
     // 主更新入口
     void step(float dt);
 
-    // 触发器事件回调（可选）
-    void setTriggerCallback(TriggerCallback cb) { onTrigger_ = std::move(cb); }
+    // 上一次 step 产生的碰撞/触发事件（按实体对升序），连续存放，下一次 step 前有效
+    std::span<const CollisionEvent> collisionEvents() const { return events_; }
 
     // —— 新增：从外部 Owner Transform 同步到物理体 ——
     // 用途：当游戏层直接改动实体 Transform（传送/拖拽/重置）时，在物理步开始前调用该接口，
     // 若位置与当前 BodyState 不一致，则以 Owner 的位置为准覆盖，并可选清零速度（避免残余动量）。
-    // 说明：当前解算仅支持线性部分，rotEulerW 仅用于将 Owner 世界朝向注入到 Collider（影响派生世界矩阵/调试绘制），
+    // 说明：当前解算仅支持线性部分，rotW（四元数）仅用于将 Owner 世界朝向注入到 Collider（影响碰撞形状与派生世界矩阵），
     // 不参与动力学计算。
     void syncOwnerTransform(EntityId e,
                             const DirectX::XMFLOAT3 &posW,
-                            const DirectX::XMFLOAT3 &rotEulerW,
+                            const DirectX::XMFLOAT4 &rotW,
                             bool resetVelocityOnChange = true);
 
+    // 欧拉角包装（pitch, yaw, roll，弧度）
+    void syncOwnerTransform(EntityId e,
+                            const DirectX::XMFLOAT3 &posW,
+                            const DirectX::XMFLOAT3 &rotEulerW,
+                            bool resetVelocityOnChange = true) {
+        syncOwnerTransform(e, posW, QuaternionFromEuler(rotEulerW), resetVelocityOnChange);
+    }
+
+    // 已注册的刚体，按体下标排列（只有碰撞体、没有 RigidBody 的体为 nullptr）；注册/反注册后下标会变
+    std::span<RigidBody *const> rigidBodies() const { return bodyRefs_; }
+
+    const BroadPhaseStats &broadPhaseStats() const { return bpStats_; }
+
+    const NarrowPhaseStats &narrowPhaseStats() const { return npStats_; }
+
+    const SolverStats &solverStats() const { return solver_.stats(); }
+
+    const IslandStats &islandStats() const { return islandStats_; }
+
+    const IBroadPhase &broadPhaseImpl() const { return *broadphase_; }
+
+    // 上一次 step 结束时处于接触/重叠状态的实体对（PairKey 升序：高 32 位为较小的实体 id），下一次 step 前有效；
+    // activePairTriggers 与之一一对应，非 0 表示该对涉及 trigger 碰撞体
+    std::span<const uint64_t> activePairs() const { return lastTriggers_; }
+
+    std::span<const uint8_t> activePairTriggers() const { return lastTriggerFlags_; }
+
+    // —— 只读场景查询：射线 / 扫掠球 / 重叠 ——
+    // 对象是上一次 step 结束时的状态（每步末尾重建查询快照，BVH 剪枝，O(log n)）；之后注册/反注册的实体在下一步才反映。
+    // 可在多个线程同时调用，但不得与 step 并发。参数与输出约定见 SceneQuery。
+    bool raycast(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir, float maxDist,
+                 QueryHit &out, const QueryFilter &filter = {}) const {
+        return query_.raycast(origin, dir, maxDist, out, filter);
+    }
+
+    size_t raycastAll(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir, float maxDist,
+                      std::vector<QueryHit> &out, const QueryFilter &filter = {}) const {
+        return query_.raycastAll(origin, dir, maxDist, out, filter);
+    }
+
+    bool sphereCast(const DirectX::XMFLOAT3 &origin, float radius, const DirectX::XMFLOAT3 &dir, float maxDist,
+                    QueryHit &out, const QueryFilter &filter = {}) const {
+        return query_.sphereCast(origin, radius, dir, maxDist, out, filter);
+    }
+
+    size_t sphereCastAll(const DirectX::XMFLOAT3 &origin, float radius, const DirectX::XMFLOAT3 &dir, float maxDist,
+                         std::vector<QueryHit> &out, const QueryFilter &filter = {}) const {
+        return query_.sphereCastAll(origin, radius, dir, maxDist, out, filter);
+    }
+
+    size_t overlapSphere(const DirectX::XMFLOAT3 &center, float radius,
+                         std::vector<QueryHit> &out, const QueryFilter &filter = {}) const {
+        return query_.overlapSphere(center, radius, out, filter);
+    }
+
+    size_t overlapObb(const DirectX::XMFLOAT3 &center, const DirectX::XMFLOAT3 &halfExtents,
+                      const DirectX::XMFLOAT4 &rotation,
+                      std::vector<QueryHit> &out, const QueryFilter &filter = {}) const {
+        return query_.overlapObb(center, halfExtents, rotation, out, filter);
+    }
+
 private:
     // 内部过程
     void integrate(float dt);
 
+    // 碰撞体的有效过滤：自身 mask 与其所在各层在 layerMatrix 中的行取交
+    CollisionFilter filterOf(const ColliderBase *c) const;
+
     void broadPhase();
 
     void narrowPhase();
 
-    void solveContacts();
+    struct NarrowPhaseBuffer;
+
+    // 窄相单个区间：求 pairs_[begin, end) 的接触并分拣到该区间自己的缓冲（在工作线程执行，只写 overlaps_ 的对应片段）
+    void narrowPhaseRange(NarrowPhaseBuffer &buf, size_t begin, size_t end);
+
+    // CCD：积分后挑出本步位移超过阈值的 ccd 体（广相对其使用扫掠 AABB）
+    void selectCcdBodies();
+
+    // CCD：窄相后对被挑出的体沿本步位移做扫掠球检测。
+    // 命中（且离散检测未发现接触）时体停在首次接触处，并补一条接触交给 solveContacts（事件照常派发）；
+    // 途经的 trigger 记为本步重叠
+    void continuousCollision();
+
+    // 读取游戏层输入：applyImpulse 改动过的速度以 RigidBody::velocity 为准，forceAccum 取走作为本步外力并清零；
+    // 有输入的体被唤醒
+    void pullBodyInputs();
+
+    // 接触中一方休眠、另一方醒着的动态体：唤醒休眠方所在的岛
+    void wakeTouchedSleepers();
+
+    // 以 contacts_ 为边、并查集求醒着的动态体的连通分量（静态体不传递连通），按岛分组体与接触
+    void buildIslands();
+
+    // 岛内全部体持续静止则整岛休眠
+    void updateSleep();
+
+    // 唤醒体 bidx 所在的休眠岛（沿岛内链表，只触及本岛的体）
+    void wakeBody(int bidx);
+
+    // 唤醒 AABB 与 box 重叠的休眠体（静态体被移走/移动时，靠在它上面的体需要重新下落）。
+    // 经查询快照的动态树求重叠：休眠体不移动，快照中的包围盒即当前包围盒
+    void wakeBodiesTouching(const Aabb &box);
+
+    // 体 bidx 的碰撞体在广相中标记为休眠/唤醒（休眠代理不作为候选对来源）
+    void setBodyProxiesSleeping(int bidx, bool sleeping);
+
+    // 将体 bidx 摘出所在的休眠岛链表
+    void unlinkSleeping(int bidx);
+
+    // 体是否为醒着的动态体
+    bool isAwakeDynamic(int bidx) const {
+        return bidx >= 0 && bodies_.invMass[bidx] > 0.0f && !bodies_.asleep[bidx];
+    }
+
+    void solveContacts(float dt);
 
     void positionalCorrection(); // 若解算器已做，可为空实现
     void syncBackAndDispatch(float dt);
 
+    // 以池中当前派生量重建查询快照（静态树仅在广相重建静态结构后重建，休眠树仅在休眠集合变化后重建）
+    void buildQuerySnapshot();
+
     // 在进行广相/窄相前，将 BodyState 的位置写回到对应的 Collider，刷新 AABB
     void syncBodiesToColliders();
 
+    // 若体 i 的位置自上次同步后有变化，则写入池中其 Collider 的 Owner 位置（派生量待 updateDerived），
+    // 动态体同时登记脏代理；返回是否写入
+    bool syncBodyColliders(size_t i);
+
     // 工具
     static uint64_t PairKey(EntityId a, EntityId b);
 
+    // 将 triggerHits_ 排序并压缩为每对一条记录
+    void collectTriggers();
+
+    struct ColliderRecord;
+    struct EntityRecord;
+
+    // 已注册 collider 的记录（以池 Id 直接下标）
+    ColliderRecord &record(const ColliderBase *c) { return colliderRecs_[c->poolId()]; }
+
+    const ColliderRecord &record(const ColliderBase *c) const { return colliderRecs_[c->poolId()]; }
+
+    // 实体记录；未注册时返回 nullptr
+    EntityRecord *findEntity(EntityId e);
+
+    // 删除体 bidx：末尾体换入空位并修正相关索引
+    void removeBody(int bidx);
+
 private:
-    // 稠密体数组（镜像数据，解算直接操作）
-    std::vector<BodyState> bodies_; // 索引 → 线性状态
+    // 稠密体数组（镜像数据，解算直接操作；热数据按分量分列）
+    BodyStore bodies_; // 索引 → 线性状态
     std::vector<RigidBody *> bodyRefs_; // 索引 → 原始刚体指针（写回）
     std::vector<std::vector<ColliderBase *> > collidersByBody_; // 每个体绑定的 colliders
 
-    // Collider 与实体/体索引映射
-    std::vector<ColliderBase *> colliders_; // 所有注册的 collider（供广相）
-    std::unordered_map<ColliderBase *, int> col2bodyIdx_;
-    std::unordered_map<ColliderBase *, EntityId> col2entity_;
-
-    // 广相/窄相临时
-    std::vector<ColliderPair> pairs_;
+    std::vector<EntityId> bodyOwner_; // 索引 → 创建该体的实体
+
+    // Collider 记录：按池 Id（ColliderPool 的稳定槽位，删除后复用）稠密存放，经 c->poolId() 直接访问
+    struct ColliderRecord {
+        ColliderBase *collider = nullptr;
+        EntityId entity = 0;
+        int body = -1;
+        IBroadPhase::ProxyId proxy = IBroadPhase::InvalidProxy;
+        int32_t dynamicSlot = -1; // 在 dynamicColliders_ 中的下标，静态碰撞体为 -1
+    };
+
+    std::vector<ColliderRecord> colliderRecs_;
+    std::vector<ColliderPool::Id> dynamicColliders_; // 非静态碰撞体（删除时末尾换入）
+
+    // 实体记录：稠密数组（删除时末尾换入），EntityId → 下标经分页稀疏表查询
+    struct EntityRecord {
+        EntityId id = 0;
+        int body = -1;
+        std::vector<ColliderBase *> colliders;
+    };
+
+    std::vector<EntityRecord> entityRecs_;
+    SparseIndex entityIndex_;
+
+    // 批量注册/反注册
+    int batchDepth_ = 0;
+    std::vector<int> deadBodies_; // 批量期间失去全部 collider 的体，commitBatch 时压缩
+
+    // SoA 碰撞体池：注册的 collider 绑定到池中，派生量每步批量计算，窄相按类型对批处理
+    ColliderPool pool_;
+
+    // 广相：策略对象（SAP / 空间哈希 / BVH），静态碰撞体（isStatic）由策略单独缓存
+    std::unique_ptr<IBroadPhase> broadphase_;
+    std::vector<IBroadPhase::ProxyId> dirtyProxies_; // 本步位姿有变化、需刷新 AABB 的代理（广相内去重）
+    std::vector<ColliderPair> pairs_; // 本步候选对
+    std::vector<int> ccdBodies_; // 本步走扫掠检测的体
+
+    // 每个 ccd 体本步最早的（非 trigger）扫掠接触
+    struct CcdHit {
+        float t = 2.0f; // 首次接触时刻（> 1 表示未命中）
+        size_t pair = 0;
+        ColliderBase *self = nullptr;
+        ColliderBase *other = nullptr;
+        OverlapResult contact{}; // 法线 other -> self
+    };
+
+    std::vector<CcdHit> ccdHits_; // 与 ccdBodies_ 一一对应
+
+    // 岛（每步重建）：岛 k 的体为 islandBodies_[islandBodyStart_[k], islandBodyStart_[k+1])，接触同理
+    std::vector<int> islandParent_; // 并查集
+    std::vector<int> bodyIsland_; // 体 → 岛（静态/休眠为 -1）
+    std::vector<int> islandBodyStart_;
+    std::vector<int> islandBodies_;
+    std::vector<int> islandContactStart_;
+    std::vector<int> islandContacts_; // contacts_ 下标
+    std::vector<int> islandCursor_; // 分组临时
+    IslandStats islandStats_{};
+
+    // 休眠
+    size_t sleepingCount_ = 0;
+    std::vector<uint64_t> carriedTriggers_; // 因休眠跳过检测、但上一步仍在接触的对：保持状态，不派发 Stay/Exit
+
+    BroadPhaseStats bpStats_{};
+
+    // 本步接触/触发记录：窄相、CCD 扫掠与解算接触各自追加
+    struct TriggerHit {
+        uint64_t key = 0;
+        OverlapResult contact{};
+        ColliderBase *colliderA = nullptr;
+        ColliderBase *colliderB = nullptr;
+        bool trigger = false;
+        bool weak = false; // 仅在该对尚无其他记录时采用其触点（CCD 扫掠）
+    };
+
+    // 窄相临时
+    // 每个区间的输出缓冲：区间内按对下标顺序追加，合并时按区间顺序拼接，结果与单线程逐对处理一致
+    struct NarrowPhaseBuffer {
+        ColliderPool::Batches batches;
+        std::vector<ContactItem> contacts;
+        std::vector<TriggerHit> triggers;
+        float busyMs = 0.0f;
+    };
+
+    std::unique_ptr<WorkerPool> workers_;
+    std::vector<NarrowPhaseBuffer> npBuffers_;
+    NarrowPhaseStats npStats_{};
+    std::vector<OverlapResult> overlaps_; // 与 pairs_ 一一对应
     std::vector<ContactItem> contacts_;
-    std::unordered_map<uint64_t, OverlapResult> triggerContactMap_; // 本帧触发对 -> 联系触点
 
-    // 触发器状态（帧间对比）
-    std::unordered_set<uint64_t> lastTriggers_;
-    std::unordered_set<uint64_t> currTriggers_;
+    // 接触对状态（帧间对比）：按 PairKey 升序的扁平数组，每步与上一步线性归并得到事件与新状态，随后交换
+    std::vector<TriggerHit> triggerHits_; // 本步收集（未排序、可重复）；collectTriggers 后每对一条、升序
+    std::vector<uint64_t> lastTriggers_; // 上一步结束时的接触对（升序，含因休眠保持的对）
+    std::vector<uint8_t> lastTriggerFlags_; // 与 lastTriggers_ 一一对应：是否涉及 trigger
+    std::vector<uint64_t> nextTriggers_; // 归并输出，随后与 lastTriggers_ 交换
+    std::vector<uint8_t> nextTriggerFlags_;
+
+    // 本步事件
+    std::vector<CollisionEvent> events_;
 
-    // 事件回调
-    TriggerCallback onTrigger_{};
+    // 场景查询快照
+    SceneQuery query_;
+    std::vector<SceneQuery::Entry> queryEntries_; // 重建临时
+    std::vector<SceneQuery::Entry> querySleepingEntries_; // 重建临时
+    bool queryStaticBuilt_ = false;
+    bool querySleepingDirty_ = false; // 休眠集合（或休眠碰撞体）有变化，下一次快照重建休眠树
 
     // 组件
     ContactSolver solver_;
     WorldParams params_{};
-
-    // 便捷映射：实体 → 刚体索引、实体 → 其 colliders
-    std::unordered_map<EntityId, int> entity2bodyIdx_;
-    std::unordered_map<EntityId, std::vector<ColliderBase *> > entity2colliders_;
 };
\ No newline at end of file
@@ -19,9 +19,21 @@ struct RigidBody {
     float muS = -1; // 静摩擦（预留，首版未区分）
     float muK = -1; // 动摩擦
 
+    // 连续碰撞检测（仅对球形碰撞体生效）：高速小物体（子弹）开启，防止一步穿过薄墙
+    bool ccd = false;
+
+    // 上一固定步开始时的位置（由 Scene 维护，仅用于渲染插值）
+    DirectX::XMFLOAT3 prevPosition{0, 0, 0};
+
     // 注册索引：由 PhysicsWorld 赋值（-1 表示未注册）
     int bodyIdx = -1;
 
+    // 休眠状态：由 PhysicsWorld 写回（只读）
+    bool sleeping = false;
+
+    // 游戏层经 applyImpulse 改动了速度：下一步 PhysicsWorld 以 velocity 为准并唤醒该体（由 PhysicsWorld 清除）
+    bool velocityChanged = false;
+
     bool isStatic() const { return invMass == 0.0f; }
 
     void applyForce(const DirectX::XMFLOAT3 &f) {
@@ -39,6 +51,7 @@ struct RigidBody {
         DirectX::XMVECTOR j = XMLoadFloat3(&impulse);
         v = XMVectorAdd(v, XMVectorScale(j, invMass));
         XMStoreFloat3(&velocity, v);
+        velocityChanged = true;
     }
 
     void clearForces() {
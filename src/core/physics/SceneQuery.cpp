@@ -0,0 +1,220 @@
+﻿#include "SceneQuery.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+static inline XMFLOAT3 add3(const XMFLOAT3 &a, const XMFLOAT3 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+static inline XMFLOAT3 sub3(const XMFLOAT3 &a, const XMFLOAT3 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+static inline XMFLOAT3 mul3(const XMFLOAT3 &a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+static inline float dot3(const XMFLOAT3 &a, const XMFLOAT3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static inline float len3(const XMFLOAT3 &a) { return std::sqrt(std::max(0.0f, dot3(a, a))); }
+
+namespace {
+    // 命中排序：距离优先，其次实体 id（与遍历顺序无关，结果确定）
+    bool HitBefore(const QueryHit &a, const QueryHit &b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return a.entity < b.entity;
+    }
+
+    float TargetRadius(const SweepTarget &t) {
+        return t.kind == ColliderType::Obb ? 0.0f : t.shape.radius;
+    }
+
+    // 重叠命中：目标表面上距 q 最近的点与该处外法线（q 在核心内时法线取 +Y）
+    QueryHit SurfaceHit(const SceneQuery::Entry &e, const XMFLOAT3 &q) {
+        const XMFLOAT3 core = ClosestOnCore(e.geom, q);
+        const XMFLOAT3 sep = sub3(q, core);
+        const float dist = len3(sep);
+        QueryHit hit{};
+        hit.entity = e.entity;
+        hit.trigger = e.trigger;
+        hit.normal = dist > 1e-6f ? mul3(sep, 1.0f / dist) : XMFLOAT3{0, 1, 0};
+        hit.point = add3(core, mul3(hit.normal, TargetRadius(e.geom)));
+        return hit;
+    }
+
+    ObbShape ObbOf(const SweepTarget &t) {
+        ObbShape s{};
+        s.center = t.center;
+        for (int k = 0; k < 3; ++k) s.axes[k] = t.shape.axes[k];
+        s.halfExtents = t.shape.halfExtents;
+        return s;
+    }
+
+    void SortByEntity(std::vector<QueryHit> &hits) {
+        std::stable_sort(hits.begin(), hits.end(),
+                         [](const QueryHit &a, const QueryHit &b) { return a.entity < b.entity; });
+    }
+}
+
+void SceneQuery::rebuild(Tree &tree, std::vector<Entry> &entries) {
+    tree.entries.swap(entries);
+    entries.clear();
+    std::vector<StaticBvh::Item> items;
+    items.reserve(tree.entries.size());
+    for (size_t i = 0; i < tree.entries.size(); ++i) {
+        StaticBvh::Item it{};
+        it.box = tree.entries[i].box;
+        it.proxy = static_cast<int32_t>(i);
+        items.push_back(it);
+    }
+    tree.bvh.build(std::move(items));
+}
+
+void SceneQuery::rebuildStatic(std::vector<Entry> &entries) {
+    rebuild(static_, entries);
+}
+
+void SceneQuery::rebuildSleeping(std::vector<Entry> &entries) {
+    rebuild(sleeping_, entries);
+}
+
+void SceneQuery::rebuildDynamic(std::vector<Entry> &entries) {
+    rebuild(dynamic_, entries);
+}
+
+void SceneQuery::clear() {
+    for (Tree *tree: {&static_, &sleeping_, &dynamic_}) {
+        tree->bvh.clear();
+        tree->entries.clear();
+    }
+}
+
+bool SceneQuery::accepts(const Entry &e, const QueryFilter &filter) {
+    if ((e.layer & filter.layerMask) == 0) return false;
+    if (e.trigger && !filter.includeTriggers) return false;
+    return filter.ignoreEntity == 0 || e.entity != filter.ignoreEntity;
+}
+
+size_t SceneQuery::cast(const XMFLOAT3 &origin, float radius, const XMFLOAT3 &dir, float maxDist,
+                        const QueryFilter &filter, QueryHit *closest, std::vector<QueryHit> *all) const {
+    const float len = len3(dir);
+    if (len <= 1e-12f || !(maxDist >= 0.0f)) return 0;
+    const XMFLOAT3 d = mul3(dir, 1.0f / len);
+    const XMFLOAT3 sweep = mul3(d, maxDist);
+    radius = std::max(0.0f, radius);
+
+    auto test = [&](const Entry &e, QueryHit &hit) {
+        float t = 0.0f;
+        XMFLOAT3 n{};
+        if (radius > 0.0f) {
+            XMFLOAT3 p{};
+            if (!SweepSphere(origin, sweep, radius, e.geom, t, n, p)) return false;
+            hit.distance = t * maxDist;
+            hit.point = p;
+        } else {
+            if (!RaycastShape(origin, d, maxDist, e.geom, t, n)) return false;
+            hit.distance = t;
+            hit.point = add3(origin, mul3(d, t));
+        }
+        hit.normal = n;
+        hit.entity = e.entity;
+        hit.trigger = e.trigger;
+        return true;
+    };
+
+    size_t count = 0;
+    const size_t first = all ? all->size() : 0;
+    for (const Tree *tree: {&static_, &sleeping_, &dynamic_}) {
+        // 最近命中：以当前最近距离作为遍历上限（等距仍需遍历，按实体 id 决出）
+        const float limit = closest && count > 0 ? closest->distance : maxDist;
+        tree->bvh.raycast(origin, d, limit, radius, [&](const StaticBvh::Item &it) -> float {
+            const Entry &e = tree->entries[it.proxy];
+            const float current = closest && count > 0 ? closest->distance : maxDist;
+            QueryHit hit{};
+            if (!accepts(e, filter) || !test(e, hit)) return current;
+            if (!closest) {
+                all->push_back(hit);
+                ++count;
+                return current;
+            }
+            if (count == 0 || HitBefore(hit, *closest)) *closest = hit;
+            count = 1;
+            return closest->distance;
+        });
+    }
+    if (all) std::sort(all->begin() + static_cast<std::ptrdiff_t>(first), all->end(), HitBefore);
+    return count;
+}
+
+bool SceneQuery::raycast(const XMFLOAT3 &origin, const XMFLOAT3 &dir, float maxDist,
+                         QueryHit &out, const QueryFilter &filter) const {
+    return cast(origin, 0.0f, dir, maxDist, filter, &out, nullptr) > 0;
+}
+
+size_t SceneQuery::raycastAll(const XMFLOAT3 &origin, const XMFLOAT3 &dir, float maxDist,
+                              std::vector<QueryHit> &out, const QueryFilter &filter) const {
+    out.clear();
+    return cast(origin, 0.0f, dir, maxDist, filter, nullptr, &out);
+}
+
+bool SceneQuery::sphereCast(const XMFLOAT3 &origin, float radius, const XMFLOAT3 &dir, float maxDist,
+                            QueryHit &out, const QueryFilter &filter) const {
+    return cast(origin, radius, dir, maxDist, filter, &out, nullptr) > 0;
+}
+
+size_t SceneQuery::sphereCastAll(const XMFLOAT3 &origin, float radius, const XMFLOAT3 &dir, float maxDist,
+                                 std::vector<QueryHit> &out, const QueryFilter &filter) const {
+    out.clear();
+    return cast(origin, radius, dir, maxDist, filter, nullptr, &out);
+}
+
+size_t SceneQuery::overlapSphere(const XMFLOAT3 &center, float radius,
+                                 std::vector<QueryHit> &out, const QueryFilter &filter) const {
+    out.clear();
+    const Aabb box{{center.x - radius, center.y - radius, center.z - radius},
+                   {center.x + radius, center.y + radius, center.z + radius}};
+    forEachOverlapping(box, [&](const Entry &e) {
+        if (!accepts(e, filter)) return;
+        const XMFLOAT3 sep = sub3(center, ClosestOnCore(e.geom, center));
+        const float reach = radius + TargetRadius(e.geom);
+        if (dot3(sep, sep) > reach * reach) return;
+        out.push_back(SurfaceHit(e, center));
+    });
+    SortByEntity(out);
+    return out.size();
+}
+
+size_t SceneQuery::overlapObb(const XMFLOAT3 &center, const XMFLOAT3 &halfExtents, const XMFLOAT4 &rotation,
+                              std::vector<QueryHit> &out, const QueryFilter &filter) const {
+    out.clear();
+    ObbShape q{};
+    q.center = center;
+    q.halfExtents = halfExtents;
+    const XMMATRIX R = XMMatrixRotationQuaternion(XMQuaternionNormalize(XMLoadFloat4(&rotation)));
+    XMStoreFloat3(&q.axes[0], XMVector3TransformNormal(XMVectorSet(1, 0, 0, 0), R));
+    XMStoreFloat3(&q.axes[1], XMVector3TransformNormal(XMVectorSet(0, 1, 0, 0), R));
+    XMStoreFloat3(&q.axes[2], XMVector3TransformNormal(XMVectorSet(0, 0, 1, 0), R));
+
+    const float he[3] = {halfExtents.x, halfExtents.y, halfExtents.z};
+    XMFLOAT3 ext{0, 0, 0};
+    for (int k = 0; k < 3; ++k) {
+        ext.x += std::fabs(q.axes[k].x) * he[k];
+        ext.y += std::fabs(q.axes[k].y) * he[k];
+        ext.z += std::fabs(q.axes[k].z) * he[k];
+    }
+    const Aabb box{sub3(center, ext), add3(center, ext)};
+
+    forEachOverlapping(box, [&](const Entry &e) {
+        if (!accepts(e, filter)) return;
+        OverlapResult res{};
+        switch (e.geom.kind) {
+            case ColliderType::Sphere:
+                ComputeContact(SphereShape{e.geom.center, e.geom.shape.radius}, q, res);
+                break;
+            case ColliderType::Obb:
+                ComputeContact(q, ObbOf(e.geom), res);
+                break;
+            case ColliderType::Capsule: {
+                const XMFLOAT3 &h = e.geom.shape.halfSegment;
+                ComputeContact(q, CapsuleShape{sub3(e.geom.center, h), add3(e.geom.center, h), e.geom.shape.radius},
+                               res);
+                break;
+            }
+        }
+        if (res.intersects) out.push_back(SurfaceHit(e, center));
+    });
+    SortByEntity(out);
+    return out.size();
+}
@@ -0,0 +1,113 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <cstdint>
+#include <initializer_list>
+#include <DirectXMath.h>
+
+#include "StaticBvh.hpp"
+#include "ShapeCast.hpp"
+
+// 查询过滤
+struct QueryFilter {
+    uint32_t layerMask = 0xffffffffu; // 只命中 layer() 与之按位与非零的碰撞体
+    bool includeTriggers = false; // 是否命中 trigger 碰撞体
+    uint32_t ignoreEntity = 0; // 忽略该实体的碰撞体（如发起查询的自身），0 表示不忽略
+};
+
+// 查询命中
+struct QueryHit {
+    uint32_t entity = 0;
+    float distance = 0.0f; // 射线/扫掠：沿方向的距离（起点已重叠为 0）；重叠查询为 0
+    DirectX::XMFLOAT3 point{0, 0, 0}; // 目标表面上的命中点（重叠查询为距查询中心最近的点）
+    DirectX::XMFLOAT3 normal{0, 0, 0}; // 命中点处目标的外法线（起点已在形状内时为 -dir）
+    bool trigger = false;
+};
+
+// 场景查询：射线 / 扫掠球 / 重叠，对象是 PhysicsWorld 上一次 step 结束时的状态
+// - 条目复制了世界空间几何（SweepTarget），查询不读取 Collider 与池，反注册后也不会悬空；
+// - 静态碰撞体一棵树，只在集合或位姿变化时重建；休眠体的碰撞体一棵树，只在休眠集合变化时重建；
+//   其余（醒着的）碰撞体每步重建一棵；
+// - 所有查询为 const 且只读快照，多个线程可同时调用；不得与重建（PhysicsWorld::step）并发。
+class SceneQuery {
+public:
+    struct Entry {
+        SweepTarget geom{};
+        Aabb box{};
+        uint32_t entity = 0;
+        uint32_t layer = 1;
+        bool trigger = false;
+    };
+
+    // 以 entries 重建对应的树（entries 被取走，返回时为空、保留容量）
+    void rebuildStatic(std::vector<Entry> &entries);
+
+    void rebuildSleeping(std::vector<Entry> &entries);
+
+    void rebuildDynamic(std::vector<Entry> &entries);
+
+    void clear();
+
+    size_t entryCount() const {
+        return static_.entries.size() + sleeping_.entries.size() + dynamic_.entries.size();
+    }
+
+    // 射线：dir 无需归一化（长度为 0 时不命中）；raycast 取最近命中，raycastAll 按 (distance, entity) 升序输出全部命中
+    bool raycast(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir, float maxDist,
+                 QueryHit &out, const QueryFilter &filter = {}) const;
+
+    size_t raycastAll(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir, float maxDist,
+                      std::vector<QueryHit> &out, const QueryFilter &filter = {}) const;
+
+    // 扫掠球：半径 radius 的球从 origin 沿 dir 移动至多 maxDist
+    bool sphereCast(const DirectX::XMFLOAT3 &origin, float radius, const DirectX::XMFLOAT3 &dir, float maxDist,
+                    QueryHit &out, const QueryFilter &filter = {}) const;
+
+    size_t sphereCastAll(const DirectX::XMFLOAT3 &origin, float radius, const DirectX::XMFLOAT3 &dir, float maxDist,
+                         std::vector<QueryHit> &out, const QueryFilter &filter = {}) const;
+
+    // 重叠：输出全部与查询形状相交的碰撞体（按 entity 升序），返回数量
+    size_t overlapSphere(const DirectX::XMFLOAT3 &center, float radius,
+                         std::vector<QueryHit> &out, const QueryFilter &filter = {}) const;
+
+    // rotation 为世界朝向四元数
+    size_t overlapObb(const DirectX::XMFLOAT3 &center, const DirectX::XMFLOAT3 &halfExtents,
+                      const DirectX::XMFLOAT4 &rotation,
+                      std::vector<QueryHit> &out, const QueryFilter &filter = {}) const;
+
+    // 包围盒粗测（不做形状测试、不过滤）：对非静态碰撞体中包围盒与 box 重叠者调用 fn(entity)，
+    // 同一实体有多个碰撞体时可能多次回调
+    template<typename Fn>
+    void forEachDynamicOverlapping(const Aabb &box, Fn &&fn) const {
+        for (const Tree *tree: {&sleeping_, &dynamic_}) {
+            tree->bvh.query(box, [&](const StaticBvh::Item &it) { fn(tree->entries[it.proxy].entity); });
+        }
+    }
+
+private:
+    struct Tree {
+        StaticBvh bvh;
+        std::vector<Entry> entries; // StaticBvh::Item::proxy 为此数组下标
+    };
+
+    static void rebuild(Tree &tree, std::vector<Entry> &entries);
+
+    static bool accepts(const Entry &e, const QueryFilter &filter);
+
+    // 沿 dir 的射线（radius = 0）或扫掠球：closest 非空时只保留最近命中，否则全部追加到 all
+    size_t cast(const DirectX::XMFLOAT3 &origin, float radius, const DirectX::XMFLOAT3 &dir, float maxDist,
+                const QueryFilter &filter, QueryHit *closest, std::vector<QueryHit> *all) const;
+
+    // 对与 box 重叠的条目调用 fn(const Entry&)
+    template<typename Fn>
+    void forEachOverlapping(const Aabb &box, Fn &&fn) const {
+        for (const Tree *tree: {&static_, &sleeping_, &dynamic_}) {
+            tree->bvh.query(box, [&](const StaticBvh::Item &it) { fn(tree->entries[it.proxy]); });
+        }
+    }
+
+    Tree static_;
+    Tree sleeping_;
+    Tree dynamic_;
+};
@@ -0,0 +1,173 @@
+﻿#include "ShapeCast.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+static inline XMFLOAT3 add3(const XMFLOAT3 &a, const XMFLOAT3 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+static inline XMFLOAT3 sub3(const XMFLOAT3 &a, const XMFLOAT3 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+static inline XMFLOAT3 mul3(const XMFLOAT3 &a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+static inline float dot3(const XMFLOAT3 &a, const XMFLOAT3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static inline float len3(const XMFLOAT3 &a) { return std::sqrt(std::max(0.0f, dot3(a, a))); }
+
+namespace {
+    // 射线与球（中心 c、半径 r）的首个交点 t ≥ 0
+    bool RaySphere(const XMFLOAT3 &o, const XMFLOAT3 &d, const XMFLOAT3 &c, float r, float &t) {
+        const XMFLOAT3 m = sub3(o, c);
+        const float b = dot3(m, d);
+        const float cc = dot3(m, m) - r * r;
+        if (cc > 0.0f && b > 0.0f) return false; // 在球外且背离球心
+        const float disc = b * b - cc;
+        if (disc < 0.0f) return false;
+        t = std::max(0.0f, -b - std::sqrt(disc));
+        return true;
+    }
+
+    // 射线与 OBB 的 slab 求交；起点在盒内时 outInside = true
+    bool RayObb(const XMFLOAT3 &o, const XMFLOAT3 &d, float maxT, const SweepTarget &target,
+                float &outT, XMFLOAT3 &outNormal, bool &outInside) {
+        const XMFLOAT3 m = sub3(o, target.center);
+        const float he[3] = {target.shape.halfExtents.x, target.shape.halfExtents.y, target.shape.halfExtents.z};
+        float tEnter = 0.0f;
+        float tExit = maxT;
+        int enterAxis = -1;
+        float enterSign = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            const float ok = dot3(m, target.shape.axes[k]);
+            const float dk = dot3(d, target.shape.axes[k]);
+            if (std::fabs(dk) < 1e-8f) {
+                if (std::fabs(ok) > he[k]) return false; // 平行于该 slab 且在其外
+                continue;
+            }
+            const float inv = 1.0f / dk;
+            float t1 = (-he[k] - ok) * inv;
+            float t2 = (he[k] - ok) * inv;
+            float sign = -1.0f; // 沿 +轴 前进时从 -面 进入
+            if (t1 > t2) {
+                std::swap(t1, t2);
+                sign = 1.0f;
+            }
+            if (t1 > tEnter) {
+                tEnter = t1;
+                enterAxis = k;
+                enterSign = sign;
+            }
+            tExit = std::min(tExit, t2);
+            if (tEnter > tExit) return false;
+        }
+        outInside = enterAxis < 0;
+        outT = tEnter;
+        if (!outInside) outNormal = mul3(target.shape.axes[enterAxis], enterSign);
+        return true;
+    }
+}
+
+XMFLOAT3 ClosestOnCore(const SweepTarget &t, const XMFLOAT3 &q) {
+    if (t.kind == ColliderType::Obb) {
+        const XMFLOAT3 d = sub3(q, t.center);
+        const float he[3] = {t.shape.halfExtents.x, t.shape.halfExtents.y, t.shape.halfExtents.z};
+        XMFLOAT3 r = t.center;
+        for (int k = 0; k < 3; ++k) {
+            const float s = std::clamp(dot3(d, t.shape.axes[k]), -he[k], he[k]);
+            r = add3(r, mul3(t.shape.axes[k], s));
+        }
+        return r;
+    }
+    if (t.kind == ColliderType::Capsule) {
+        const XMFLOAT3 &h = t.shape.halfSegment;
+        const float hh = dot3(h, h);
+        const float s = hh > 0.0f ? std::clamp(dot3(sub3(q, t.center), h) / hh, -1.0f, 1.0f) : 0.0f;
+        return add3(t.center, mul3(h, s));
+    }
+    return t.center;
+}
+
+bool SweepSphere(const XMFLOAT3 &q0, const XMFLOAT3 &d, float r, const SweepTarget &target,
+                 float &outT, XMFLOAT3 &outNormal, XMFLOAT3 &outPoint) {
+    constexpr int kMaxIterations = 64;
+    constexpr float kTolerance = 1e-3f;
+    const float len = len3(d);
+    const float targetRadius = target.kind == ColliderType::Obb ? 0.0f : target.shape.radius;
+    float t = 0.0f;
+    for (int it = 0; it < kMaxIterations; ++it) {
+        const XMFLOAT3 q = add3(q0, mul3(d, t));
+        const XMFLOAT3 core = ClosestOnCore(target, q);
+        const XMFLOAT3 sep = sub3(q, core);
+        const float dist = len3(sep);
+        const float gap = dist - r - targetRadius;
+        if (gap <= kTolerance) {
+            outT = t;
+            if (dist > 1e-6f) outNormal = mul3(sep, 1.0f / dist);
+            else if (len > 0.0f) outNormal = mul3(d, -1.0f / len); // 球心已在核心内：取逆运动方向
+            else outNormal = XMFLOAT3{0, 1, 0};
+            outPoint = add3(core, mul3(outNormal, targetRadius));
+            return true;
+        }
+        if (len <= 0.0f) return false;
+        t += gap / len;
+        if (t > 1.0f) return false;
+    }
+    return false; // 擦边未收敛：视为未接触
+}
+
+bool RaycastShape(const XMFLOAT3 &origin, const XMFLOAT3 &dir, float maxT, const SweepTarget &target,
+                  float &outT, XMFLOAT3 &outNormal) {
+    if (target.kind == ColliderType::Obb) {
+        bool inside = false;
+        if (!RayObb(origin, dir, maxT, target, outT, outNormal, inside)) return false;
+        if (inside) outNormal = mul3(dir, -1.0f);
+        return true;
+    }
+
+    const float r = target.shape.radius;
+    const XMFLOAT3 sep0 = sub3(origin, ClosestOnCore(target, origin));
+    if (dot3(sep0, sep0) <= r * r) {
+        outT = 0.0f;
+        outNormal = mul3(dir, -1.0f);
+        return true;
+    }
+
+    // 球：一个端点球；胶囊：两个端点球 + 侧面圆柱，取最早者
+    float best = maxT;
+    bool hit = false;
+    auto consider = [&](float t) {
+        if (t <= best) {
+            best = t;
+            hit = true;
+        }
+    };
+    float t = 0.0f;
+    if (target.kind == ColliderType::Sphere) {
+        if (RaySphere(origin, dir, target.center, r, t)) consider(t);
+    } else {
+        const XMFLOAT3 &h = target.shape.halfSegment;
+        if (RaySphere(origin, dir, sub3(target.center, h), r, t)) consider(t);
+        if (RaySphere(origin, dir, add3(target.center, h), r, t)) consider(t);
+        const float hh = dot3(h, h);
+        if (hh > 0.0f) {
+            const float halfLen = std::sqrt(hh);
+            const XMFLOAT3 axis = mul3(h, 1.0f / halfLen);
+            const XMFLOAT3 m = sub3(origin, target.center);
+            const float dPar = dot3(dir, axis);
+            const float mPar = dot3(m, axis);
+            const XMFLOAT3 dPerp = sub3(dir, mul3(axis, dPar));
+            const XMFLOAT3 mPerp = sub3(m, mul3(axis, mPar));
+            const float a = dot3(dPerp, dPerp);
+            const float b = dot3(mPerp, dPerp);
+            const float c = dot3(mPerp, mPerp) - r * r;
+            const float disc = b * b - a * c;
+            if (a > 1e-12f && disc >= 0.0f) {
+                t = (-b - std::sqrt(disc)) / a;
+                if (t >= 0.0f && std::fabs(mPar + dPar * t) <= halfLen) consider(t);
+            }
+        }
+    }
+    if (!hit) return false;
+
+    outT = best;
+    const XMFLOAT3 p = add3(origin, mul3(dir, best));
+    const XMFLOAT3 n = sub3(p, ClosestOnCore(target, p));
+    const float nl = len3(n);
+    outNormal = nl > 1e-6f ? mul3(n, 1.0f / nl) : mul3(dir, -1.0f);
+    return true;
+}
@@ -0,0 +1,27 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <DirectXMath.h>
+#include "Collider.hpp"
+#include "ColliderPool.hpp"
+
+// 世界空间形状引用：核心几何（点 / 线段 / 盒）+ 膨胀半径，直接取自池的派生量
+// 供 CCD 扫掠与场景查询使用，不经过 Collider 虚函数
+struct SweepTarget {
+    ColliderType kind = ColliderType::Sphere;
+    DirectX::XMFLOAT3 center{0, 0, 0};
+    ColliderPool::ShapeCache shape{};
+};
+
+// 目标核心上距 q 最近的点
+DirectX::XMFLOAT3 ClosestOnCore(const SweepTarget &t, const DirectX::XMFLOAT3 &q);
+
+// 保守推进：球心 q0 + d*t、半径 r 的扫掠球与目标的首次接触时刻 t ∈ [0,1]。
+// 每次前进“当前间隙 / |d|”，不会越过接触点；outNormal 为目标 → 球的单位法线，outPoint 为目标表面接触点
+bool SweepSphere(const DirectX::XMFLOAT3 &q0, const DirectX::XMFLOAT3 &d, float r, const SweepTarget &target,
+                 float &outT, DirectX::XMFLOAT3 &outNormal, DirectX::XMFLOAT3 &outPoint);
+
+// 射线 origin + dir*t（dir 为单位向量）与目标的首个交点 t ∈ [0, maxT]（解析求解）。
+// outNormal 为命中处的表面外法线；起点已在形状内时 t = 0、法线取 -dir
+bool RaycastShape(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir, float maxT,
+                  const SweepTarget &target, float &outT, DirectX::XMFLOAT3 &outNormal);
@@ -0,0 +1,53 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// 整数键 → 稠密下标的分页稀疏表（PhysicsWorld 用于 EntityId → 实体记录，EntityStorage 用于 EntityId → 池/槽位）
+// - 查询/写入/删除均为 O(1) 直接下标，无哈希；
+// - 页按需分配，页内键全部删除后释放：游戏层单调递增分配的实体 id（子弹不断生成/销毁）
+//   只会让页指针数组缓慢增长，不会保留已销毁实体的整页数据。
+class SparseIndex {
+public:
+    static constexpr uint32_t Invalid = 0xffffffffu;
+
+    uint32_t find(uint32_t key) const {
+        const size_t page = key >> PageBits;
+        if (page >= pages_.size() || !pages_[page]) return Invalid;
+        return pages_[page]->slots[key & PageMask];
+    }
+
+    void set(uint32_t key, uint32_t value) {
+        const size_t page = key >> PageBits;
+        if (page >= pages_.size()) pages_.resize(page + 1);
+        if (!pages_[page]) pages_[page] = std::make_unique<Page>();
+        uint32_t &slot = pages_[page]->slots[key & PageMask];
+        if (slot == Invalid) ++pages_[page]->live;
+        slot = value;
+    }
+
+    void erase(uint32_t key) {
+        const size_t page = key >> PageBits;
+        if (page >= pages_.size() || !pages_[page]) return;
+        uint32_t &slot = pages_[page]->slots[key & PageMask];
+        if (slot == Invalid) return;
+        slot = Invalid;
+        if (--pages_[page]->live == 0) pages_[page].reset();
+    }
+
+private:
+    static constexpr uint32_t PageBits = 10;
+    static constexpr uint32_t PageSize = 1u << PageBits;
+    static constexpr uint32_t PageMask = PageSize - 1;
+
+    struct Page {
+        uint32_t live = 0;
+        uint32_t slots[PageSize];
+
+        Page() { for (auto &s: slots) s = Invalid; }
+    };
+
+    std::vector<std::unique_ptr<Page> > pages_;
+};
@@ -0,0 +1,84 @@
+﻿#include "StaticBvh.hpp"
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace {
+    inline Aabb merge(const Aabb &a, const Aabb &b) {
+        return Aabb{
+            XMFLOAT3{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+            XMFLOAT3{std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)}
+        };
+    }
+
+    inline float centroid(const Aabb &b, int axis) {
+        switch (axis) {
+            case 0: return (b.min.x + b.max.x) * 0.5f;
+            case 1: return (b.min.y + b.max.y) * 0.5f;
+            default: return (b.min.z + b.max.z) * 0.5f;
+        }
+    }
+}
+
+void StaticBvh::clear() {
+    nodes_.clear();
+    items_.clear();
+}
+
+void StaticBvh::build(std::vector<Item> items) {
+    clear();
+    // 规范化（确保 min <= max）
+    for (auto &it: items) {
+        Aabb &b = it.box;
+        b = Aabb{
+            XMFLOAT3{std::min(b.min.x, b.max.x), std::min(b.min.y, b.max.y), std::min(b.min.z, b.max.z)},
+            XMFLOAT3{std::max(b.min.x, b.max.x), std::max(b.min.y, b.max.y), std::max(b.min.z, b.max.z)}
+        };
+    }
+    items_ = std::move(items);
+    if (items_.empty()) return;
+    nodes_.reserve(items_.size() * 2 / LeafSize + 1);
+    buildRecursive(0, static_cast<int32_t>(items_.size()), 0);
+}
+
+int32_t StaticBvh::buildRecursive(int32_t first, int32_t count, int depth) {
+    const int32_t index = static_cast<int32_t>(nodes_.size());
+    nodes_.emplace_back();
+
+    Aabb box = items_[first].box;
+    Aabb cbox{XMFLOAT3{centroid(box, 0), centroid(box, 1), centroid(box, 2)},
+              XMFLOAT3{centroid(box, 0), centroid(box, 1), centroid(box, 2)}};
+    for (int32_t i = first + 1; i < first + count; ++i) {
+        const Aabb &b = items_[i].box;
+        box = merge(box, b);
+        Aabb c{XMFLOAT3{centroid(b, 0), centroid(b, 1), centroid(b, 2)},
+               XMFLOAT3{centroid(b, 0), centroid(b, 1), centroid(b, 2)}};
+        cbox = merge(cbox, c);
+    }
+    nodes_[index].box = box;
+
+    // 深度上限与查询栈大小匹配（中位数划分下 2^30 个条目才会触及）
+    if (count <= LeafSize || depth >= 30) {
+        nodes_[index].first = first;
+        nodes_[index].count = count;
+        return index;
+    }
+
+    // 按质心包围盒最长轴的中位数划分
+    const float ex = cbox.max.x - cbox.min.x;
+    const float ey = cbox.max.y - cbox.min.y;
+    const float ez = cbox.max.z - cbox.min.z;
+    const int axis = (ex >= ey && ex >= ez) ? 0 : (ey >= ez ? 1 : 2);
+
+    const int32_t half = count / 2;
+    auto begin = items_.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [axis](const Item &a, const Item &b) {
+        return centroid(a.box, axis) < centroid(b.box, axis);
+    });
+
+    buildRecursive(first, half, depth + 1);
+    const int32_t right = buildRecursive(first + half, count - half, depth + 1);
+    nodes_[index].right = right;
+    nodes_[index].count = 0;
+    return index;
+}
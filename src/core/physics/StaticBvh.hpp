@@ -0,0 +1,131 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "Collider.hpp"
+
+// 批量构建的 BVH（一次性构建，只读查询）
+// 设计要点：
+// - 主要存放永不移动的静态碰撞体（地面方块、围墙、斜坡）；Bvh 广相与场景查询也用它每步重建动态树；
+// - 集合变化时整体重建（自顶向下、按质心包围盒最长轴中位数划分），运行期不做增量维护；
+// - 节点按深度优先顺序平铺在数组中：左子节点紧随父节点，右子节点下标记录在节点里。
+class StaticBvh {
+public:
+    struct Item {
+        Aabb box{};
+        ColliderBase *collider = nullptr;
+        int32_t proxy = -1; // 调用方自定义标识（如广相代理 id）
+    };
+
+    // 以给定条目重建整棵树（条目会被复制并重排）
+    void build(std::vector<Item> items);
+
+    void clear();
+
+    bool empty() const { return nodes_.empty(); }
+    size_t itemCount() const { return items_.size(); }
+    size_t nodeCount() const { return nodes_.size(); }
+
+    // 查询与 box 重叠的所有条目，对每个命中调用 fn(const Item&)
+    template<typename Fn>
+    void query(const Aabb &box, Fn &&fn) const {
+        if (nodes_.empty()) return;
+        int32_t stack[64];
+        int sp = 0;
+        stack[sp++] = 0;
+        while (sp > 0) {
+            const Node &n = nodes_[stack[--sp]];
+            if (!overlaps(n.box, box)) continue;
+            if (n.count > 0) {
+                for (int32_t i = 0; i < n.count; ++i) {
+                    const Item &it = items_[n.first + i];
+                    if (overlaps(it.box, box)) fn(it);
+                }
+            } else {
+                // 左子节点紧随其后；先压右再压左，保证遍历顺序稳定
+                if (sp + 2 > 64) continue;
+                stack[sp++] = n.right;
+                stack[sp++] = static_cast<int32_t>(&n - nodes_.data()) + 1;
+            }
+        }
+    }
+
+    // 沿线段 origin + dir*t（t ∈ [0, maxT]）遍历包围盒（各向外扩 inflate，用于扫掠球）与之相交的条目，
+    // 对每个命中调用 fn(const Item&)；fn 返回新的 maxT：最近命中查询借此剪掉更远的节点，收集全部命中时原样返回
+    template<typename Fn>
+    void raycast(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir, float maxT, float inflate, Fn &&fn) const {
+        if (nodes_.empty()) return;
+        const Ray ray{{origin.x, origin.y, origin.z}, {dir.x, dir.y, dir.z},
+                      {dir.x != 0.0f ? 1.0f / dir.x : 0.0f, dir.y != 0.0f ? 1.0f / dir.y : 0.0f,
+                       dir.z != 0.0f ? 1.0f / dir.z : 0.0f}, inflate};
+        int32_t stack[64];
+        int sp = 0;
+        stack[sp++] = 0;
+        while (sp > 0) {
+            const Node &n = nodes_[stack[--sp]];
+            if (!ray.hits(n.box, maxT)) continue;
+            if (n.count > 0) {
+                for (int32_t i = 0; i < n.count; ++i) {
+                    const Item &it = items_[n.first + i];
+                    if (ray.hits(it.box, maxT)) maxT = fn(it);
+                }
+            } else {
+                if (sp + 2 > 64) continue;
+                stack[sp++] = n.right;
+                stack[sp++] = static_cast<int32_t>(&n - nodes_.data()) + 1;
+            }
+        }
+    }
+
+    static bool overlaps(const Aabb &a, const Aabb &b) {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+               a.min.y <= b.max.y && b.min.y <= a.max.y &&
+               a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+
+private:
+    struct Node {
+        Aabb box{};
+        int32_t right = -1; // 内部节点：右子节点下标
+        int32_t first = 0; // 叶节点：首个条目下标
+        int32_t count = 0; // 叶节点条目数（0 表示内部节点）
+    };
+
+    // slab 测试用的射线参数（分量为 0 的方向不取倒数，按“起点是否在该 slab 内”判断）
+    struct Ray {
+        float o[3];
+        float d[3];
+        float inv[3];
+        float inflate;
+
+        bool hits(const Aabb &box, float maxT) const {
+            const float lo[3] = {box.min.x - inflate, box.min.y - inflate, box.min.z - inflate};
+            const float hi[3] = {box.max.x + inflate, box.max.y + inflate, box.max.z + inflate};
+            float t0 = 0.0f;
+            float t1 = maxT;
+            for (int k = 0; k < 3; ++k) {
+                if (d[k] == 0.0f) {
+                    if (o[k] < lo[k] || o[k] > hi[k]) return false;
+                    continue;
+                }
+                float a = (lo[k] - o[k]) * inv[k];
+                float b = (hi[k] - o[k]) * inv[k];
+                if (a > b) std::swap(a, b);
+                t0 = std::max(t0, a);
+                t1 = std::min(t1, b);
+                if (t0 > t1) return false;
+            }
+            return true;
+        }
+    };
+
+    static constexpr int32_t LeafSize = 4;
+
+    int32_t buildRecursive(int32_t first, int32_t count, int depth);
+
+    std::vector<Node> nodes_;
+    std::vector<Item> items_;
+};
@@ -0,0 +1,312 @@
+﻿#include "SweepAndPrune.hpp"
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace {
+    // 规范化（确保 min <= max）
+    inline Aabb normalized(const Aabb &b) {
+        return Aabb{
+            XMFLOAT3{std::min(b.min.x, b.max.x), std::min(b.min.y, b.max.y), std::min(b.min.z, b.max.z)},
+            XMFLOAT3{std::max(b.min.x, b.max.x), std::max(b.min.y, b.max.y), std::max(b.min.z, b.max.z)}
+        };
+    }
+
+    inline float axisMin(const Aabb &b, int axis) { return axis == 0 ? b.min.x : axis == 1 ? b.min.y : b.min.z; }
+    inline float axisMax(const Aabb &b, int axis) { return axis == 0 ? b.max.x : axis == 1 ? b.max.y : b.max.z; }
+}
+
+bool SweepAndPrune::overlaps(const Proxy &a, const Proxy &b) const {
+    return a.box.min.x <= b.box.max.x && b.box.min.x <= a.box.max.x &&
+           a.box.min.y <= b.box.max.y && b.box.min.y <= a.box.max.y &&
+           a.box.min.z <= b.box.max.z && b.box.min.z <= a.box.max.z;
+}
+
+void SweepAndPrune::setEndpointIndex(const Endpoint &e, int axis, uint32_t idx) {
+    Proxy &p = proxies_[owner(e)];
+    if (isMax(e)) p.maxIdx[axis] = idx;
+    else p.minIdx[axis] = idx;
+}
+
+SweepAndPrune::ProxyId SweepAndPrune::allocProxy() {
+    ProxyId id;
+    if (!freeList_.empty()) {
+        id = freeList_.back();
+        freeList_.pop_back();
+    } else {
+        id = static_cast<ProxyId>(proxies_.size());
+        proxies_.emplace_back();
+    }
+    return id;
+}
+
+void SweepAndPrune::reindexAxis(int axis, size_t from) {
+    auto &ep = axes_[axis];
+    for (size_t i = from; i < ep.size(); ++i) {
+        setEndpointIndex(ep[i], axis, static_cast<uint32_t>(i));
+    }
+}
+
+SweepAndPrune::ProxyId SweepAndPrune::addProxy(ColliderBase *collider, const Aabb &box, bool isStatic,
+                                               const CollisionFilter &filter) {
+    const ProxyId id = allocProxy();
+
+    Proxy &p = proxies_[id];
+    p.box = normalized(box);
+    p.collider = collider;
+    p.filter = filter;
+    p.isStatic = isStatic;
+    p.alive = true;
+
+    // 二分定位插入点，插入后修正被挤后的端点下标
+    noteExtent(p.box);
+    for (int axis = 0; axis < 3; ++axis) {
+        auto &ep = axes_[axis];
+        Endpoint mn{axisMin(p.box, axis), static_cast<uint32_t>(id) << 1};
+        Endpoint mx{axisMax(p.box, axis), (static_cast<uint32_t>(id) << 1) | 1u};
+
+        auto itMin = std::upper_bound(ep.begin(), ep.end(), mn, endpointLess);
+        size_t iMin = static_cast<size_t>(itMin - ep.begin());
+        ep.insert(itMin, mn);
+        auto itMax = std::upper_bound(ep.begin() + static_cast<std::ptrdiff_t>(iMin) + 1, ep.end(), mx, endpointLess);
+        ep.insert(itMax, mx);
+        reindexAxis(axis, iMin);
+    }
+
+    // 初始重叠对：与新代理 X 区间重叠的代理，其 min 必落在 [新 min - 最大 X 宽度, 新 max] 内；
+    // 只扫描 X 轴上这一窗口内的 min 端点（其余两轴由 tryAddPair 判定）
+    const auto &ex = axes_[0];
+    // 窗口略放宽以抵消宽度相减的舍入，精确判定由 tryAddPair 完成
+    const float reach = maxExtentX_ * 1.0001f + 1e-4f;
+    const Endpoint lo{p.box.min.x - reach, 0u}; // min 端点：值相等的端点都不排在它之前
+    auto it = std::lower_bound(ex.begin(), ex.end(), lo, endpointLess);
+    const auto end = ex.begin() + p.maxIdx[0];
+    for (; it < end; ++it) {
+        if (isMax(*it) || owner(*it) == id) continue;
+        tryAddPair(id, owner(*it));
+    }
+    return id;
+}
+
+void SweepAndPrune::removeProxy(ProxyId id) {
+    if (id < 0 || id >= static_cast<ProxyId>(proxies_.size()) || !proxies_[id].alive) return;
+    Proxy &p = proxies_[id];
+
+    // 先移除相关重叠对（倒序扫描，交换删除不影响未扫描部分）
+    for (size_t i = pairs_.size(); i-- > 0;) {
+        const ProxyPair pr = pairs_[i];
+        if (pr.a == id || pr.b == id) removePair(pr.a, pr.b);
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        auto &ep = axes_[axis];
+        uint32_t iMin = p.minIdx[axis];
+        uint32_t iMax = p.maxIdx[axis];
+        ep.erase(ep.begin() + iMax);
+        ep.erase(ep.begin() + iMin);
+        reindexAxis(axis, iMin);
+    }
+
+    p = Proxy{};
+    freeList_.push_back(id);
+    if (proxyCount() == 0) maxExtentX_ = 0.0f;
+}
+
+void SweepAndPrune::addProxies(const std::vector<ProxyDesc> &descs, std::vector<ProxyId> &outIds) {
+    outIds.clear();
+    if (descs.empty()) return;
+    outIds.reserve(descs.size());
+
+    std::vector<uint8_t> isNew(proxies_.size() + descs.size(), 0);
+    for (const auto &d: descs) {
+        const ProxyId id = allocProxy();
+        Proxy &p = proxies_[id];
+        p.box = normalized(d.box);
+        noteExtent(p.box);
+        p.collider = d.collider;
+        p.filter = d.filter;
+        p.isStatic = d.isStatic;
+        p.alive = true;
+        isNew[id] = 1;
+        outIds.push_back(id);
+    }
+
+    // 新端点单独排序后归并到各轴末尾（稳定：与逐个插入一致，值相同的新端点排在原有端点之后）
+    std::vector<Endpoint> added;
+    added.reserve(outIds.size() * 2);
+    for (int axis = 0; axis < 3; ++axis) {
+        auto &ep = axes_[axis];
+        added.clear();
+        for (ProxyId id: outIds) {
+            const Proxy &p = proxies_[id];
+            added.push_back(Endpoint{axisMin(p.box, axis), static_cast<uint32_t>(id) << 1});
+            added.push_back(Endpoint{axisMax(p.box, axis), (static_cast<uint32_t>(id) << 1) | 1u});
+        }
+        std::stable_sort(added.begin(), added.end(), endpointLess);
+        const size_t oldSize = ep.size();
+        ep.insert(ep.end(), added.begin(), added.end());
+        std::inplace_merge(ep.begin(), ep.begin() + static_cast<std::ptrdiff_t>(oldSize), ep.end(), endpointLess);
+        reindexAxis(axis, 0);
+    }
+
+    // 初始重叠对：沿 X 轴扫掠，只检查至少一方为新代理的区间重叠（其余两轴由 tryAddPair 判定）
+    std::vector<ProxyId> active;
+    std::vector<uint32_t> activePos(proxies_.size(), 0);
+    for (const Endpoint &e: axes_[0]) {
+        const ProxyId self = owner(e);
+        if (isMax(e)) {
+            // 交换删除
+            const uint32_t pos = activePos[self];
+            active[pos] = active.back();
+            activePos[active[pos]] = pos;
+            active.pop_back();
+            continue;
+        }
+        for (ProxyId other: active) {
+            if (isNew[self] || isNew[other]) tryAddPair(self, other);
+        }
+        activePos[self] = static_cast<uint32_t>(active.size());
+        active.push_back(self);
+    }
+}
+
+void SweepAndPrune::removeProxies(const std::vector<ProxyId> &ids) {
+    std::vector<ProxyId> removed;
+    removed.reserve(ids.size());
+    for (ProxyId id: ids) {
+        if (id < 0 || id >= static_cast<ProxyId>(proxies_.size()) || !proxies_[id].alive) continue;
+        proxies_[id].alive = false; // 先标记，下面按标记统一清理（重复 id 只记一次）
+        removed.push_back(id);
+    }
+    if (removed.empty()) return;
+
+    // 涉及被移除代理的重叠对（倒序扫描，交换删除不影响未扫描部分）
+    for (size_t i = pairs_.size(); i-- > 0;) {
+        const ProxyPair pr = pairs_[i];
+        if (!proxies_[pr.a].alive || !proxies_[pr.b].alive) removePair(pr.a, pr.b);
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        auto &ep = axes_[axis];
+        ep.erase(std::remove_if(ep.begin(), ep.end(), [this](const Endpoint &e) {
+            return !proxies_[owner(e)].alive;
+        }), ep.end());
+        reindexAxis(axis, 0);
+    }
+
+    for (ProxyId id: removed) {
+        proxies_[id] = Proxy{};
+        freeList_.push_back(id);
+    }
+    if (proxyCount() == 0) maxExtentX_ = 0.0f;
+}
+
+void SweepAndPrune::updateProxy(ProxyId id, const Aabb &box) {
+    if (id < 0 || id >= static_cast<ProxyId>(proxies_.size()) || !proxies_[id].alive) return;
+    Proxy &p = proxies_[id];
+    const Aabb nb = normalized(box);
+    const Aabb old = p.box;
+    // 先整体写入新包围盒，重叠判定始终使用最终值（逐轴排序时交换顺序不影响结果）
+    p.box = nb;
+    noteExtent(nb);
+
+    for (int axis = 0; axis < 3; ++axis) {
+        auto &ep = axes_[axis];
+        const float newMin = axisMin(nb, axis);
+        const float newMax = axisMax(nb, axis);
+        const float dMin = newMin - axisMin(old, axis);
+        const float dMax = newMax - axisMax(old, axis);
+        if (dMin == 0.0f && dMax == 0.0f) continue;
+
+        ep[p.minIdx[axis]].value = newMin;
+        ep[p.maxIdx[axis]].value = newMax;
+
+        // 扩张方向先行，保证自身 min 始终排在 max 之前
+        if (dMin < 0.0f) sortDown(axis, p.minIdx[axis]);
+        if (dMax > 0.0f) sortUp(axis, p.maxIdx[axis]);
+        if (dMin > 0.0f) sortUp(axis, p.minIdx[axis]);
+        if (dMax < 0.0f) sortDown(axis, p.maxIdx[axis]);
+    }
+}
+
+void SweepAndPrune::sortDown(int axis, uint32_t idx) {
+    auto &ep = axes_[axis];
+    const Endpoint e = ep[idx];
+    const ProxyId self = owner(e);
+    while (idx > 0 && endpointLess(e, ep[idx - 1])) {
+        const Endpoint prev = ep[idx - 1];
+        const ProxyId other = owner(prev);
+        if (!isMax(e) && isMax(prev)) {
+            // 自身 min 左移越过对方 max：本轴开始重叠
+            tryAddPair(self, other);
+        } else if (isMax(e) && !isMax(prev)) {
+            // 自身 max 左移越过对方 min：本轴分离
+            removePair(self, other);
+        }
+        ep[idx] = prev;
+        setEndpointIndex(prev, axis, idx);
+        --idx;
+    }
+    ep[idx] = e;
+    setEndpointIndex(e, axis, idx);
+}
+
+void SweepAndPrune::sortUp(int axis, uint32_t idx) {
+    auto &ep = axes_[axis];
+    const Endpoint e = ep[idx];
+    const ProxyId self = owner(e);
+    const uint32_t last = static_cast<uint32_t>(ep.size()) - 1;
+    while (idx < last && endpointLess(ep[idx + 1], e)) {
+        const Endpoint next = ep[idx + 1];
+        const ProxyId other = owner(next);
+        if (isMax(e) && !isMax(next)) {
+            // 自身 max 右移越过对方 min：本轴开始重叠
+            tryAddPair(self, other);
+        } else if (!isMax(e) && isMax(next)) {
+            // 自身 min 右移越过对方 max：本轴分离
+            removePair(self, other);
+        }
+        ep[idx] = next;
+        setEndpointIndex(next, axis, idx);
+        ++idx;
+    }
+    ep[idx] = e;
+    setEndpointIndex(e, axis, idx);
+}
+
+void SweepAndPrune::tryAddPair(ProxyId a, ProxyId b) {
+    if (a == b) return;
+    const Proxy &pa = proxies_[a];
+    const Proxy &pb = proxies_[b];
+    // 优化：跳过静态-静态碰撞对
+    if (pa.isStatic && pb.isStatic) return;
+    if (!overlaps(pa, pb)) return;
+
+    const uint64_t key = PairTable::makeKey(a, b);
+    if (pairIndex_.contains(key)) return;
+
+    ProxyPair pr{std::min(a, b), std::max(a, b)};
+    pairIndex_.insert(key, static_cast<uint32_t>(pairs_.size()));
+    pairs_.push_back(pr);
+    events_.push_back(PairEvent{PairEventType::Added, pr.a, pr.b});
+}
+
+void SweepAndPrune::removePair(ProxyId a, ProxyId b) {
+    if (a == b) return;
+    const uint64_t key = PairTable::makeKey(a, b);
+    const uint32_t *found = pairIndex_.find(key);
+    if (!found) return;
+
+    const uint32_t idx = *found;
+    const ProxyPair pr = pairs_[idx];
+    pairIndex_.erase(key);
+
+    // 交换到末尾并弹出
+    const uint32_t lastIdx = static_cast<uint32_t>(pairs_.size()) - 1;
+    if (idx != lastIdx) {
+        pairs_[idx] = pairs_[lastIdx];
+        pairIndex_.insert(PairTable::makeKey(pairs_[idx].a, pairs_[idx].b), idx);
+    }
+    pairs_.pop_back();
+    events_.push_back(PairEvent{PairEventType::Removed, pr.a, pr.b});
+}
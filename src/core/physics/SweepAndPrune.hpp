@@ -0,0 +1,143 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "Collider.hpp"
+#include "PairTable.hpp"
+
+// 持久化三轴 Sweep & Prune 广相
+// 设计要点：
+// - X/Y/Z 三轴各维护一条按值排序的端点数组（min/max），帧间保留不重建；
+// - 物体移动后只修改自身端点并用插入排序就地修正（帧间相干性好时接近 O(n)）；
+// - 端点相互越过时增量维护重叠对：min 越过他人 max 可能开始重叠，max 越过他人 min 则必然分离；
+// - 重叠对集合常驻，变化以“新增/移除”事件形式对外暴露，不再每帧重新生成；
+// - 重叠对不按碰撞过滤剔除（过滤变化时无需重算），调用方输出时以 filter() 判断。
+class SweepAndPrune {
+public:
+    using ProxyId = int32_t;
+    static constexpr ProxyId InvalidProxy = -1;
+
+    // 当前重叠对（a < b）
+    struct ProxyPair {
+        ProxyId a = InvalidProxy;
+        ProxyId b = InvalidProxy;
+    };
+
+    enum class PairEventType { Added, Removed };
+
+    // 重叠对变化事件（按发生顺序记录，调用方消费后 clearEvents()）
+    struct PairEvent {
+        PairEventType type = PairEventType::Added;
+        ProxyId a = InvalidProxy;
+        ProxyId b = InvalidProxy;
+    };
+
+    // 插入一个代理；isStatic 为 true 的代理之间不产生重叠对
+    ProxyId addProxy(ColliderBase *collider, const Aabb &box, bool isStatic, const CollisionFilter &filter);
+
+    // 移除代理，并移除（同时记录事件）它参与的所有重叠对
+    void removeProxy(ProxyId id);
+
+    // 以新的 AABB 更新代理，插入排序修正三轴端点并增量维护重叠对
+    void updateProxy(ProxyId id, const Aabb &box);
+
+    // 批量插入描述
+    struct ProxyDesc {
+        ColliderBase *collider = nullptr;
+        Aabb box{};
+        bool isStatic = false;
+        CollisionFilter filter{};
+    };
+
+    // 批量插入：新端点排序后与现有端点归并、每轴只重建一次下标，初始重叠对由一次 X 轴扫掠求出。
+    // outIds[i] 对应 descs[i]
+    void addProxies(const std::vector<ProxyDesc> &descs, std::vector<ProxyId> &outIds);
+
+    // 批量移除：重叠对与三轴端点各只扫描/压缩一次
+    void removeProxies(const std::vector<ProxyId> &ids);
+
+    ColliderBase *collider(ProxyId id) const { return proxies_[id].collider; }
+    const Aabb &bounds(ProxyId id) const { return proxies_[id].box; }
+    const CollisionFilter &filter(ProxyId id) const { return proxies_[id].filter; }
+
+    void setFilter(ProxyId id, const CollisionFilter &filter) { proxies_[id].filter = filter; }
+
+    // 休眠标记只供调用方输出时判断，不影响端点排序与重叠对维护
+    bool sleeping(ProxyId id) const { return proxies_[id].sleeping; }
+    void setSleeping(ProxyId id, bool sleeping) { proxies_[id].sleeping = sleeping; }
+
+    const std::vector<ProxyPair> &pairs() const { return pairs_; }
+    const std::vector<PairEvent> &events() const { return events_; }
+    void clearEvents() { events_.clear(); }
+
+    size_t proxyCount() const { return proxies_.size() - freeList_.size(); }
+
+    // 按代理 id 升序遍历存活代理：fn(ProxyId, ColliderBase*, const Aabb&)
+    template<typename Fn>
+    void forEachProxy(Fn &&fn) const {
+        for (ProxyId id = 0; id < static_cast<ProxyId>(proxies_.size()); ++id) {
+            const Proxy &p = proxies_[id];
+            if (p.alive) fn(id, p.collider, p.box);
+        }
+    }
+
+private:
+    // 端点：data 低位为 1 表示 max，其余位为代理 id
+    struct Endpoint {
+        float value = 0.0f;
+        uint32_t data = 0;
+    };
+
+    struct Proxy {
+        Aabb box{};
+        ColliderBase *collider = nullptr;
+        uint32_t minIdx[3]{0, 0, 0};
+        uint32_t maxIdx[3]{0, 0, 0};
+        CollisionFilter filter{};
+        bool isStatic = false;
+        bool sleeping = false;
+        bool alive = false;
+    };
+
+    ProxyId allocProxy();
+
+    void reindexAxis(int axis, size_t from);
+
+    static bool isMax(const Endpoint &e) { return (e.data & 1u) != 0; }
+    static ProxyId owner(const Endpoint &e) { return static_cast<ProxyId>(e.data >> 1); }
+
+    // 排序规则：按值升序，值相等时 min 排在 max 之前（与闭区间重叠判定一致）
+    static bool endpointLess(const Endpoint &a, const Endpoint &b) {
+        if (a.value != b.value) return a.value < b.value;
+        return !isMax(a) && isMax(b);
+    }
+
+    bool overlaps(const Proxy &a, const Proxy &b) const;
+
+    void setEndpointIndex(const Endpoint &e, int axis, uint32_t idx);
+
+    void sortDown(int axis, uint32_t idx);
+
+    void sortUp(int axis, uint32_t idx);
+
+    void tryAddPair(ProxyId a, ProxyId b);
+
+    void removePair(ProxyId a, ProxyId b);
+
+    void noteExtent(const Aabb &box) { maxExtentX_ = std::max(maxExtentX_, box.max.x - box.min.x); }
+
+private:
+    std::vector<Endpoint> axes_[3];
+    std::vector<Proxy> proxies_;
+    std::vector<ProxyId> freeList_;
+    // 曾出现过的最大 X 宽度（只增不减，代理清空时归零）：单个插入据此限定求初始重叠对的扫描窗口
+    float maxExtentX_ = 0.0f;
+
+    // 重叠对：稠密数组 + key→下标（开放寻址表，交换删除保持 O(1)）
+    std::vector<ProxyPair> pairs_;
+    PairTable pairIndex_;
+    std::vector<PairEvent> events_;
+};
@@ -1,12 +1,130 @@
 ﻿#pragma once
 #include <cmath>
+#include <cstdint>
+#include <vector>
 #include <DirectXMath.h>
 
+// 欧拉角 (pitch, yaw, roll，弧度) → 四元数
+inline DirectX::XMFLOAT4 QuaternionFromEuler(const DirectX::XMFLOAT3 &euler) {
+    using namespace DirectX;
+    XMFLOAT4 q;
+    XMStoreFloat4(&q, XMQuaternionRotationRollPitchYaw(euler.x, euler.y, euler.z));
+    return q;
+}
+
+// 四元数 → 欧拉角 (pitch, yaw, roll)，与 XMQuaternionRotationRollPitchYaw 互逆
+inline DirectX::XMFLOAT3 EulerFromQuaternion(const DirectX::XMFLOAT4 &q) {
+    const float qx = q.x, qy = q.y, qz = q.z, qw = q.w;
+
+    // Pitch (X-axis)
+    float sinp = 2.0f * (qw * qx - qy * qz);
+    float pitch;
+    if (std::abs(sinp) >= 1.0f)
+        pitch = std::copysign(DirectX::XM_PIDIV2, sinp); // ±90°
+    else
+        pitch = std::asin(sinp);
+
+    // Yaw (Y-axis)
+    float siny_cosp = 2.0f * (qw * qy + qx * qz);
+    float cosy_cosp = 1.0f - 2.0f * (qx * qx + qy * qy);
+    float yaw = std::atan2(siny_cosp, cosy_cosp);
+
+    // Roll (Z-axis)
+    float sinr_cosp = 2.0f * (qw * qz + qx * qy);
+    float cosr_cosp = 1.0f - 2.0f * (qx * qx + qz * qz);
+    float roll = std::atan2(sinr_cosp, cosr_cosp);
+
+    return DirectX::XMFLOAT3{pitch, yaw, roll};
+}
+
 // Standalone Transform container
+// 成员函数修改位姿时置 dirty，Scene 据此只把变动过的实体同步进物理世界；
+// 直接写字段不会置位（仅限实体生成前的初始化，或调用方随后自行 markDirty()）。
+// 调试版记录最近一次同步的位姿，Scene 每步检查未置 dirty 的实体位姿未被直接改写
 struct Transform {
     DirectX::XMFLOAT3 position{0, 0, 0};
     DirectX::XMFLOAT4 rotation{0, 0, 0, 1}; // quaternion (x, y, z, w)
     DirectX::XMFLOAT3 scale{1, 1, 1};
+    bool dirty = false;
+
+    // 变动登记：Scene 注册实体时挂上。dirty 由 false 变 true 时把 owner（实体 id）追加到 changes，
+    // Scene 每步只同步列表里的实体。登记关系属于所在实体，拷贝/赋值只复制位姿与 dirty
+    std::vector<uint32_t> *changes = nullptr;
+    uint32_t owner = 0;
+
+#ifndef NDEBUG
+    DirectX::XMFLOAT3 syncedPosition{0, 0, 0};
+    DirectX::XMFLOAT4 syncedRotation{0, 0, 0, 1};
+#endif
+
+    Transform() = default;
+
+    static bool SameFloat3(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    static bool SameFloat4(const DirectX::XMFLOAT4 &a, const DirectX::XMFLOAT4 &b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+    }
+
+    Transform(const Transform &o) : position(o.position), rotation(o.rotation), scale(o.scale), dirty(o.dirty) {
+    }
+
+    // 赋值不清除 dirty：位姿有变化（或来源本身待同步）时登记，已登记的同步照常进行
+    Transform &operator=(const Transform &o) {
+        const bool changed = !SameFloat3(position, o.position) || !SameFloat4(rotation, o.rotation) ||
+                             !SameFloat3(scale, o.scale);
+        position = o.position;
+        rotation = o.rotation;
+        scale = o.scale;
+        if (changed || o.dirty) markDirty();
+        return *this;
+    }
+
+    void markDirty() {
+        if (dirty) return;
+        dirty = true;
+        if (changes) changes->push_back(owner);
+    }
+
+    // 已与物理世界一致：清除 dirty（调试版同时记录此刻位姿）
+    void markSynced() {
+        dirty = false;
+#ifndef NDEBUG
+        syncedPosition = position;
+        syncedRotation = rotation;
+#endif
+    }
+
+    // 物理写回位置：来自物理本身，不置 dirty
+    void setPositionFromPhysics(const DirectX::XMFLOAT3 &p) {
+        position = p;
+#ifndef NDEBUG
+        if (!dirty) syncedPosition = p;
+#endif
+    }
+
+#ifndef NDEBUG
+    // 未置 dirty 时位姿应与最近一次同步一致；不一致说明注册后直接改写了字段
+    bool matchesSynced() const {
+        return dirty || (SameFloat3(position, syncedPosition) && SameFloat4(rotation, syncedRotation));
+    }
+#endif
+
+    void setPosition(const DirectX::XMFLOAT3 &p) {
+        position = p;
+        markDirty();
+    }
+
+    void setRotation(const DirectX::XMFLOAT4 &q) {
+        rotation = q;
+        markDirty();
+    }
+
+    void setScale(const DirectX::XMFLOAT3 &s) {
+        scale = s;
+        markDirty();
+    }
 
     DirectX::XMMATRIX world() const {
         using namespace DirectX;
@@ -36,40 +154,18 @@ struct Transform {
         using namespace DirectX;
         XMVECTOR quat = XMQuaternionRotationRollPitchYaw(pitch, yaw, roll);
         XMStoreFloat4(&rotation, quat);
+        markDirty();
     }
 
     DirectX::XMFLOAT3 getRotationEuler() const {
-        using namespace DirectX;
-        XMVECTOR quat = XMLoadFloat4(&rotation);
-
-        // 四元数转欧拉角 (Roll-Pitch-Yaw)
-        float qx = rotation.x, qy = rotation.y, qz = rotation.z, qw = rotation.w;
-
-        // Pitch (X-axis)
-        float sinp = 2.0f * (qw * qx - qy * qz);
-        float pitch;
-        if (std::abs(sinp) >= 1.0f)
-            pitch = std::copysign(DirectX::XM_PIDIV2, sinp); // ±90°
-        else
-            pitch = std::asin(sinp);
-
-        // Yaw (Y-axis)
-        float siny_cosp = 2.0f * (qw * qy + qx * qz);
-        float cosy_cosp = 1.0f - 2.0f * (qx * qx + qy * qy);
-        float yaw = std::atan2(siny_cosp, cosy_cosp);
-
-        // Roll (Z-axis)
-        float sinr_cosp = 2.0f * (qw * qz + qx * qy);
-        float cosr_cosp = 1.0f - 2.0f * (qx * qx + qz * qz);
-        float roll = std::atan2(sinr_cosp, cosr_cosp);
-
-        return DirectX::XMFLOAT3{pitch, yaw, roll};
+        return EulerFromQuaternion(rotation);
     }
 
     void translateWorld(float dx, float dy, float dz) {
         position.x += dx;
         position.y += dy;
         position.z += dz;
+        markDirty();
     }
 
     void rotateEuler(float dPitch, float dYaw, float dRoll) {
@@ -78,6 +174,7 @@ struct Transform {
         XMVECTOR currentQuat = XMLoadFloat4(&rotation);
         XMVECTOR newQuat = XMQuaternionMultiply(currentQuat, deltaQuat);
         XMStoreFloat4(&rotation, XMQuaternionNormalize(newQuat));
+        markDirty();
     }
 
     void translateLocal(float dx, float dy, float dz) {
@@ -88,6 +185,7 @@ struct Transform {
         XMVECTOR pos = XMLoadFloat3(&position);
         pos = XMVectorAdd(pos, deltaWorld);
         XMStoreFloat3(&position, pos);
+        markDirty();
     }
 
     void lookAt(const DirectX::XMFLOAT3 &target,
@@ -107,6 +205,7 @@ struct Transform {
 
         XMVECTOR quat = XMQuaternionRotationMatrix(rotMatrix);
         XMStoreFloat4(&rotation, XMQuaternionNormalize(quat));
+        markDirty();
     }
 
 
@@ -116,6 +215,7 @@ struct Transform {
         XMVECTOR tgtV = XMLoadFloat3(&target);
         XMVECTOR delta = XMVectorSubtract(tgtV, posV);
         float dist = XMVectorGetX(XMVector3Length(delta));
+        markDirty();
         if (dist <= maxDistanceDelta || dist <= 1e-6f) {
             position = target;
             return;
@@ -0,0 +1,158 @@
+﻿#include "WorkerPool.hpp"
+#include <algorithm>
+
+namespace {
+    // 区间 j 的起点：均分，余数摊给前几段
+    inline size_t RangeBegin(size_t count, int jobs, int j) {
+        const size_t base = count / static_cast<size_t>(jobs);
+        const size_t rem = count % static_cast<size_t>(jobs);
+        const size_t uj = static_cast<size_t>(j);
+        return uj * base + std::min(uj, rem);
+    }
+}
+
+WorkerPool::WorkerPool(int threads) {
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    queues_ = std::make_unique<TaskQueue[]>(static_cast<size_t>(threads));
+    workers_.reserve(static_cast<size_t>(threads - 1));
+    for (int i = 1; i < threads; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &t: workers_) t.join();
+}
+
+int WorkerPool::jobCount(size_t count, size_t minPerJob) const {
+    if (count == 0) return 0;
+    const size_t perJob = std::max<size_t>(1, minPerJob);
+    const size_t byCount = std::max<size_t>(1, count / perJob);
+    return static_cast<int>(std::min<size_t>(byCount, static_cast<size_t>(threadCount())));
+}
+
+int WorkerPool::parallelFor(size_t count, size_t minPerJob, const RangeFn &fn) {
+    const int jobs = jobCount(count, minPerJob);
+    if (jobs == 0) return 0;
+    if (jobs == 1) {
+        fn(0, 0, count);
+        return 1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn_ = &fn;
+        taskFn_ = nullptr;
+        count_ = count;
+        jobs_ = jobs;
+        pending_ = jobs - 1;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    // 调用线程处理第 0 段
+    fn(0, RangeBegin(count, jobs, 0), RangeBegin(count, jobs, 1));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+    fn_ = nullptr;
+    return jobs;
+}
+
+int WorkerPool::runTasks(size_t count, const TaskFn &fn) {
+    if (count == 0) return 0;
+    const int jobs = static_cast<int>(std::min<size_t>(count, static_cast<size_t>(threadCount())));
+    if (jobs == 1) {
+        for (size_t i = 0; i < count; ++i) fn(0, i);
+        return 1;
+    }
+
+    // 发牌：任务 i 进入队列 i % jobs 的槽位 i / jobs
+    const size_t ujobs = static_cast<size_t>(jobs);
+    for (size_t q = 0; q < ujobs; ++q) {
+        queues_[q].range.store((count - q + ujobs - 1) / ujobs, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn_ = nullptr;
+        taskFn_ = &fn;
+        count_ = count;
+        jobs_ = jobs;
+        pending_ = jobs - 1;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drainTasks(0, jobs, fn);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+    taskFn_ = nullptr;
+    return jobs;
+}
+
+bool WorkerPool::takeTask(TaskQueue &q, bool fromBack, uint32_t &slot) {
+    uint64_t r = q.range.load(std::memory_order_acquire);
+    for (;;) {
+        const uint32_t head = static_cast<uint32_t>(r >> 32);
+        const uint32_t tail = static_cast<uint32_t>(r);
+        if (head >= tail) return false;
+        const uint64_t next = fromBack ? r - 1 : r + (uint64_t{1} << 32);
+        if (q.range.compare_exchange_weak(r, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            slot = fromBack ? tail - 1 : head;
+            return true;
+        }
+    }
+}
+
+void WorkerPool::drainTasks(int worker, int jobs, const TaskFn &fn) {
+    const size_t ujobs = static_cast<size_t>(jobs);
+    uint32_t slot = 0;
+    while (takeTask(queues_[worker], false, slot)) {
+        fn(worker, slot * ujobs + static_cast<size_t>(worker));
+    }
+    // 自己的队列空了：依次从其他队列尾部窃取（每个队列的主人都会把头部做完，所以任务不会遗漏）
+    for (int k = 1; k < jobs; ++k) {
+        const int victim = (worker + k) % jobs;
+        while (takeTask(queues_[victim], true, slot)) {
+            fn(worker, slot * ujobs + static_cast<size_t>(victim));
+        }
+    }
+}
+
+void WorkerPool::workerLoop(int worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        const RangeFn *fn = nullptr;
+        const TaskFn *taskFn = nullptr;
+        size_t count = 0;
+        int jobs = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            // 本批次区间数少于线程数时，多余的线程不参与
+            if (worker >= jobs_) continue;
+            fn = fn_;
+            taskFn = taskFn_;
+            count = count_;
+            jobs = jobs_;
+        }
+
+        if (taskFn) drainTasks(worker, jobs, *taskFn);
+        else (*fn)(worker, RangeBegin(count, jobs, worker), RangeBegin(count, jobs, worker + 1));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --pending_;
+        }
+        done_.notify_one();
+    }
+}
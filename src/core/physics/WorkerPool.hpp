@@ -0,0 +1,75 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// 物理用的简易常驻线程池（PhysicsWorld 内部持有）
+// 约定：
+// - 线程数含调用线程：threadCount() == 1 时不创建任何工作线程，parallelFor 直接在调用线程执行；
+// - parallelFor 把 [0, count) 切成若干连续区间，区间 j 固定交给 job j 处理（j == 0 在调用线程），
+//   调用方按 job 下标准备各自的缓冲，合并时按下标顺序拼接即可得到与单线程一致的结果；
+// - runTasks 用于耗时不均的独立任务：任务按下标轮流发给各线程的队列（调用方把重任务排在前面），
+//   线程做完自己的队列后从其他队列尾部窃取；任务由哪个线程执行不确定，任务之间不得共享可写数据；
+// - 阻塞直到全部区间/任务完成；不支持嵌套调用。
+class WorkerPool {
+public:
+    // threads <= 0 时取硬件并发数
+    explicit WorkerPool(int threads = 1);
+
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    int threadCount() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // 本次 parallelFor 会切出的区间数：每段至少 minPerJob 项，且不超过线程数
+    int jobCount(size_t count, size_t minPerJob) const;
+
+    // fn(job, begin, end)；返回实际使用的区间数（与 jobCount 一致）
+    using RangeFn = std::function<void(int job, size_t begin, size_t end)>;
+
+    int parallelFor(size_t count, size_t minPerJob, const RangeFn &fn);
+
+    // fn(worker, task)，task ∈ [0, count)；返回参与的线程数
+    using TaskFn = std::function<void(int worker, size_t task)>;
+
+    int runTasks(size_t count, const TaskFn &fn);
+
+private:
+    void workerLoop(int worker);
+
+    // 各线程的任务队列：槽位区间 [head, tail) 打包在一个 64 位原子量里（高 32 位 head），
+    // 队列 q 的槽位 s 对应任务 s * jobs + q；自己从头部取，窃取者从尾部取
+    struct alignas(64) TaskQueue {
+        std::atomic<uint64_t> range{0};
+    };
+
+    static bool takeTask(TaskQueue &q, bool fromBack, uint32_t &slot);
+
+    void drainTasks(int worker, int jobs, const TaskFn &fn);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    // 当前批次（受 mutex_ 保护）
+    const RangeFn *fn_ = nullptr;
+    const TaskFn *taskFn_ = nullptr; // 非空时本批次为 runTasks
+    size_t count_ = 0;
+    int jobs_ = 0;
+    int pending_ = 0; // 尚未完成的工作线程区间数
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+
+    std::unique_ptr<TaskQueue[]> queues_; // threadCount() 个
+};
@@ -0,0 +1,23 @@
+﻿#include "ExecutablePath.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <climits>
+#include <unistd.h>
+#endif
+
+std::wstring ExecutableDir() {
+    std::wstring exePath;
+#ifdef _WIN32
+    wchar_t buf[MAX_PATH];
+    const DWORD len = GetModuleFileNameW(nullptr, buf, MAX_PATH);
+    exePath.assign(buf, len);
+#else
+    char buf[PATH_MAX];
+    const ssize_t len = readlink("/proc/self/exe", buf, sizeof(buf));
+    if (len > 0) exePath.assign(buf, buf + len); // 按字节加宽，只用于拼接 ASCII 资源路径
+#endif
+    auto lastSlash = exePath.find_last_of(L"\\/");
+    return (lastSlash == std::wstring::npos) ? L"." : exePath.substr(0, lastSlash);
+}
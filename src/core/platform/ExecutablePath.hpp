@@ -0,0 +1,5 @@
+﻿#pragma once
+#include <string>
+
+// 可执行文件所在目录（不含末尾分隔符），资源路径以此为根；取不到时返回 L"."
+std::wstring ExecutableDir();
@@ -0,0 +1,5 @@
+﻿#pragma once
+#include <cstddef>
+
+// 进程常驻内存峰值（字节）：Windows 为 PeakWorkingSetSize，其他平台为 getrusage 的 ru_maxrss；取不到时返回 0
+size_t PeakResidentBytes();
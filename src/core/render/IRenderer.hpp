@@ -0,0 +1,91 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+#include <DirectXMath.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Material.hpp"
+#include "../physics/Transform.hpp"
+#include "../resource/ResourceManager.hpp"
+
+class Mesh;
+class Camera;
+struct Model;
+struct IDrawable;
+class ColliderBase;
+
+// 渲染接口：Scene / 实体 / UI 只通过它提交绘制，不直接依赖 D3D11。
+// 窗口版实现为 Renderer（D3D11），headless 模拟使用 NullRenderer
+class IRenderer {
+public:
+    struct DrawItem {
+        const Mesh *mesh = nullptr;
+        const Material *material = nullptr;
+        Transform transform{};
+        float alpha = 1.0f;
+        bool transparent = false;
+    };
+
+    struct RibbonVertex {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT3 normal;
+        DirectX::XMFLOAT4 color;
+        DirectX::XMFLOAT2 texCoord;
+    };
+
+    virtual ~IRenderer() = default;
+
+    // 帧内绘制队列
+    virtual void beginFrame() = 0;
+
+    virtual void submit(const DrawItem &item) = 0;
+
+    virtual void endFrame(const Camera &camera) = 0;
+
+    // 立即绘制
+    virtual void drawModel(const Model &model, const DirectX::XMMATRIX &modelTransform,
+                           const DirectX::XMFLOAT4 *baseColorFactor = nullptr) = 0;
+
+    virtual void draw(const IDrawable &drawable) = 0;
+
+    virtual void drawColliderWire(const ColliderBase &col) = 0;
+
+    virtual void drawRibbon(const std::vector<RibbonVertex> &vertices,
+                            const std::vector<uint16_t> &indices,
+                            ID3D11ShaderResourceView *texture,
+                            const DirectX::XMFLOAT4 &baseColor) = 0;
+
+    virtual void drawUiQuad(float x, float y, float width, float height,
+                            ID3D11ShaderResourceView *texture,
+                            const DirectX::XMFLOAT4 &tint,
+                            float emissive = 1.0f,
+                            float uvOffsetX = 0.0f,
+                            float uvOffsetY = 0.0f,
+                            float uvScaleX = 1.0f,
+                            float uvScaleY = 1.0f) = 0;
+
+    // 透明物体渲染状态
+    virtual void setAlphaBlending(bool enable) = 0;
+
+    virtual void setDepthWrite(bool enable) = 0;
+
+    virtual void setBackfaceCulling(bool enable) = 0;
+
+    // 设置当前帧使用的 Camera（由 Scene 提供）
+    virtual void setCamera(const Camera *camera) = 0;
+
+    virtual bool loadSkyboxCubeMap(const std::wstring &rightPath, const std::wstring &leftPath,
+                                   const std::wstring &topPath, const std::wstring &bottomPath,
+                                   const std::wstring &frontPath, const std::wstring &backPath) = 0;
+
+    virtual bool createSolidColorSkybox(unsigned char r = 255, unsigned char g = 255,
+                                        unsigned char b = 255, unsigned char a = 255) = 0;
+
+    // 底层设备（headless 为 nullptr），仅供窗口版资源初始化使用
+    virtual ID3D11Device *device() const = 0;
+
+    // 创建与本渲染器配套的资源管理器（模型/纹理在该设备上创建）
+    virtual std::unique_ptr<ResourceManager> createResourceManager() = 0;
+};
@@ -1,6 +1,6 @@
 ﻿#pragma once
 #include <DirectXMath.h>
-#include <d3d11.h>
+#include "../gfx/GpuHandle.hpp"
 #include <cstdint>
 
 // Minimal material placeholder
@@ -0,0 +1,61 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+#include "IRenderer.hpp"
+#include "../resource/NullResourceManager.hpp"
+
+// 空渲染器：丢弃所有绘制，资源管理器不加载任何资源（headless 模拟使用）
+class NullRenderer : public IRenderer {
+public:
+    void beginFrame() override {
+    }
+
+    void submit(const DrawItem &) override {
+    }
+
+    void endFrame(const Camera &) override {
+    }
+
+    void drawModel(const Model &, const DirectX::XMMATRIX &, const DirectX::XMFLOAT4 *) override {
+    }
+
+    void draw(const IDrawable &) override {
+    }
+
+    void drawColliderWire(const ColliderBase &) override {
+    }
+
+    void drawRibbon(const std::vector<RibbonVertex> &, const std::vector<uint16_t> &,
+                    ID3D11ShaderResourceView *, const DirectX::XMFLOAT4 &) override {
+    }
+
+    void drawUiQuad(float, float, float, float, ID3D11ShaderResourceView *, const DirectX::XMFLOAT4 &,
+                    float, float, float, float, float) override {
+    }
+
+    void setAlphaBlending(bool) override {
+    }
+
+    void setDepthWrite(bool) override {
+    }
+
+    void setBackfaceCulling(bool) override {
+    }
+
+    void setCamera(const Camera *) override {
+    }
+
+    bool loadSkyboxCubeMap(const std::wstring &, const std::wstring &, const std::wstring &,
+                           const std::wstring &, const std::wstring &, const std::wstring &) override {
+        return false;
+    }
+
+    bool createSolidColorSkybox(unsigned char, unsigned char, unsigned char, unsigned char) override {
+        return false;
+    }
+
+    ID3D11Device *device() const override { return nullptr; }
+
+    std::unique_ptr<ResourceManager> createResourceManager() override {
+        return std::make_unique<NullResourceManager>();
+    }
+};
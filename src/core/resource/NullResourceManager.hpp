@@ -0,0 +1,26 @@
+﻿#pragma once
+#include "ResourceManager.hpp"
+
+// 空资源管理器：不加载任何资源，所有查询返回空（headless 模拟使用）
+class NullResourceManager : public ResourceManager {
+public:
+    Model *getModel(const std::wstring &) override { return nullptr; }
+
+    ID3D11ShaderResourceView *getTextureSrv(const std::wstring &) override { return nullptr; }
+
+    Texture *getTexture(const std::wstring &) override { return nullptr; }
+
+    Model *getQuadModel() override { return nullptr; }
+
+    std::unique_ptr<Model> createQuadModelWithTexture(const std::wstring &) override { return nullptr; }
+
+    std::unique_ptr<Model> createGroundQuadModelWithTexture(const std::wstring &) override { return nullptr; }
+
+    ID3D11ShaderResourceView *getTrailGradientTexture() override { return nullptr; }
+
+    void preloadResources(const std::vector<std::wstring> &) override {
+    }
+
+    void cleanup() override {
+    }
+};
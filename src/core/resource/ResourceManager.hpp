@@ -1,50 +1,36 @@
 ﻿#pragma once
-#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <string>
-#include <wrl/client.h>
 #include "../gfx/Model.hpp"
-#include "../gfx/ModelLoader.hpp"
 #include "../gfx/Texture.hpp"
 
-// ResourceManager: simple cache for models and textures
+// ResourceManager: 模型与纹理的加载/缓存接口
+// 窗口版由 ResourceManagerD3D11 实现（Renderer::createResourceManager 创建）；
+// headless 构建使用 NullResourceManager，实体以无模型状态运行
 class ResourceManager {
 public:
-    explicit ResourceManager(ID3D11Device *device = nullptr) : device_(device) {
-    }
+    virtual ~ResourceManager() = default;
 
-    void setDevice(ID3D11Device *device) { device_ = device; }
+    virtual Model *getModel(const std::wstring &path) = 0;
 
-    Model *getModel(const std::wstring &path);
+    virtual ID3D11ShaderResourceView *getTextureSrv(const std::wstring &path) = 0;
 
-    ID3D11ShaderResourceView *getTextureSrv(const std::wstring &path);
-
-    Texture *getTexture(const std::wstring &path);
+    virtual Texture *getTexture(const std::wstring &path) = 0;
 
     // 获取或创建四边形模型（用于 Billboard）
-    Model *getQuadModel();
+    virtual Model *getQuadModel() = 0;
 
     // 创建带纹理的四边形模型（每次创建新实例）
-    std::unique_ptr<Model> createQuadModelWithTexture(const std::wstring &texturePath);
+    virtual std::unique_ptr<Model> createQuadModelWithTexture(const std::wstring &texturePath) = 0;
+
     // 创建地面 quad（用于地面指示器）
-    std::unique_ptr<Model> createGroundQuadModelWithTexture(const std::wstring& texturePath);
+    virtual std::unique_ptr<Model> createGroundQuadModelWithTexture(const std::wstring &texturePath) = 0;
 
     // 获取或创建 Trail 默认渐变纹理（程序生成）
-    ID3D11ShaderResourceView *getTrailGradientTexture();
-
-    void preloadResources(const std::vector<std::wstring> &paths);
-
-    void cleanup();
-
-private:
-    ID3D11Device *device_ = nullptr;
-    std::unordered_map<std::wstring, std::unique_ptr<Model> > models_;
-    std::unordered_map<std::wstring, std::unique_ptr<Texture> > textures_;
+    virtual ID3D11ShaderResourceView *getTrailGradientTexture() = 0;
 
-    // 缓存的四边形模型（延迟初始化）
-    std::unique_ptr<Model> quadModel_;
+    virtual void preloadResources(const std::vector<std::wstring> &paths) = 0;
 
-    // 缓存的 Trail 渐变纹理（延迟初始化）
-    std::unique_ptr<Texture> trailGradientTexture_;
-};
\ No newline at end of file
+    virtual void cleanup() = 0;
+};
@@ -1,8 +1,8 @@
-﻿#include "ResourceManager.hpp"
+﻿#include "ResourceManagerD3D11.hpp"
 #include "../gfx/Vertex.hpp"
 #include <d3d11.h>
 
-Model *ResourceManager::getModel(const std::wstring &path) {
+Model *ResourceManagerD3D11::getModel(const std::wstring &path) {
     auto it = models_.find(path);
     if (it != models_.end()) {
         return it->second.get();
@@ -17,7 +17,7 @@ Model *ResourceManager::getModel(const std::wstring &path) {
     return ptr;
 }
 
-ID3D11ShaderResourceView *ResourceManager::getTextureSrv(const std::wstring &path) {
+ID3D11ShaderResourceView *ResourceManagerD3D11::getTextureSrv(const std::wstring &path) {
     auto it = textures_.find(path);
     if (it != textures_.end()) {
         return it->second->srv();
@@ -33,7 +33,7 @@ ID3D11ShaderResourceView *ResourceManager::getTextureSrv(const std::wstring &pat
 }
 
 
-Texture *ResourceManager::getTexture(const std::wstring &path) {
+Texture *ResourceManagerD3D11::getTexture(const std::wstring &path) {
     auto it = textures_.find(path);
     if (it != textures_.end()) {
         return it->second.get();
@@ -58,7 +58,7 @@ static std::wstring getLowercaseExtension(const std::wstring& path) {
     return ext;
 }
 
-void ResourceManager::preloadResources(const std::vector<std::wstring> &paths) {
+void ResourceManagerD3D11::preloadResources(const std::vector<std::wstring> &paths) {
     for (const auto &p : paths) {
         std::wstring ext = getLowercaseExtension(p);
         // Model extensions: .fbx, .obj
@@ -73,7 +73,7 @@ void ResourceManager::preloadResources(const std::vector<std::wstring> &paths) {
     }
 }
 
-void ResourceManager::cleanup() {
+void ResourceManagerD3D11::cleanup() {
     models_.clear();
     textures_.clear();
     quadModel_.reset();
@@ -81,7 +81,7 @@ void ResourceManager::cleanup() {
 }
 
 // 获取或创建 Trail 默认渐变纹理（程序生成）
-ID3D11ShaderResourceView *ResourceManager::getTrailGradientTexture() {
+ID3D11ShaderResourceView *ResourceManagerD3D11::getTrailGradientTexture() {
     if (trailGradientTexture_) {
         return trailGradientTexture_->srv();
     }
@@ -124,7 +124,7 @@ ID3D11ShaderResourceView *ResourceManager::getTrailGradientTexture() {
 }
 
 // 获取或创建四边形模型（用于 Billboard）
-Model *ResourceManager::getQuadModel() {
+Model *ResourceManagerD3D11::getQuadModel() {
     if (quadModel_) {
         return quadModel_.get();
     }
@@ -180,7 +180,7 @@ Model *ResourceManager::getQuadModel() {
 }
 
 // 创建带纹理的四边形模型（每次创建新实例，用于 Billboard）
-std::unique_ptr<Model> ResourceManager::createQuadModelWithTexture(const std::wstring &texturePath) {
+std::unique_ptr<Model> ResourceManagerD3D11::createQuadModelWithTexture(const std::wstring &texturePath) {
     if (!device_) return nullptr;
 
     auto model = std::make_unique<Model>();
@@ -247,7 +247,7 @@ std::unique_ptr<Model> ResourceManager::createQuadModelWithTexture(const std::ws
     return model;
 }
 
-std::unique_ptr<Model> ResourceManager::createGroundQuadModelWithTexture(const std::wstring &texturePath) {
+std::unique_ptr<Model> ResourceManagerD3D11::createGroundQuadModelWithTexture(const std::wstring &texturePath) {
     if (!device_) return nullptr;
 
     auto model = std::make_unique<Model>();
@@ -0,0 +1,45 @@
+﻿#pragma once
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <string>
+#include "ResourceManager.hpp"
+#include "../gfx/ModelLoader.hpp"
+
+// ResourceManagerD3D11: 基于 D3D11 设备的模型/纹理缓存
+class ResourceManagerD3D11 : public ResourceManager {
+public:
+    explicit ResourceManagerD3D11(ID3D11Device *device = nullptr) : device_(device) {
+    }
+
+    void setDevice(ID3D11Device *device) { device_ = device; }
+
+    Model *getModel(const std::wstring &path) override;
+
+    ID3D11ShaderResourceView *getTextureSrv(const std::wstring &path) override;
+
+    Texture *getTexture(const std::wstring &path) override;
+
+    Model *getQuadModel() override;
+
+    std::unique_ptr<Model> createQuadModelWithTexture(const std::wstring &texturePath) override;
+
+    std::unique_ptr<Model> createGroundQuadModelWithTexture(const std::wstring &texturePath) override;
+
+    ID3D11ShaderResourceView *getTrailGradientTexture() override;
+
+    void preloadResources(const std::vector<std::wstring> &paths) override;
+
+    void cleanup() override;
+
+private:
+    ID3D11Device *device_ = nullptr;
+    std::unordered_map<std::wstring, std::unique_ptr<Model> > models_;
+    std::unordered_map<std::wstring, std::unique_ptr<Texture> > textures_;
+
+    // 缓存的四边形模型（延迟初始化）
+    std::unique_ptr<Model> quadModel_;
+
+    // 缓存的 Trail 渐变纹理（延迟初始化）
+    std::unique_ptr<Texture> trailGradientTexture_;
+};
@@ -0,0 +1,50 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <cstdint>
+
+// 可复现的伪随机数（PCG32，XSH-RR 输出）：
+// - 同一种子在任何平台/编译器上产生相同序列（不依赖 std::rand 与标准库分布的实现）；
+// - 不含全局状态，每个场景各持一个，可在多个线程上各自使用。
+class Random {
+public:
+    Random() { seed(0); }
+
+    explicit Random(uint64_t s) { seed(s); }
+
+    void seed(uint64_t s) {
+        state_ = 0;
+        nextU32();
+        state_ += s;
+        nextU32();
+    }
+
+    uint32_t nextU32() {
+        const uint64_t old = state_;
+        state_ = old * 6364136223846793005ull + kIncrement;
+        const uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        const uint32_t rot = static_cast<uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // [0, n) 上的均匀整数（拒绝采样，无取模偏差）；n 为 0 时返回 0
+    uint32_t below(uint32_t n) {
+        if (n == 0) return 0;
+        const uint32_t threshold = (0u - n) % n;
+        for (;;) {
+            const uint32_t r = nextU32();
+            if (r >= threshold) return r % n;
+        }
+    }
+
+    // [0, 1) 上的均匀浮点（取高 24 位，恰好落在 float 精度内）
+    float nextFloat() { return static_cast<float>(nextU32() >> 8) * (1.0f / 16777216.0f); }
+
+    // [lo, hi) 上的均匀浮点
+    float range(float lo, float hi) { return lo + (hi - lo) * nextFloat(); }
+
+private:
+    static constexpr uint64_t kIncrement = 1442695040888963407ull;
+
+    uint64_t state_ = 0;
+};
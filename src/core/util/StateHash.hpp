@@ -0,0 +1,28 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <cstdint>
+#include <cstring>
+#include <DirectXMath.h>
+
+// 模拟状态哈希（64 位 FNV-1a，按 32 位字混入）：浮点按位参与，用于逐 tick 比对两次运行是否逐位一致
+struct StateHash {
+    uint64_t value = 14695981039346656037ull;
+
+    void add(uint32_t v) {
+        value ^= v;
+        value *= 1099511628211ull;
+    }
+
+    void add(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        add(bits);
+    }
+
+    void add(const DirectX::XMFLOAT3 &v) {
+        add(v.x);
+        add(v.y);
+        add(v.z);
+    }
+};
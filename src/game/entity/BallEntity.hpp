@@ -1,19 +1,13 @@
 ﻿#pragma once
 #include "DynamicEntity.hpp"
-#include "../../core/gfx/ModelLoader.hpp"
-#include <memory>
+#include "../../core/gfx/Model.hpp"
 
-// Ball 动态实体：持有一个 SphereCollider，加载一个模型用于渲染（临时用 cube.fbx）
+// Ball 动态实体：持有一个 SphereCollider，模型由 ResourceManager 共享（可为空）
 class BallEntity : public DynamicEntity {
 public:
-    explicit BallEntity(ID3D11Device *dev, float radius, const std::wstring &modelPath) {
-        modelOwned = std::make_unique<Model>();
-        ModelLoader::LoadFBX(dev, modelPath, *modelOwned);
-        modelRef = modelOwned.get();
+    BallEntity(float radius, Model *model) {
+        modelRef = model;
         setCollider(MakeSphereCollider(radius));
         rb.invMass = 1.0f; // 动态体
     }
-
-private:
-    std::unique_ptr<Model> modelOwned;
 };
\ No newline at end of file
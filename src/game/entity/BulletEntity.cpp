@@ -1,5 +1,4 @@
 ﻿#include "BulletEntity.hpp"
-#include "core/gfx/ModelLoader.hpp"
 #include "core/resource/ResourceManager.hpp"
 #include <DirectXMath.h>
 
@@ -7,6 +6,7 @@
 #include "ExplosionEffect.hpp"
 #include "TrailEntity.hpp"
 #include "game/runtime/WorldContext.hpp"
+#include "game/runtime/CollisionLayers.hpp"
 
 using namespace DirectX;
 
@@ -16,10 +16,11 @@ auto clampDirToXZ(const DirectX::XMFLOAT3 &dir) {
     return c;
 }
 
-// 新版本：使用 ResourceManager（推荐）
 void BulletEntity::initialize(float radius, const std::wstring &modelPath, ResourceManager *resMgr) {
     this->setCollider(MakeSphereCollider(radius));
+    this->collider()->setLayer(CollisionLayer::bit(CollisionLayer::Bullet));
     rb.invMass = 1.0f;
+    rb.ccd = true; // 高速飞行，防止穿过 1 单位厚的方块
 
     // 高尔夫球物理参数：低摩擦，高弹性
     rb.muS = 0.02f; // 静摩擦：0.6 → 0.05（更容易滚动）
@@ -34,21 +35,6 @@ void BulletEntity::initialize(float radius, const std::wstring &modelPath, Resou
     }
 }
 
-// 旧版本：直接加载（已废弃，但保留兼容性）
-void BulletEntity::initialize(float radius, const std::wstring &modelPath, ID3D11Device *dev) {
-    this->setCollider(MakeSphereCollider(radius));
-    rb.invMass = 1.0f;
-
-    // 高尔夫球物理参数：低摩擦，高弹性
-    rb.muS = 0.05f;
-    rb.muK = 0.03f;
-    rb.restitution = 0.7f;
-
-    modelOwned = std::make_unique<Model>();
-    ModelLoader::LoadFBX(dev, modelPath, *modelOwned);
-    modelRef = modelOwned.get();
-}
-
 void BulletEntity::update(WorldContext &ctx, float dt) {
     auto *body = rigidBody();
     if (!body) return;
@@ -73,12 +59,15 @@ void BulletEntity::update(WorldContext &ctx, float dt) {
     {
         // 创建 Trail（如果还没有）
         if (trailEntityId == 0) {
-            ctx.commands->spawn<TrailEntity>([this, &ctx](TrailEntity *trail) {
-                trail->transform.position = this->transform.position;
+            // 配置回调在本步 submitCommands 中执行，此时子弹可能已在同一批命令中被销毁：
+            // 只按值捕获，并通过实体表回写 Trail ID
+            ctx.commands->spawn<TrailEntity>([self = id(), team = team, pos = transform.position, &ctx](
+            TrailEntity *trail) {
+                trail->transform.position = pos;
                 trail->initialize(ctx.resources);
 
                 // 根据队伍设置不同颜色
-                switch (this->team) {
+                switch (team) {
                     case NodeTeam::Friendly:
                         trail->baseColor = XMFLOAT4{0.2f, 0.6f, 1.0f, 0.8f}; // 蓝色
                         break;
@@ -94,7 +83,9 @@ void BulletEntity::update(WorldContext &ctx, float dt) {
                 trail->lifetimePerPoint = 0.6f;
 
                 // 记录 Trail ID
-                this->trailEntityId = trail->id();
+                if (auto *bullet = dynamic_cast<BulletEntity *>(ctx.entities->getEntity(self))) {
+                    bullet->trailEntityId = trail->id();
+                }
             });
         }
 
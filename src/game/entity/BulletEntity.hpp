@@ -33,12 +33,9 @@ public:
     float trailUpdateInterval = 0.02f; // 添加拖尾点的间隔（秒）
     float trailUpdateTimer = 0.0f; // 拖尾更新计时器
 
-    // 使用 ResourceManager 初始化（推荐）
+    // 使用 ResourceManager 初始化（模型由其缓存共享；为空时无模型）
     void initialize(float radius, const std::wstring &modelPath, ResourceManager *resMgr);
 
-    // 旧版本：直接使用 Device 加载（已废弃，保留兼容性）
-    void initialize(float radius, const std::wstring &modelPath, ID3D11Device *dev);
-
     void update(WorldContext &ctx, float dt) override;
 
     void onCollision(WorldContext &ctx, EntityId other, TriggerPhase phase, const OverlapResult &c) override;
@@ -50,8 +47,6 @@ public:
     float getAlpha() const override { return 1.0f; }
 
 private:
-    std::unique_ptr<Model> modelOwned;
-
     // 辅助方法：在指定位置生成爆炸特效
     void spawnExplosionEffect(WorldContext &ctx, const DirectX::XMFLOAT3 &position);
 };
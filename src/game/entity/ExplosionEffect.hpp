@@ -1,8 +1,8 @@
 ﻿#pragma once
 #include "BillboardEntity.hpp"
 #include "../../core/resource/ResourceManager.hpp"
+#include "../../core/platform/ExecutablePath.hpp"
 #include <memory>
-#include <windows.h>
 
 // 爆炸特效实体
 // 特点：完全朝向相机，短暂生命周期，自动销毁
@@ -19,15 +19,8 @@ public:
     void initialize(ResourceManager *resourceMgr) {
         if (!resourceMgr) return;
 
-        // 获取可执行文件目录
-        wchar_t buf[MAX_PATH];
-        GetModuleFileNameW(nullptr, buf, MAX_PATH);
-        std::wstring exePath(buf);
-        auto lastSlash = exePath.find_last_of(L"\\/");
-        std::wstring exeDir = (lastSlash == std::wstring::npos) ? L"." : exePath.substr(0, lastSlash);
-
         // 尝试创建带纹理的四边形模型
-        std::wstring texturePath = exeDir + L"\\asset\\explosion.png";
+        std::wstring texturePath = ExecutableDir() + L"\\asset\\explosion.png";
         ownedModel_ = resourceMgr->createQuadModelWithTexture(texturePath);
 
         if (ownedModel_) {
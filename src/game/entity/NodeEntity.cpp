@@ -1,6 +1,8 @@
 ﻿#include "NodeEntity.hpp"
+#include <algorithm>
 #include <DirectXMath.h>
 #include "game/runtime/WorldContext.hpp"
+#include "core/gfx/Camera.hpp"
 
 using namespace DirectX;
 
@@ -98,10 +100,15 @@ void NodeEntity::setFacingDirection(const DirectX::XMFLOAT3 &worldTarget) {
 }
 
 bool NodeEntity::isFrontClear(WorldContext &ctx) const {
-    ColliderBase *trigger = colliders_.at(1).get();
-    if (!trigger || !trigger->isTrigger()) return false;
-
-    return !ctx.physics->isAnyTriggerOverlapping(id());
+    // 沿朝向扫掠一个子弹大小的球（约一个方块的距离），忽略自身；不依赖额外的触发器碰撞体
+    constexpr float kFrontCheckDistance = 1.0f;
+    if (!ctx.physics || !ctx.physics->world) return false;
+
+    QueryFilter filter{};
+    filter.ignoreEntity = id();
+    QueryHit hit{};
+    const XMFLOAT3 muzzle = colliders_.at(0)->getWorldPosition();
+    return !ctx.physics->world->sphereCast(muzzle, bulletRadius, facingDirection, kFrontCheckDistance, hit, filter);
 }
 
 void NodeEntity::fireBullet(WorldContext &ctx) {
@@ -139,7 +146,7 @@ void NodeEntity::onHitByBullet(WorldContext &ctx, NodeTeam attackerTeam, int pow
     }
 
     if (team == attackerTeam) {
-        health = min(health + 3 * power, static_cast<int>(maxHealth));
+        health = std::min(health + 3 * power, static_cast<int>(maxHealth));
         fireInterval = 2.0 / (1 + health * 0.1);
         firePower = static_cast<int>(1 + floor(health * 0.1));
     } else {
@@ -195,35 +202,26 @@ EntityId NodeEntity::findNearestEnemyNode(WorldContext &ctx) const {
     EntityId nearestId = 0;
     float minDistanceSq = FLT_MAX;
 
-    std::vector<EntityId> allIds;
-    ctx.entities->getAllEntityIds(allIds);
-
-    for (EntityId id: allIds) {
-        if (id == this->id()) continue; // 跳过自己
-
-        IEntity *entity = ctx.entities->getEntity(id);
-        if (!entity) continue;
-
-        // 尝试转换为 NodeEntity
-        NodeEntity *node = dynamic_cast<NodeEntity *>(entity);
-        if (!node) continue;
+    // 只遍历 Node 池（不再取全部实体 id 逐个查表、dynamic_cast）
+    ctx.entities->forEach<NodeEntity>([&](const NodeEntity &node) {
+        if (node.id() == this->id()) return; // 跳过自己
 
         // 检查是否是敌对队伍
-        if (node->getteam() == this->team) continue;
+        if (node.getteam() == this->team) return;
 
         // 计算距离平方（避免开方运算）
         XMFLOAT3 diff{
-            node->transform.position.x - this->transform.position.x,
+            node.transform.position.x - this->transform.position.x,
             0.0f,
-            node->transform.position.z - this->transform.position.z
+            node.transform.position.z - this->transform.position.z
         };
         float distSq = diff.x * diff.x + diff.z * diff.z;
 
         if (distSq < minDistanceSq) {
             minDistanceSq = distSq;
-            nearestId = id;
+            nearestId = node.id();
         }
-    }
+    });
 
     return nearestId;
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "BillboardEntity.hpp"
 #include "../../core/resource/ResourceManager.hpp"
+#include "../../core/platform/ExecutablePath.hpp"
 
 // 立牌实体
 // 特点：仅绕Y轴旋转面向相机，永久存在（除非手动销毁）
@@ -16,15 +17,8 @@ public:
     void initialize(ResourceManager *resourceMgr, const std::wstring &texturePath) {
         if (!resourceMgr) return;
 
-        // 获取可执行文件目录
-        wchar_t buf[MAX_PATH];
-        GetModuleFileNameW(nullptr, buf, MAX_PATH);
-        std::wstring exePath(buf);
-        auto lastSlash = exePath.find_last_of(L"\\/");
-        std::wstring exeDir = (lastSlash == std::wstring::npos) ? L"." : exePath.substr(0, lastSlash);
-
         // 尝试创建带纹理的四边形模型
-        std::wstring texPath = exeDir + L"\\asset\\explosion.png";
+        std::wstring texPath = ExecutableDir() + L"\\asset\\explosion.png";
         ownedModel_ = resourceMgr->createQuadModelWithTexture(texPath);
 
         if (ownedModel_) {
@@ -18,9 +18,7 @@ public:
         if (!ctx.physics) return;
 
         // 如果自身触发器未被占用，则生成一个球
-        std::vector<EntityId> overlappers;
-        ctx.physics->getTriggerOverlappers(id(), overlappers);
-        bool blocked = !overlappers.empty();
+        bool blocked = ctx.physics->isAnyTriggerOverlapping(id());
         //bool blocked=false;
         if (!blocked && ctx.commands) {
             DirectX::XMFLOAT3 pos = transform.position;
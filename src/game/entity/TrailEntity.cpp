@@ -57,14 +57,14 @@ void TrailEntity::update(WorldContext &ctx, float dt) {
     }
 }
 
-void TrailEntity::render(Renderer *renderer, float currentTime) {
+void TrailEntity::render(IRenderer *renderer, float currentTime) {
     // 检查是否有足够的点来渲染
     if (points_.size() < static_cast<size_t>(minPointsToRender) || !renderer) {
         return;
     }
 
     // 生成 Ribbon mesh
-    std::vector<Renderer::RibbonVertex> vertices;
+    std::vector<IRenderer::RibbonVertex> vertices;
     std::vector<uint16_t> indices;
     generateRibbon(vertices, indices, currentTime);
 
@@ -76,7 +76,7 @@ void TrailEntity::render(Renderer *renderer, float currentTime) {
     renderer->drawRibbon(vertices, indices, enableTexture ? texture_ : nullptr, baseColor);
 }
 
-void TrailEntity::generateRibbon(std::vector<Renderer::RibbonVertex> &vertices,
+void TrailEntity::generateRibbon(std::vector<IRenderer::RibbonVertex> &vertices,
                                  std::vector<uint16_t> &indices,
                                  float currentTime) {
     const size_t numPoints = points_.size();
@@ -137,7 +137,7 @@ void TrailEntity::generateRibbon(std::vector<Renderer::RibbonVertex> &vertices,
 
         // 计算 alpha（基于年龄淡出）
         float alpha = 1.0f - t;
-        alpha = max(0.0f, min(1.0f, alpha));
+        alpha = std::max(0.0f, std::min(1.0f, alpha));
 
         // 计算 UV 坐标
         float u = static_cast<float>(i) / static_cast<float>(numPoints - 1);
@@ -155,7 +155,7 @@ void TrailEntity::generateRibbon(std::vector<Renderer::RibbonVertex> &vertices,
         vertexColor.w *= alpha;
 
         // 添加左侧顶点
-        Renderer::RibbonVertex leftVert;
+        IRenderer::RibbonVertex leftVert;
         leftVert.position = leftPos;
         leftVert.normal = normal;
         leftVert.color = vertexColor;
@@ -163,7 +163,7 @@ void TrailEntity::generateRibbon(std::vector<Renderer::RibbonVertex> &vertices,
         vertices.push_back(leftVert);
 
         // 添加右侧顶点
-        Renderer::RibbonVertex rightVert;
+        IRenderer::RibbonVertex rightVert;
         rightVert.position = rightPos;
         rightVert.normal = normal;
         rightVert.color = vertexColor;
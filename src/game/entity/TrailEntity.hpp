@@ -1,6 +1,6 @@
 ﻿#pragma once
 #include "StaticEntity.hpp"
-#include "../../core/gfx/Renderer.hpp"
+#include "../../core/render/IRenderer.hpp"
 #include "../../core/resource/ResourceManager.hpp"
 #include <deque>
 #include <vector>
@@ -32,7 +32,7 @@ public:
     void update(WorldContext &ctx, float dt) override;
 
     // 自定义渲染（不通过 IDrawable，直接调用 Renderer::drawRibbon）
-    void render(Renderer *renderer, float currentTime);
+    void render(IRenderer *renderer, float currentTime);
 
     // 配置参数
     float trailWidth = 0.15f; // 拖尾宽度（世界空间单位）
@@ -49,7 +49,7 @@ private:
     ID3D11ShaderResourceView *texture_ = nullptr; // 可选纹理
 
     // Ribbon 生成算法：从历史点生成四边形带
-    void generateRibbon(std::vector<Renderer::RibbonVertex> &vertices,
+    void generateRibbon(std::vector<IRenderer::RibbonVertex> &vertices,
                         std::vector<uint16_t> &indices,
                         float currentTime);
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+﻿#pragma once
+#include <cstdint>
+#include <DirectXMath.h>
+#include "../../core/physics/PhysicsWorld.hpp"
+
+// 玩家操作命令：键鼠输入先翻译成命令再交给 BattleScene::execute 执行，
+// 因此同一串命令可以录制下来，在 headless 下按模拟步重放（见 CommandLog）
+enum class BattleCommandType : uint8_t {
+    Select, // 选中 entity（非友方 Node 或 0 时取消选择）
+    SetFacing, // 选中 Node 朝向地面上的 point
+    StartFiring, // 选中 Node 开火
+    Stop, // 选中 Node 停火并重置开火计时
+    EnterDemo, // 进入演示模式
+    CameraMove, // 相机平移/旋转：flags 为 CameraMoveFlag 位，value 为该帧 dt
+    CameraZoom, // 滚轮缩放：value 为滚轮量
+    CameraFocus, // 相机对准选中 Node
+    CameraSwitch // 切换相机：flags 为 CameraType
+};
+
+enum CameraMoveFlag : uint8_t {
+    CameraForward = 1 << 0,
+    CameraBackward = 1 << 1,
+    CameraLeft = 1 << 2,
+    CameraRight = 1 << 3,
+    CameraRotateLeft = 1 << 4,
+    CameraRotateRight = 1 << 5,
+    CameraBoost = 1 << 6
+};
+
+struct BattleCommand {
+    BattleCommandType type = BattleCommandType::Select;
+    uint32_t step = 0; // 执行时场景已推进的固定步数（录制时由 execute 填写）
+    EntityId entity = 0;
+    DirectX::XMFLOAT3 point{0, 0, 0};
+    float value = 0.0f;
+    uint8_t flags = 0;
+};
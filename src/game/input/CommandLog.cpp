@@ -0,0 +1,182 @@
+﻿#include "CommandLog.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    constexpr char kMagic[4] = {'N', 'W', 'C', 'L'};
+    constexpr uint8_t kVersion = 1;
+
+    struct Writer {
+        std::vector<uint8_t> bytes;
+
+        void u8(uint8_t v) { bytes.push_back(v); }
+
+        void u32(uint32_t v) {
+            for (int i = 0; i < 4; ++i) bytes.push_back(static_cast<uint8_t>(v >> (8 * i)));
+        }
+
+        void u64(uint64_t v) {
+            for (int i = 0; i < 8; ++i) bytes.push_back(static_cast<uint8_t>(v >> (8 * i)));
+        }
+
+        void f32(float f) {
+            uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            u32(bits);
+        }
+
+        void varint(uint32_t v) {
+            while (v >= 0x80) {
+                bytes.push_back(static_cast<uint8_t>(v | 0x80));
+                v >>= 7;
+            }
+            bytes.push_back(static_cast<uint8_t>(v));
+        }
+    };
+
+    // 越界读取时置 ok = false 并返回 0，调用方最后统一检查
+    struct Reader {
+        const std::vector<uint8_t> &bytes;
+        size_t pos = 0;
+        bool ok = true;
+
+        uint8_t u8() {
+            if (pos >= bytes.size()) {
+                ok = false;
+                return 0;
+            }
+            return bytes[pos++];
+        }
+
+        uint32_t u32() {
+            uint32_t v = 0;
+            for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(u8()) << (8 * i);
+            return v;
+        }
+
+        uint64_t u64() {
+            uint64_t v = 0;
+            for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(u8()) << (8 * i);
+            return v;
+        }
+
+        float f32() {
+            const uint32_t bits = u32();
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+
+        uint32_t varint() {
+            uint32_t v = 0;
+            for (int shift = 0; shift < 35 && ok; shift += 7) {
+                const uint8_t b = u8();
+                v |= static_cast<uint32_t>(b & 0x7f) << shift;
+                if (!(b & 0x80)) return v;
+            }
+            ok = false;
+            return 0;
+        }
+    };
+}
+
+bool CommandLog::save(const std::filesystem::path &path) const {
+    Writer w;
+    for (char c: kMagic) w.u8(static_cast<uint8_t>(c));
+    w.u8(kVersion);
+    w.u64(seed);
+    w.f32(fixedDt);
+    w.u32(endStep);
+    w.u64(endHash);
+    w.u32(static_cast<uint32_t>(commands.size()));
+
+    uint32_t prevStep = 0;
+    for (const BattleCommand &c: commands) {
+        w.varint(c.step - prevStep);
+        prevStep = c.step;
+        w.u8(static_cast<uint8_t>(c.type));
+        switch (c.type) {
+            case BattleCommandType::Select:
+                w.varint(c.entity);
+                break;
+            case BattleCommandType::SetFacing:
+                w.f32(c.point.x);
+                w.f32(c.point.y);
+                w.f32(c.point.z);
+                break;
+            case BattleCommandType::CameraMove:
+                w.u8(c.flags);
+                w.f32(c.value);
+                break;
+            case BattleCommandType::CameraZoom:
+                w.f32(c.value);
+                break;
+            case BattleCommandType::CameraSwitch:
+                w.u8(c.flags);
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(w.bytes.data()), static_cast<std::streamsize>(w.bytes.size()));
+    return static_cast<bool>(out);
+}
+
+bool CommandLog::load(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Reader r{bytes};
+    for (char c: kMagic) {
+        if (r.u8() != static_cast<uint8_t>(c)) return false;
+    }
+    if (r.u8() != kVersion) return false;
+    CommandLog log;
+    log.seed = r.u64();
+    log.fixedDt = r.f32();
+    log.endStep = r.u32();
+    log.endHash = r.u64();
+    const uint32_t count = r.u32();
+    if (!r.ok || count > bytes.size()) return false; // 每条命令至少 2 字节，防止损坏的计数触发巨量分配
+
+    log.commands.reserve(count);
+    uint32_t step = 0;
+    for (uint32_t i = 0; i < count && r.ok; ++i) {
+        BattleCommand c;
+        step += r.varint();
+        c.step = step;
+        const uint8_t type = r.u8();
+        if (type > static_cast<uint8_t>(BattleCommandType::CameraSwitch)) return false;
+        c.type = static_cast<BattleCommandType>(type);
+        switch (c.type) {
+            case BattleCommandType::Select:
+                c.entity = r.varint();
+                break;
+            case BattleCommandType::SetFacing:
+                c.point.x = r.f32();
+                c.point.y = r.f32();
+                c.point.z = r.f32();
+                break;
+            case BattleCommandType::CameraMove:
+                c.flags = r.u8();
+                c.value = r.f32();
+                break;
+            case BattleCommandType::CameraZoom:
+                c.value = r.f32();
+                break;
+            case BattleCommandType::CameraSwitch:
+                c.flags = r.u8();
+                break;
+            default:
+                break;
+        }
+        log.commands.push_back(c);
+    }
+    if (!r.ok) return false;
+    *this = std::move(log);
+    return true;
+}
@@ -0,0 +1,20 @@
+﻿#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include "BattleCommand.hpp"
+
+// 命令日志：对局种子 + 按模拟步排序的命令，紧凑二进制存盘。
+// 格式（小端）："NWCL"、u8 版本、u64 种子、f32 固定步长、u32 结束步、u64 结束时状态哈希、u32 命令数，
+// 之后每条命令为 varint 步增量、u8 类型与按类型变长的参数。
+struct CommandLog {
+    uint64_t seed = 0;
+    float fixedDt = 0.0f;
+    uint32_t endStep = 0; // 录制结束时已推进的步数，回放推进到此为止
+    uint64_t endHash = 0; // 录制结束时的 Scene::stateHash，回放结束后比对
+    std::vector<BattleCommand> commands;
+
+    bool save(const std::filesystem::path &path) const;
+
+    bool load(const std::filesystem::path &path);
+};
@@ -0,0 +1,15 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <cstdint>
+
+// 游戏碰撞层（ColliderBase::setLayer 的层位，与 WorldParams::layerMatrix 的行号一一对应）
+namespace CollisionLayer {
+    constexpr int Default = 0;
+    constexpr int Terrain = 1; // 地面/墙壁/转角/斜坡方块（静态）
+    constexpr int Node = 2; // 节点
+    constexpr int Bullet = 3; // 子弹
+    constexpr int Decoration = 4; // 纯装饰：不与任何层产生候选对，只供场景查询
+
+    constexpr uint32_t bit(int layer) { return 1u << layer; }
+}
@@ -0,0 +1,277 @@
+﻿#pragma once
+#pragma execution_character_set("utf-8")
+
+#include <vector>
+#include <span>
+#include <memory>
+#include <new>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "core/physics/PhysicsWorld.hpp"
+#include "core/physics/SparseIndex.hpp"
+
+struct IEntity;
+
+// 实体句柄：池下标 + 槽位 + 代数。槽位被销毁后代数递增，旧句柄 resolve 为 nullptr，
+// 不会误指向复用该槽位的新实体；可长期保存，比按 EntityId 查表少一次稀疏表访问。
+struct EntityHandle {
+    uint32_t pool = 0xffffffffu;
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+
+    bool valid() const { return pool != 0xffffffffu; }
+};
+
+// 单一具体类型实体的存储（非模板部分）：
+// - dense_ 为存活实体的连续指针数组，遍历只走这段内存；销毁时与末尾交换后弹出（O(1)）；
+// - 槽位 → dense 下标 / 代数 为平行数组，空槽位 LIFO 复用（刚释放、仍在缓存中的内存优先）。
+class IEntityPool {
+public:
+    static constexpr uint32_t Invalid = 0xffffffffu;
+
+    virtual ~IEntityPool() = default;
+
+    std::span<IEntity *const> entities() const { return dense_; }
+
+    size_t size() const { return dense_.size(); }
+
+    // 调用方保证 slot 存活（EntityStorage 经 EntityId 索引得到）
+    IEntity *at(uint32_t slot) const { return dense_[denseOf_[slot]]; }
+
+    bool alive(uint32_t slot, uint32_t generation) const {
+        return slot < denseOf_.size() && denseOf_[slot] != Invalid && generation_[slot] == generation;
+    }
+
+    uint32_t generation(uint32_t slot) const { return generation_[slot]; }
+
+    // 析构 slot 上的实体，末尾实体移入其 dense 位置
+    virtual void destroy(uint32_t slot) = 0;
+
+protected:
+    uint32_t acquireSlot() {
+        if (!freeSlots_.empty()) {
+            const uint32_t slot = freeSlots_.back();
+            freeSlots_.pop_back();
+            return slot;
+        }
+        denseOf_.push_back(Invalid);
+        generation_.push_back(0);
+        return static_cast<uint32_t>(denseOf_.size() - 1);
+    }
+
+    void link(uint32_t slot, IEntity *e) {
+        denseOf_[slot] = static_cast<uint32_t>(dense_.size());
+        dense_.push_back(e);
+        denseSlot_.push_back(slot);
+    }
+
+    // 从 dense 数组摘除 slot（交换删除），槽位代数递增后进入空闲栈
+    void unlink(uint32_t slot) {
+        const uint32_t i = denseOf_[slot];
+        const uint32_t last = static_cast<uint32_t>(dense_.size() - 1);
+        if (i != last) {
+            dense_[i] = dense_[last];
+            denseSlot_[i] = denseSlot_[last];
+            denseOf_[denseSlot_[i]] = i;
+        }
+        dense_.pop_back();
+        denseSlot_.pop_back();
+        denseOf_[slot] = Invalid;
+        ++generation_[slot];
+        freeSlots_.push_back(slot);
+    }
+
+    std::vector<IEntity *> dense_;
+    std::vector<uint32_t> denseSlot_; // dense_[i] 所在槽位
+    std::vector<uint32_t> denseOf_; // 槽位 → dense 下标（空槽为 Invalid）
+    std::vector<uint32_t> generation_;
+    std::vector<uint32_t> freeSlots_;
+};
+
+// 具体类型 T 的池：对象按 64 个一块就地构造在连续内存中，地址终生不变
+// （PhysicsWorld 持有实体内 RigidBody/Collider 的指针，实体不能在内存中移动）
+template<typename T>
+class EntityPool final : public IEntityPool {
+public:
+    EntityPool() = default;
+
+    EntityPool(const EntityPool &) = delete;
+
+    EntityPool &operator=(const EntityPool &) = delete;
+
+    ~EntityPool() override {
+        for (IEntity *e: dense_) static_cast<T *>(e)->~T();
+    }
+
+    template<typename... Args>
+    T *emplace(uint32_t &outSlot, Args &&... args) {
+        const uint32_t slot = acquireSlot();
+        if (slot / ChunkSize >= chunks_.size()) chunks_.emplace_back(new Chunk); // 不做值初始化
+        T *obj;
+        try {
+            obj = ::new(static_cast<void *>(address(slot))) T(std::forward<Args>(args)...);
+        } catch (...) {
+            freeSlots_.push_back(slot);
+            throw;
+        }
+        link(slot, obj);
+        outSlot = slot;
+        return obj;
+    }
+
+    void destroy(uint32_t slot) override {
+        T *obj = static_cast<T *>(at(slot));
+        unlink(slot);
+        obj->~T();
+    }
+
+    // 按 dense 顺序遍历（静态类型 T，不经虚派发取对象）
+    template<typename Fn>
+    void forEach(Fn &&fn) const {
+        for (IEntity *e: dense_) fn(*static_cast<T *>(e));
+    }
+
+private:
+    static constexpr uint32_t ChunkSize = 64;
+
+    struct Chunk {
+        alignas(T) std::byte bytes[sizeof(T) * ChunkSize];
+    };
+
+    std::byte *address(uint32_t slot) {
+        return chunks_[slot / ChunkSize]->bytes + sizeof(T) * (slot % ChunkSize);
+    }
+
+    std::vector<std::unique_ptr<Chunk> > chunks_;
+};
+
+namespace detail {
+    inline uint32_t NextEntityTypeId() {
+        static std::atomic<uint32_t> next{0};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 每个具体实体类型一个进程内唯一的小整数（只用于查找池，不影响遍历顺序）
+    template<typename T>
+    uint32_t EntityTypeId() {
+        static const uint32_t id = NextEntityTypeId();
+        return id;
+    }
+}
+
+// 场景实体存储：每个具体类型一个 EntityPool，EntityId → (池, 槽位) 经分页稀疏表 O(1) 查找。
+// - 池按本场景首次创建该类型的顺序排列，遍历顺序只取决于场景自身的创建/销毁序列（可复现）；
+// - 遍历中不得创建/销毁实体（Scene 经 CommandBuffer 延迟到 submitCommands）。
+class EntityStorage {
+public:
+    // 在 T 的池中构造实体并以 id 登记（调用 setId），返回的指针在实体销毁前稳定
+    template<typename T, typename... Args>
+    T *create(EntityId id, Args &&... args) {
+        const uint32_t p = poolIndexOf<T>();
+        auto *pool = static_cast<EntityPool<T> *>(pools_[p].get());
+        uint32_t slot = 0;
+        T *obj = pool->emplace(slot, std::forward<Args>(args)...);
+        assert(slot <= SlotMask && index_.find(id) == SparseIndex::Invalid);
+        obj->setId(id);
+        index_.set(id, (p << SlotBits) | slot);
+        ++size_;
+        return obj;
+    }
+
+    // O(1)：交换删除出所在池并析构；id 不存在时忽略
+    void destroy(EntityId id) {
+        const uint32_t loc = index_.find(id);
+        if (loc == SparseIndex::Invalid) return;
+        index_.erase(id);
+        --size_;
+        pools_[loc >> SlotBits]->destroy(loc & SlotMask);
+    }
+
+    IEntity *find(EntityId id) const {
+        const uint32_t loc = index_.find(id);
+        return loc == SparseIndex::Invalid ? nullptr : pools_[loc >> SlotBits]->at(loc & SlotMask);
+    }
+
+    // 精确类型查找：id 存在且实体就在 T 的池中时返回（子类实体在各自的池中，不会匹配）
+    template<typename T>
+    T *find(EntityId id) const {
+        const uint32_t loc = index_.find(id);
+        if (loc == SparseIndex::Invalid) return nullptr;
+        const uint32_t p = loc >> SlotBits;
+        if (p != findPool<T>()) return nullptr;
+        return static_cast<T *>(pools_[p]->at(loc & SlotMask));
+    }
+
+    bool contains(EntityId id) const { return index_.find(id) != SparseIndex::Invalid; }
+
+    EntityHandle handle(EntityId id) const {
+        const uint32_t loc = index_.find(id);
+        if (loc == SparseIndex::Invalid) return {};
+        const uint32_t slot = loc & SlotMask;
+        return EntityHandle{loc >> SlotBits, slot, pools_[loc >> SlotBits]->generation(slot)};
+    }
+
+    // 句柄所指实体已销毁（槽位代数已变）时返回 nullptr
+    IEntity *resolve(const EntityHandle &h) const {
+        if (h.pool >= pools_.size() || !pools_[h.pool]->alive(h.slot, h.generation)) return nullptr;
+        return pools_[h.pool]->at(h.slot);
+    }
+
+    size_t size() const { return size_; }
+
+    // 全部实体：逐池、池内按 dense 顺序
+    template<typename Fn>
+    void forEach(Fn &&fn) const {
+        for (const auto &pool: pools_) {
+            for (IEntity *e: pool->entities()) fn(*e);
+        }
+    }
+
+    // 只遍历 T 的池（精确类型）
+    template<typename T, typename Fn>
+    void forEachOf(Fn &&fn) const {
+        const uint32_t p = findPool<T>();
+        if (p == IEntityPool::Invalid) return;
+        static_cast<const EntityPool<T> *>(pools_[p].get())->forEach(fn);
+    }
+
+    // T 的池的 dense 数组（元素可 static_cast 为 T*）；尚无该类型实体时为空
+    template<typename T>
+    std::span<IEntity *const> entitiesOf() const {
+        const uint32_t p = findPool<T>();
+        return p == IEntityPool::Invalid ? std::span<IEntity *const>{} : pools_[p]->entities();
+    }
+
+    std::span<const std::unique_ptr<IEntityPool> > pools() const { return pools_; }
+
+private:
+    static constexpr uint32_t SlotBits = 24; // 单池至多 16M 个槽位，至多 256 个池
+    static constexpr uint32_t SlotMask = (1u << SlotBits) - 1;
+
+    template<typename T>
+    uint32_t findPool() const {
+        const uint32_t type = detail::EntityTypeId<T>();
+        return type < poolOfType_.size() ? poolOfType_[type] : IEntityPool::Invalid;
+    }
+
+    template<typename T>
+    uint32_t poolIndexOf() {
+        const uint32_t type = detail::EntityTypeId<T>();
+        if (type >= poolOfType_.size()) poolOfType_.resize(type + 1, IEntityPool::Invalid);
+        if (poolOfType_[type] == IEntityPool::Invalid) {
+            assert(pools_.size() < (1u << (32 - SlotBits)));
+            poolOfType_[type] = static_cast<uint32_t>(pools_.size());
+            pools_.push_back(std::make_unique<EntityPool<T> >());
+        }
+        return poolOfType_[type];
+    }
+
+    SparseIndex index_; // EntityId → (池下标 << SlotBits) | 槽位
+    std::vector<std::unique_ptr<IEntityPool> > pools_;
+    std::vector<uint32_t> poolOfType_; // EntityTypeId → pools_ 下标
+    size_t size_ = 0;
+};
@@ -3,15 +3,20 @@
 #pragma execution_character_set("utf-8")
 #include <vector>
 #include <memory>
-#include <unordered_map>
-#include <unordered_set>
 #include <chrono>
+#include <cmath>
+#include <ctime>
+#include <cassert>
 #include "WorldContext.hpp"
 #include "IEntity.hpp"
-#include "../src/core/gfx/Renderer.hpp"
+#include "core/render/IRenderer.hpp"
+#include "core/gfx/Camera.hpp"
+#include "core/gfx/Model.hpp"
 #include "../src/core/physics/PhysicsWorld.hpp"
 #include "../src/core/physics/Transform.hpp"
 #include "core/resource/ResourceManager.hpp"
+#include "core/util/Random.hpp"
+#include "core/util/StateHash.hpp"
 #include "game/ui/UIElement.hpp"
 
 class SceneManager;
@@ -29,121 +34,49 @@ public:
     virtual ~Scene() = default;
 
     // 场景初始化（纯虚函数，子类实现具体场景内容）
-    virtual void init(Renderer *renderer) = 0;
+    virtual void init(IRenderer *renderer) = 0;
 
-    // 每帧更新
+    // 每帧更新：模拟按固定步长推进（累加器，每帧步数有上限），UI 按帧更新
     virtual void tick(float dt) {
-        time_ += dt;
-
         // 性能计时开始
         auto frameStart = std::chrono::high_resolution_clock::now();
-        auto lastCheckpoint = frameStart;
-
-        // 0.5) 物理前：将外部直接改动的 Transform 写入 PhysicsWorld
-        for (auto &ptr: entities_) {
-            if (!ptr) continue;
-            const auto &tr = ptr->transformRef();
-            DirectX::XMFLOAT3 rotEuler = tr.getRotationEuler();
-            world_.syncOwnerTransform(ptr->id(), tr.position, rotEuler, false);
-        }
-
-        auto checkpoint1 = std::chrono::high_resolution_clock::now();
-        float syncTransformTime = std::chrono::duration<float, std::milli>(checkpoint1 - lastCheckpoint).count();
-        lastCheckpoint = checkpoint1;
-
-        // 1) 物理步
-        world_.step(dt);
-
-        auto checkpoint2 = std::chrono::high_resolution_clock::now();
-        float physicsStepTime = std::chrono::duration<float, std::milli>(checkpoint2 - lastCheckpoint).count();
-        lastCheckpoint = checkpoint2;
-
-        // 2) 构建只读物理查询视图
-        buildPhysicsQueryFromLastFrame();
-
-        auto checkpoint3 = std::chrono::high_resolution_clock::now();
-        float buildQueryTime = std::chrono::duration<float, std::milli>(checkpoint3 - lastCheckpoint).count();
-        lastCheckpoint = checkpoint3;
-
-        // 2.5) 将物理解算后的刚体位置写回实体 Transform
-        for (auto &ptr: entities_) {
-            if (!ptr) continue;
-            if (RigidBody *rb = ptr->rigidBody()) {
-                ptr->transformRef().position = rb->position;
-            }
-        }
+        logicStats_ = LogicStats{};
 
-        auto checkpoint4 = std::chrono::high_resolution_clock::now();
-        float writeBackTime = std::chrono::duration<float, std::milli>(checkpoint4 - lastCheckpoint).count();
-        lastCheckpoint = checkpoint4;
-
-        // === 3) 构建 WorldContext 并派发事件到实体 ===
-        // 准备只读查询接口
-        EntityQuery entityQuery{};
-        entityQuery.entityMap = &id2ptr_;
-
-        // 构建上下文：提供给所有实体的只读物理查询、实体查询和命令缓冲
-        WorldContext ctx{};
-        ctx.time = time_;
-        ctx.dt = dt;
-        ctx.physics = &query_; // 物理查询（包含触发器重叠状态）
-        ctx.entities = &entityQuery; // 实体查询
-        ctx.commands = &cmdBuffer_; // 命令缓冲（用于生成/销毁实体）
-        ctx.resources = getResourceManager(); // 资源管理器（子类提供）
-        ctx.currentrenderer = renderer_;
-        ctx.camera = getCameraForShake(); // 相机指针（子类提供，用于画面抖动等效果）
-
-        // 3.1) 派发碰撞/触发事件到实体
-        // 遍历本帧所有碰撞事件，调用实体的 onCollision 回调
-        // 注意：
-        // - 所有碰撞都会触发此回调（无论是否涉及触发器）
-        // - 触发器碰撞不会产生物理响应，但仍然会收到事件通知
-        // - 实体可以通过 collider->isTrigger() 判断碰撞类型
-        for (const auto &ev: frameCollisionEvents_) {
-            auto it = id2ptr_.find(ev.a);
-            if (it != id2ptr_.end() && it->second) {
-                it->second->onCollision(ctx, ev.b, ev.phase, ev.contact);
-            }
+        // 1) 固定步长模拟：墙钟 dt 只进入累加器，物理与实体逻辑始终以 fixedDt_ 推进
+        //    固定 dt 模式忽略传入的 dt，每次 tick 恰好推进一步（与墙钟无关，可逐位复现）
+        if (fixedDtMode_) {
+            dt = fixedDt_;
+            accumulator_ = 0.0f;
         }
-        frameCollisionEvents_.clear();
-
-        auto checkpoint5 = std::chrono::high_resolution_clock::now();
-        float collisionEventTime = std::chrono::duration<float, std::milli>(checkpoint5 - lastCheckpoint).count();
-        lastCheckpoint = checkpoint5;
-
-        // 3.2) 逐实体更新逻辑
-        // 调用每个实体的 update() 方法，实体可以：
-        // - 查询物理状态（如触发器重叠）
-        // - 修改自身状态
-        // - 通过 ctx.commands 发送生成/销毁命令
-        for (auto &ptr: entities_) {
-            if (ptr) ptr->update(ctx, dt);
+        accumulator_ += std::max(0.0f, dt);
+        int steps = 0;
+        while (accumulator_ >= fixedDt_ && steps < maxStepsPerFrame_) {
+            fixedUpdate(fixedDt_);
+            accumulator_ -= fixedDt_;
+            ++steps;
         }
+        // 卡顿后积压超过上限：丢弃多余的整步（宁可变慢也不陷入越追越慢的循环）
+        if (accumulator_ >= fixedDt_) accumulator_ = std::fmod(accumulator_, fixedDt_);
+        // 剩余不足一步的比例，供 render() 在上一步与当前步之间插值；
+        // 固定 dt 模式每次 tick 恰好推进整步，直接显示当前步（不落后一步）
+        renderAlpha_ = fixedDtMode_ ? 1.0f : accumulator_ / fixedDt_;
+        logicStats_.steps = steps;
 
-        auto checkpoint6 = std::chrono::high_resolution_clock::now();
-        float entityUpdateTime = std::chrono::duration<float, std::milli>(checkpoint6 - lastCheckpoint).count();
-        lastCheckpoint = checkpoint6;
+        auto checkpoint1 = std::chrono::high_resolution_clock::now();
 
-        // 3.3) 更新UI元素
+        // 2) 更新UI元素
         for (auto &elem: uiElements_) {
             if (elem) elem->update(dt);
         }
 
-        auto checkpoint7 = std::chrono::high_resolution_clock::now();
-        float uiUpdateTime = std::chrono::duration<float, std::milli>(checkpoint7 - lastCheckpoint).count();
-        lastCheckpoint = checkpoint7;
-
-        // 4) 提交命令缓冲
-        submitCommands();
-
-        auto checkpoint8 = std::chrono::high_resolution_clock::now();
-        float submitCommandTime = std::chrono::duration<float, std::milli>(checkpoint8 - lastCheckpoint).count();
+        auto checkpoint2 = std::chrono::high_resolution_clock::now();
+        float uiUpdateTime = std::chrono::duration<float, std::milli>(checkpoint2 - checkpoint1).count();
 
-        float totalTime = std::chrono::duration<float, std::milli>(checkpoint8 - frameStart).count();
+        float totalTime = std::chrono::duration<float, std::milli>(checkpoint2 - frameStart).count();
 
         // 每60帧输出一次性能统计
         static int frameCounter = 0;
-        if (++frameCounter >= 60) {
+        if (printStats_ && ++frameCounter >= 60) {
             // 计算渲染平均耗时
             float avgMainRender = renderStats_.frameCount > 0
                                       ? renderStats_.mainrenderTime / renderStats_.frameCount
@@ -160,15 +93,31 @@ public:
                                        : 0.0f;
 
             printf("\n========== Performance Statistics (Entity count: %zu) ==========\n", entities_.size());
-            printf("--- Logic Update ---\n");
-            printf("  Sync Transform:   %.3f ms\n", syncTransformTime);
-            printf("  Physics Step:     %.3f ms\n", physicsStepTime);
-            printf("  Build Query:      %.3f ms\n", buildQueryTime);
-            printf("  Write Back:       %.3f ms\n", writeBackTime);
-            printf("  Collision Events: %.3f ms\n", collisionEventTime);
-            printf("  Entity Update:    %.3f ms\n", entityUpdateTime);
+            printf("--- Logic Update (%d fixed steps of %.2f ms this frame) ---\n", logicStats_.steps,
+                   fixedDt_ * 1000.0f);
+            printf("  Sync Transform:   %.3f ms (%d moved)\n", logicStats_.syncTransform,
+                   logicStats_.transformsSynced);
+            printf("  Physics Step:     %.3f ms\n", logicStats_.physicsStep);
+            const BroadPhaseStats &bp = world_.broadPhaseStats();
+            printf("    Broad Phase:    %zu pairs, %zu filtered by layer\n", bp.pairCount, bp.pairsFiltered);
+            const NarrowPhaseStats &np = world_.narrowPhaseStats();
+            printf("    Narrow Phase:   %.3f ms (%zu pairs, %d/%d threads, efficiency %.0f%%)\n",
+                   np.wallMs, np.pairCount, np.jobs, np.threads, np.efficiency * 100.0f);
+            const SolverStats &sv = world_.solverStats();
+            printf("    Solver:         %zu contacts (%zu warm), %d iterations, residual %.2e\n",
+                   sv.contactCount, sv.warmStarted, sv.iterations,
+                   sv.residuals.empty() ? 0.0f : sv.residuals.back());
+            printf("                    %zu island tasks on %d threads, %zu colored islands (%zu batches, %zu overflow)\n",
+                   sv.islandTasks, sv.threads, sv.coloredIslands, sv.colorBatches, sv.overflowContacts);
+            const IslandStats &is = world_.islandStats();
+            printf("    Islands:        %zu (largest %zu), %zu awake / %zu sleeping, %zu proxies skipped\n",
+                   is.islandCount, is.largestIsland, is.awakeBodies, is.sleepingBodies, bp.sleepingCount);
+            printf("  Build Query:      %.3f ms\n", logicStats_.buildQuery);
+            printf("  Write Back:       %.3f ms\n", logicStats_.writeBack);
+            printf("  Collision Events: %.3f ms\n", logicStats_.collisionEvents);
+            printf("  Entity Update:    %.3f ms\n", logicStats_.entityUpdate);
             printf("  UI Update:        %.3f ms\n", uiUpdateTime);
-            printf("  Submit Commands:  %.3f ms\n", submitCommandTime);
+            printf("  Submit Commands:  %.3f ms\n", logicStats_.submitCommands);
             printf("  Total Logic:      %.3f ms\n", totalTime);
             printf("\n--- Rendering (avg over %d frames) ---\n", renderStats_.frameCount);
             printf("  Main Render:   %.3f ms\n", avgMainRender);
@@ -186,6 +135,53 @@ public:
         }
     }
 
+    // 固定步长设置：tickRate 为每秒模拟步数，maxStepsPerFrame 为单帧最多追赶的步数
+    void setFixedTimestep(float tickRate, int maxStepsPerFrame) {
+        if (tickRate > 0.0f) fixedDt_ = 1.0f / tickRate;
+        if (maxStepsPerFrame > 0) maxStepsPerFrame_ = maxStepsPerFrame;
+    }
+
+    float fixedTimestep() const { return fixedDt_; }
+
+    // 固定 dt 模式（headless 基准/回放）：每次 tick 推进恰好一个固定步
+    void setFixedDtMode(bool enable) { fixedDtMode_ = enable; }
+
+    bool fixedDtMode() const { return fixedDtMode_; }
+
+    // 场景随机数种子（默认取构造时的时间）；需在 init 之前设置，模拟期间经 WorldContext::rng 取用
+    void setSeed(uint64_t seed) {
+        seed_ = seed;
+        rng_.seed(seed);
+    }
+
+    uint64_t seed() const { return seed_; }
+
+    // 已推进的固定步数（命令录制/回放以此为时间戳）
+    uint32_t stepCount() const { return stepCount_; }
+
+    Random &random() { return rng_; }
+
+    // 模拟状态哈希：按实体顺序混入 id 与刚体位置/速度，子类经 hashEntityState 追加玩法状态。
+    // 相同种子、固定 dt 模式下每个 tick 的结果应与运行次数和物理线程数无关
+    uint64_t stateHash() const {
+        StateHash h;
+        entities_.forEach([&](IEntity &e) {
+            h.add(e.id());
+            if (RigidBody *rb = e.rigidBody()) {
+                h.add(rb->position);
+                h.add(rb->velocity);
+            }
+            hashEntityState(e, h);
+        });
+        return h.value;
+    }
+
+    // 是否每 60 帧打印性能统计（headless 驱动关闭后自行汇总）
+    void setPrintStats(bool enable) { printStats_ = enable; }
+
+    // 渲染插值系数 ∈ [0,1)：上一固定步 → 当前固定步
+    float renderAlpha() const { return renderAlpha_; }
+
     // 渲染场景（分层渲染：不透明物体 → Billboard）
     virtual void render() {
         if (!renderer_) return;
@@ -214,18 +210,27 @@ public:
 
         if (camera) {
             // 收集所有实体渲染数据，提交渲染队列
-            for (auto &ptr: entities_) {
-                if (!ptr) continue;
-
-                if (isBillboard(ptr.get())) {
-                    updateBillboardOrientation(ptr.get(), camera);
+            entities_.forEach([&](IEntity &e) {
+                IEntity *ptr = &e;
+                if (isBillboard(ptr)) {
+                    updateBillboardOrientation(ptr, camera);
                 }
 
                 const Model *model = ptr->model();
-                if (!model || model->empty()) continue;
+                if (!model || model->empty()) return;
 
                 Transform worldTransform = buildTransformFromWorld(ptr->world());
 
+                // 刚体：在上一固定步与当前固定步的位置之间按 renderAlpha_ 插值（只平移世界矩阵，不改实体状态）
+                if (const RigidBody *rb = ptr->rigidBody()) {
+                    const DirectX::XMFLOAT3 &prev = rb->prevPosition;
+                    const DirectX::XMFLOAT3 &curr = ptr->transformRef().position;
+                    const float back = 1.0f - renderAlpha_;
+                    worldTransform.position.x -= (curr.x - prev.x) * back;
+                    worldTransform.position.y -= (curr.y - prev.y) * back;
+                    worldTransform.position.z -= (curr.z - prev.z) * back;
+                }
+
                 for (const auto &drawItem: model->drawItems) {
                     if (drawItem.meshIndex >= model->meshes.size()) continue;
                     const auto &meshGpu = model->meshes[drawItem.meshIndex];
@@ -240,7 +245,7 @@ public:
                         tempMaterial.baseColor = tex->srv();
                     }
 
-                    Renderer::DrawItem item{};
+                    IRenderer::DrawItem item{};
                     item.mesh = &meshGpu.mesh;
                     item.material = &tempMaterial;
                     item.transform = worldTransform;
@@ -248,7 +253,7 @@ public:
                     item.alpha = ptr->getAlpha();
                     renderer_->submit(item);
                 }
-            }
+            });
 
             renderer_->endFrame(*camera);
         }
@@ -259,16 +264,11 @@ public:
 
         // 调试模式下的碰撞体线框（单独绘制）
         if (camera) {
-            for (auto &ptr: entities_) {
-                if (!ptr) continue;
-                auto span = ptr->colliders();
-                std::vector<ColliderBase *> cols(span.begin(), span.end());
-                if (!cols.empty()) {
-                    for (auto *c: cols) {
-                        renderer_->drawColliderWire(*c);
-                    }
+            entities_.forEach([&](IEntity &e) {
+                for (auto *c: e.colliders()) {
+                    renderer_->drawColliderWire(*c);
                 }
-            }
+            });
         }
 
         // 渲染 Trail（自定义渲染路径）
@@ -317,11 +317,11 @@ public:
 
         // 收集所有 Billboard 实体（通过虚函数判断）
         std::vector<IEntity *> billboards;
-        for (auto &ptr: entities_) {
-            if (isBillboard(ptr.get())) {
-                billboards.push_back(ptr.get());
+        entities_.forEach([&](IEntity &e) {
+            if (isBillboard(&e)) {
+                billboards.push_back(&e);
             }
-        }
+        });
 
         if (billboards.empty()) return;
 
@@ -375,8 +375,10 @@ public:
     // 访问底层 PhysicsWorld
     PhysicsWorld &physics() { return world_; }
 
+    const PhysicsWorld &physics() const { return world_; }
+
     // 访问 Renderer（用于实体工厂）
-    Renderer *renderer() { return renderer_; }
+    IRenderer *renderer() { return renderer_; }
 
     // 访问 ResourceManager（子类需要实现，返回其持有的 ResourceManager）
     virtual ResourceManager *getResourceManager() { return nullptr; }
@@ -385,8 +387,24 @@ public:
     virtual void handleInput(float dt, const void *window) {
     }
 
-    // 获取实体映射表（用于 InputManager 射线检测）
-    const std::unordered_map<EntityId, IEntity *> *getEntityMap() const { return &id2ptr_; }
+    // 逻辑性能统计（一帧内所有固定步累加，单位 ms）
+    struct LogicStats {
+        int steps = 0;
+        int transformsSynced = 0;
+        float syncTransform = 0.0f;
+        float physicsStep = 0.0f;
+        float buildQuery = 0.0f;
+        float writeBack = 0.0f;
+        float collisionEvents = 0.0f;
+        float entityUpdate = 0.0f;
+        float submitCommands = 0.0f;
+    };
+
+    // 上一次 tick 的逻辑统计（基准驱动按 tick 采样）
+    const LogicStats &logicStats() const { return logicStats_; }
+
+    // 实体存储（只读：计数、按 id/类型查找与遍历）
+    const EntityStorage &entities() const { return entities_; }
 
     void setSceneManager(SceneManager *manager) { manager_ = manager; }
     SceneManager *sceneManager() const { return manager_; }
@@ -399,37 +417,54 @@ public:
     void clearUIElements();
 
 protected:
-    Renderer *renderer_ = nullptr; // 仅保存指针，生命周期由外部管理
+    IRenderer *renderer_ = nullptr; // 仅保存指针，生命周期由外部管理
     PhysicsWorld world_{};
     PhysicsQuery query_{}; // 当前帧只读物理查询视图
     CommandBuffer cmdBuffer_{}; // 命令缓冲
     float time_ = 0.0f;
 
-    // 资源与实体容器
-    std::vector<std::unique_ptr<IEntity> > entities_;
-    std::unordered_map<EntityId, IEntity *> id2ptr_;
+    // 固定步长调度：tick 的墙钟 dt 进入累加器，按 fixedDt_ 整步推进模拟
+    float fixedDt_ = 1.0f / 60.0f;
+    int maxStepsPerFrame_ = 5; // 单帧最多追赶步数（超出的积压丢弃）
+    float accumulator_ = 0.0f;
+    float renderAlpha_ = 0.0f; // accumulator_ / fixedDt_（固定 dt 模式为 1）
+    bool printStats_ = true;
+    bool fixedDtMode_ = false;
+
+    // 场景私有随机数：模拟逻辑只从这里取随机数（不用全局 std::rand，多场景可并行且可复现）
+    uint64_t seed_ = static_cast<uint64_t>(std::time(nullptr));
+    Random rng_{seed_};
+    uint32_t stepCount_ = 0;
+
+    // stateHash 的扩展点：混入实体的玩法状态（如节点队伍）
+    virtual void hashEntityState(IEntity & /*e*/, StateHash & /*h*/) const {
+    }
+
+    // 实体容器：按具体类型分池，EntityId 经稀疏表 O(1) 定位，销毁为交换删除
+    EntityStorage entities_;
     EntityId nextId_ = 0;
 
-    // 触发器重叠缓存（entity→set），由物理回调维护
-    std::unordered_map<EntityId, std::unordered_set<EntityId> > triggerOverlaps_;
-    std::unordered_map<EntityId, std::unordered_set<EntityId> > tempTriggerOverlaps_;
+    // 触发器重叠表，每个物理步后由 PhysicsWorld::activePairs 重建（复用容器）
+    TriggerOverlapTable triggerOverlaps_;
 
-    // 碰撞事件缓存（物理回调 → 帧内派发）
-    struct CollisionEvent {
-        EntityId a{0};
-        EntityId b{0};
-        TriggerPhase phase{TriggerPhase::Stay};
-        OverlapResult contact{};
+    // 碰撞事件派发表：PhysicsWorld::collisionEvents 中每个事件对双方各一条，按 (接收实体, 事件序号) 排序，
+    // 同一实体的事件连续派发，只查一次实体表
+    struct EventDispatch {
+        EntityId self{0};
+        EntityId other{0};
+        uint32_t event{0};
     };
 
-    std::vector<CollisionEvent> tempCollisionEvents_;
-    std::vector<CollisionEvent> frameCollisionEvents_;
+    std::vector<EventDispatch> eventDispatch_;
+
+    // Transform 由未改动变为 dirty 时登记的实体 id（Transform::markDirty 追加；同步后清空，复用容量）。
+    // 登记后可能已被销毁，同步时按 id 查找，查不到即跳过
+    std::vector<EntityId> movedEntities_;
 
     SceneManager *manager_ = nullptr;
 
     // UI元素容器
     std::vector<std::unique_ptr<class UIElement> > uiElements_;
-    ResourceManager resourceManager_;
 
     // 渲染性能统计结构
     struct RenderStats {
@@ -448,165 +483,228 @@ protected:
 
     RenderStats renderStats_;
 
-    // UI专用渲染方法
-    virtual void renderUI();
+    LogicStats logicStats_;
 
-    // 子类可用的工具方法
-    // 设置物理世界的碰撞/触发回调
-    // 此回调在物理步进时由 PhysicsWorld 调用，用于：
-    // 1. 收集所有碰撞事件，稍后分发给实体的 onCollision()
-    // 2. 维护触发器重叠状态映射，供 PhysicsQuery 查询
-    void setupPhysicsCallback() {
-        world_.setTriggerCallback([this](EntityId a, EntityId b, TriggerPhase phase, const OverlapResult &contact) {
-            // === 步骤 1：缓存碰撞事件（用于后续分发给实体） ===
-            // 注意：事件是双向的，A 和 B 都会收到 onCollision 回调
-            // - 实体 A 收到 onCollision(ctx, B, phase, contact)
-            // - 实体 B 收到 onCollision(ctx, A, phase, contact)
-            tempCollisionEvents_.push_back(CollisionEvent{a, b, phase, contact});
-            tempCollisionEvents_.push_back(CollisionEvent{b, a, phase, contact});
-
-            // === 步骤 2：维护触发器重叠状态映射 ===
-            // 检查碰撞对中是否有触发器碰撞体
-            auto entityHasTrigger = [this](EntityId e) -> bool {
-                auto it = id2ptr_.find(e);
-                if (it == id2ptr_.end() || !it->second) return false;
-                auto span = it->second->colliders();
-                for (auto *c: span) { if (c && c->isTrigger()) return true; }
-                return false;
-            };
-
-            // 只有当至少一方拥有触发器碰撞体时，才记录到触发器重叠映射
-            // 这样可以过滤掉纯物理碰撞（两方都是实体碰撞体）
-            bool isTriggerInvolved = entityHasTrigger(a) || entityHasTrigger(b);
-
-            // 辅助函数：添加触发器重叠对
-            auto addPair = [&](EntityId ta, EntityId tb) {
-                tempTriggerOverlaps_[ta].insert(tb);
-            };
-
-            // 辅助函数：移除触发器重叠对（从当前帧和临时缓存中移除）
-            auto removePair = [&](EntityId ta, EntityId tb) {
-                auto it = triggerOverlaps_.find(ta);
-                if (it != triggerOverlaps_.end()) it->second.erase(tb);
-                auto it2 = tempTriggerOverlaps_.find(ta);
-                if (it2 != tempTriggerOverlaps_.end()) it2->second.erase(tb);
-            };
-
-            if (isTriggerInvolved) {
-                if (phase == TriggerPhase::Exit) {
-                    // 触发器退出：从双向映射中移除
-                    removePair(a, b);
-                    removePair(b, a);
-                } else {
-                    // 触发器进入或保持：添加到双向映射
-                    // phase 可以是 Enter 或 Stay
-                    addPair(a, b);
-                    addPair(b, a);
-                }
+    // 一个固定步：同步 Transform → 物理步 → 查询视图 → 写回 → 事件/实体更新 → 提交命令
+    void fixedUpdate(float dt) {
+        time_ += dt;
+        ++stepCount_;
+
+        auto lastCheckpoint = std::chrono::high_resolution_clock::now();
+        auto elapsed = [&lastCheckpoint]() {
+            auto now = std::chrono::high_resolution_clock::now();
+            float ms = std::chrono::duration<float, std::milli>(now - lastCheckpoint).count();
+            lastCheckpoint = now;
+            return ms;
+        };
+
+        // 0.5) 物理前：将被游戏逻辑改动过（dirty）的 Transform 写入 PhysicsWorld，只走变动登记列表；
+        //      然后记录刚体的步前位置作为渲染插值起点（传送已写入 rb->position，不会被插值拉出拖影）
+#ifndef NDEBUG
+        entities_.forEach([](IEntity &e) {
+            assert((e.colliders().empty() || e.transformRef().matchesSynced()) &&
+                   "Transform 在注册后被直接改写字段：改用 setPosition/setRotation，或随后 markDirty()");
+        });
+#endif
+        int synced = 0;
+        for (EntityId id: movedEntities_) {
+            IEntity *e = entities_.find(id);
+            if (!e) continue;
+            auto &tr = e->transformRef();
+            if (!tr.dirty) continue; // 已同步过
+            world_.syncOwnerTransform(id, tr.position, tr.rotation, false);
+            tr.markSynced();
+            ++synced;
+        }
+        logicStats_.transformsSynced += synced;
+        movedEntities_.clear();
+        for (RigidBody *rb: world_.rigidBodies()) {
+            if (rb) rb->prevPosition = rb->position;
+        }
+        logicStats_.syncTransform += elapsed();
+
+        // 1) 物理步
+        world_.step(dt);
+        logicStats_.physicsStep += elapsed();
+
+        // 2) 构建只读物理查询视图
+        buildPhysicsQueryFromLastFrame();
+        logicStats_.buildQuery += elapsed();
+
+        // 2.5) 将物理解算后的刚体位置写回实体 Transform（来自物理本身，不置 dirty）
+        entities_.forEach([](IEntity &e) {
+            if (RigidBody *rb = e.rigidBody()) {
+                e.transformRef().setPositionFromPhysics(rb->position);
             }
         });
+        logicStats_.writeBack += elapsed();
+
+        // === 3) 构建 WorldContext 并派发事件到实体 ===
+        // 准备只读查询接口
+        EntityQuery entityQuery{};
+        entityQuery.storage = &entities_;
+
+        // 构建上下文：提供给所有实体的只读物理查询、实体查询和命令缓冲
+        WorldContext ctx{};
+        ctx.time = time_;
+        ctx.dt = dt;
+        ctx.physics = &query_; // 物理查询（包含触发器重叠状态）
+        ctx.entities = &entityQuery; // 实体查询
+        ctx.commands = &cmdBuffer_; // 命令缓冲（用于生成/销毁实体）
+        ctx.resources = getResourceManager(); // 资源管理器（子类提供）
+        ctx.currentrenderer = renderer_;
+        ctx.camera = getCameraForShake(); // 相机指针（子类提供，用于画面抖动等效果）
+        ctx.rng = &rng_;
+
+        // 3.1) 派发碰撞/触发事件到实体
+        // 按接收实体顺序遍历本步所有碰撞事件，调用实体的 onCollision 回调
+        // 注意：
+        // - 所有碰撞都会触发此回调（无论是否涉及触发器）
+        // - 事件是双向的：A 收到 onCollision(ctx, B, ...)，B 收到 onCollision(ctx, A, ...)
+        // - 触发器碰撞不会产生物理响应，但仍然会收到事件通知（CollisionEvent::trigger）
+        const auto events = world_.collisionEvents();
+        IEntity *target = nullptr;
+        for (size_t i = 0; i < eventDispatch_.size(); ++i) {
+            const EventDispatch &d = eventDispatch_[i];
+            if (i == 0 || d.self != eventDispatch_[i - 1].self) {
+                target = entities_.find(d.self);
+            }
+            if (target) target->onCollision(ctx, d.other, events[d.event].phase, events[d.event].contact);
+        }
+        eventDispatch_.clear();
+        logicStats_.collisionEvents += elapsed();
+
+        // 3.2) 逐实体更新逻辑
+        // 调用每个实体的 update() 方法，实体可以：
+        // - 查询物理状态（如触发器重叠）
+        // - 修改自身状态
+        // - 通过 ctx.commands 发送生成/销毁命令
+        entities_.forEach([&ctx, dt](IEntity &e) { e.update(ctx, dt); });
+        logicStats_.entityUpdate += elapsed();
+
+        // 4) 提交命令缓冲
+        submitCommands();
+        logicStats_.submitCommands += elapsed();
     }
 
+    // UI专用渲染方法
+    virtual void renderUI();
+
+    // 子类可用的工具方法
+    // 物理步后读取 PhysicsWorld 的本步结果：
+    // 1. 触发器重叠表（activePairs 中涉及 trigger 的对），供 PhysicsQuery 查询
+    // 2. 碰撞事件派发表（collisionEvents 按接收实体排序），稍后分发给实体的 onCollision()
     void buildPhysicsQueryFromLastFrame() {
-        triggerOverlaps_ = tempTriggerOverlaps_;
-        tempTriggerOverlaps_.clear();
+        triggerOverlaps_.rebuild(world_.activePairs(), world_.activePairTriggers());
         query_.triggerOverlaps = &triggerOverlaps_;
-        frameCollisionEvents_ = std::move(tempCollisionEvents_);
-        tempCollisionEvents_.clear();
+        query_.world = &world_;
+
+        const auto events = world_.collisionEvents();
+        eventDispatch_.clear();
+        for (size_t i = 0; i < events.size(); ++i) {
+            const auto index = static_cast<uint32_t>(i);
+            eventDispatch_.push_back(EventDispatch{events[i].a, events[i].b, index});
+            eventDispatch_.push_back(EventDispatch{events[i].b, events[i].a, index});
+        }
+        std::sort(eventDispatch_.begin(), eventDispatch_.end(), [](const EventDispatch &x, const EventDispatch &y) {
+            return x.self != y.self ? x.self < y.self : x.event < y.event;
+        });
     }
 
     void submitCommands() {
+        // 本帧的生成/销毁在物理世界中批量提交（广相结构与体数组只调整一次）
+        world_.beginBatch();
+
         // Reset 优先
         if (cmdBuffer_.reset.doReset) {
-            for (size_t i = 0; i < entities_.size();) {
-                auto *e = entities_[i].get();
-                if (e && e->rigidBody() != nullptr) {
-                    unregisterEntity(e->id());
-                    id2ptr_.erase(e->id());
-                    entities_.erase(entities_.begin() + i);
-                    continue;
-                }
-                ++i;
+            std::vector<EntityId> dynamicIds;
+            entities_.forEach([&dynamicIds](IEntity &e) {
+                if (e.rigidBody() != nullptr) dynamicIds.push_back(e.id());
+            });
+            for (EntityId id: dynamicIds) {
+                unregisterEntity(id);
+                entities_.destroy(id);
             }
+            world_.commitBatch();
             cmdBuffer_.clear();
             return;
         }
 
         // 销毁命令
         for (auto &dc: cmdBuffer_.toDestroy) {
-            auto it = id2ptr_.find(dc.id);
-            if (it != id2ptr_.end()) {
+            if (IEntity *e = entities_.find(dc.id)) {
                 WorldContext destroyCtx{};
                 destroyCtx.time = time_;
                 destroyCtx.dt = 0.0f;
                 EntityQuery entityQueryForDestroy{};
-                entityQueryForDestroy.entityMap = &id2ptr_;
+                entityQueryForDestroy.storage = &entities_;
                 destroyCtx.physics = &query_;
                 destroyCtx.entities = &entityQueryForDestroy;
                 destroyCtx.commands = &cmdBuffer_;
-                it->second->onDestroy(destroyCtx);
+                destroyCtx.rng = &rng_;
+                e->onDestroy(destroyCtx);
 
                 unregisterEntity(dc.id);
-
-                for (size_t i = 0; i < entities_.size(); ++i) {
-                    if (entities_[i].get() == it->second) {
-                        entities_.erase(entities_.begin() + i);
-                        break;
-                    }
-                }
-                id2ptr_.erase(it);
+                entities_.destroy(dc.id);
             }
         }
 
         // 通用实体生成命令
         for (auto &cmd: cmdBuffer_.spawnEntities) {
-            auto entity = cmd.factory(this);
-            if (!entity) continue;
-
-            entity->setId(allocId());
+            IEntity *entityPtr = cmd.factory(this, entities_, allocId());
+            if (!entityPtr) continue;
 
             if (cmd.configurator) {
-                cmd.configurator(entity.get());
+                cmd.configurator(entityPtr);
             }
 
-            registerEntity(*entity);
-            EntityId eid = entity->id();
-            IEntity *entityPtr = entity.get();
-            id2ptr_[eid] = entityPtr;
-            entities_.push_back(std::move(entity));
+            registerEntity(*entityPtr);
 
             WorldContext initCtx{};
             initCtx.time = time_;
             initCtx.dt = 0.0f;
             EntityQuery entityQueryForInit{};
-            entityQueryForInit.entityMap = &id2ptr_;
+            entityQueryForInit.storage = &entities_;
             initCtx.physics = &query_;
             initCtx.entities = &entityQueryForInit;
             initCtx.commands = &cmdBuffer_;
+            initCtx.rng = &rng_;
             entityPtr->init(initCtx);
         }
 
+        world_.commitBatch();
         cmdBuffer_.clear();
     }
 
     // 实体管理
     EntityId allocId() { return ++nextId_; }
 
+    // 在 T 的池中创建实体并分配 id；调用方设置好 Transform/碰撞体后再 registerEntity
+    template<typename T, typename... Args>
+    T *createEntity(Args &&... args) {
+        return entities_.create<T>(allocId(), std::forward<Args>(args)...);
+    }
+
     void registerEntity(IEntity &e) {
         auto span = e.colliders();
         std::vector<ColliderBase *> cols(span.begin(), span.end());
         if (!cols.empty()) {
-            const DirectX::XMFLOAT3 pos = e.transformRef().position;
-            const DirectX::XMFLOAT3 rot = e.transformRef().getRotationEuler();
+            const Transform &tr = e.transformRef();
             for (auto *c: cols) {
                 if (!c) continue;
-                c->setOwnerWorldPosition(pos);
-                c->setOwnerWorldRotationEuler(rot);
+                c->setOwnerWorldPose(tr.position, tr.rotation);
                 c->updateDerived();
             }
         }
         RigidBody *rb = e.rigidBody();
+        // 新实体在下一固定步之前就会被渲染：插值起点取当前位置
+        if (rb) rb->prevPosition = e.transformRef().position;
         world_.registerEntity(e.id(), rb, std::span<ColliderBase *>(cols.data(), cols.size()));
+        // 注册时已按当前位姿建立碰撞体，生成前的初始化改动无需再同步；之后的改动登记到 movedEntities_
+        Transform &tr = e.transformRef();
+        tr.markSynced();
+        tr.changes = &movedEntities_;
+        tr.owner = e.id();
     }
 
     void unregisterEntity(EntityId id) {
@@ -620,14 +718,8 @@ protected:
 inline void Scene::renderTrails(const Camera *camera) {
     if (!camera || !renderer_) return;
 
-    // 收集所有 Trail 实体
-    std::vector<TrailEntity *> trails;
-    for (auto &ptr: entities_) {
-        if (auto *trail = dynamic_cast<TrailEntity *>(ptr.get())) {
-            trails.push_back(trail);
-        }
-    }
-
+    // Trail 都在 TrailEntity 的池中，直接取该池的 dense 数组
+    const auto trails = entities_.entitiesOf<TrailEntity>();
     if (trails.empty()) return;
 
     // 设置透明渲染状态（与 Billboard 相同）
@@ -636,8 +728,8 @@ inline void Scene::renderTrails(const Camera *camera) {
     renderer_->setBackfaceCulling(false); // 双面渲染
 
     // 渲染所有 Trail
-    for (auto *trail: trails) {
-        trail->render(renderer_, time_);
+    for (IEntity *trail: trails) {
+        static_cast<TrailEntity *>(trail)->render(renderer_, time_);
     }
 
     // 恢复默认渲染状态
@@ -697,24 +789,16 @@ inline void Scene::clearUIElements() {
 
 // CommandBuffer::spawnBall 实现（需要在 Scene 定义之后）
 #include "game/entity/BallEntity.hpp"
-#include <windows.h>
+#include "core/platform/ExecutablePath.hpp"
 
 inline void CommandBuffer::spawnBall(const DirectX::XMFLOAT3 &pos, float radius) {
     SpawnEntityCmd cmd;
 
     // 工厂函数：创建 BallEntity
-    cmd.factory = [radius](Scene *scene) -> std::unique_ptr<IEntity> {
-        wchar_t buf[MAX_PATH];
-        GetModuleFileNameW(nullptr, buf, MAX_PATH);
-        std::wstring exePath(buf);
-        auto lastSlash = exePath.find_last_of(L"\\/");
-        std::wstring exeDir = (lastSlash == std::wstring::npos) ? L"." : exePath.substr(0, lastSlash);
-
-        return std::make_unique<BallEntity>(
-            scene->renderer()->device(),
-            radius,
-            exeDir + L"\\asset\\ball.fbx"
-        );
+    cmd.factory = [radius](Scene *scene, EntityStorage &storage, EntityId id) -> IEntity * {
+        ResourceManager *res = scene->getResourceManager();
+        Model *model = res ? res->getModel(ExecutableDir() + L"\\asset\\ball.fbx") : nullptr;
+        return storage.create<BallEntity>(id, radius, model);
     };
 
     // 配置函数：设置位置等属性
@@ -1,7 +1,7 @@
 #include "SceneManager.hpp"
 #include "../scene/TransitionScene.hpp"
 
-SceneManager::SceneManager(Renderer *renderer) : renderer_(renderer) {}
+SceneManager::SceneManager(IRenderer *renderer) : renderer_(renderer) {}
 
 void SceneManager::setScene(std::unique_ptr<Scene> scene) {
     currentScene_ = std::move(scene);
@@ -6,7 +6,7 @@ class TransitionScene;
 
 class SceneManager {
 public:
-    explicit SceneManager(Renderer *renderer);
+    explicit SceneManager(IRenderer *renderer);
 
     void setScene(std::unique_ptr<Scene> scene);
     void transitionTo(std::unique_ptr<Scene> targetScene);
@@ -22,7 +22,7 @@ private:
 
     void finishTransition(std::unique_ptr<Scene> nextScene);
 
-    Renderer *renderer_ = nullptr;
+    IRenderer *renderer_ = nullptr;
     std::unique_ptr<Scene> currentScene_;
     std::unique_ptr<Scene> pendingScene_;  // 待切换的场景
 };
@@ -2,38 +2,84 @@
 #pragma execution_character_set("utf-8")
 
 #include <vector>
+#include <span>
+#include <algorithm>
 #include <cstdint>
-#include <unordered_map>
-#include <unordered_set>
 #include <functional>
 #include <memory>
 #include <DirectXMath.h>
-#include "core/gfx/Renderer.hpp"
+#include "core/render/IRenderer.hpp"
+#include "core/util/Random.hpp"
+#include "IEntity.hpp"
+#include "EntityStorage.hpp"
 #include "../src/core/physics/PhysicsWorld.hpp"
 
 // 前置声明
-struct IEntity;
 class Scene;
 class ResourceManager;
 
+// 触发器重叠表：entityId -> 与之重叠的其他实体 ids（均升序），CSR 形式存放在三段连续数组中
+// 由 Scene 在每个物理步后以 PhysicsWorld::activePairs 重建；数组只清空不释放，稳定后重建不分配内存。
+struct TriggerOverlapTable {
+    std::vector<EntityId> entities; // 有重叠的实体（升序）
+    std::vector<uint32_t> offsets; // entities[i] 的重叠对象为 others[offsets[i], offsets[i+1])
+    std::vector<EntityId> others;
+    std::vector<uint64_t> edges; // 构建临时：有向边 (a << 32) | b
+
+    // pairs 为 PairKey 升序的实体对，involved 与之一一对应；只收录 involved 非 0 的对，双向记录
+    void rebuild(std::span<const uint64_t> pairs, std::span<const uint8_t> involved) {
+        edges.clear();
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            if (!involved[i]) continue;
+            const uint64_t key = pairs[i];
+            const EntityId a = static_cast<EntityId>(key >> 32);
+            const EntityId b = static_cast<EntityId>(key & 0xffffffffu);
+            edges.push_back(key);
+            edges.push_back((static_cast<uint64_t>(b) << 32) | a);
+        }
+        std::sort(edges.begin(), edges.end());
+
+        entities.clear();
+        offsets.clear();
+        others.clear();
+        for (uint64_t edge: edges) {
+            const EntityId a = static_cast<EntityId>(edge >> 32);
+            if (entities.empty() || entities.back() != a) {
+                entities.push_back(a);
+                offsets.push_back(static_cast<uint32_t>(others.size()));
+            }
+            others.push_back(static_cast<EntityId>(edge & 0xffffffffu));
+        }
+        offsets.push_back(static_cast<uint32_t>(others.size()));
+    }
+
+    std::span<const EntityId> find(EntityId e) const {
+        auto it = std::lower_bound(entities.begin(), entities.end(), e);
+        if (it == entities.end() || *it != e) return {};
+        const size_t i = static_cast<size_t>(it - entities.begin());
+        return std::span<const EntityId>(others.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
 // 只读物理查询视图：
 // 由 Scene 在每帧物理步后填充，提供触发器重叠状态的快速查询。
 struct PhysicsQuery {
-    // 指向"本帧触发器重叠映射"：entityId -> { 与之重叠的其他实体 ids }
+    // 指向"本帧触发器重叠表"：entityId -> { 与之重叠的其他实体 ids }
     //
-    // 重要：此映射仅包含"涉及至少一个 Trigger 碰撞体"的碰撞对。
-    // - 如果实体 A 有触发器，实体 B 与 A 重叠，则 triggerOverlaps[A] 包含 B
-    // - 如果实体 B 也有触发器，则 triggerOverlaps[B] 也包含 A（双向记录）
-    // - 如果 A 和 B 都没有触发器（纯实体碰撞），则不会出现在此映射中
-    const std::unordered_map<EntityId, std::unordered_set<EntityId> > *triggerOverlaps = nullptr;
+    // 重要：此表仅包含"涉及至少一个 Trigger 碰撞体"的碰撞对。
+    // - 如果实体 A 有触发器，实体 B 与 A 重叠，则 A 的重叠列表包含 B
+    // - 同时 B 的重叠列表也包含 A（双向记录）
+    // - 如果 A 和 B 都没有触发器（纯实体碰撞），则不会出现在此表中
+    const TriggerOverlapTable *triggerOverlaps = nullptr;
+
+    // 场景查询（射线/扫掠球/重叠，对象为上一次物理步结束时的状态），见 PhysicsWorld::raycast 等
+    const PhysicsWorld *world = nullptr;
 
     // 检查指定实体是否有任何触发器正在与其他实体重叠
     // 参数 e: 要查询的实体 ID（可以是拥有触发器的实体，也可以是与触发器重叠的实体）
-    // 返回: 如果该实体在触发器重叠映射中且有至少一个重叠对象，返回 true
+    // 返回: 如果该实体在触发器重叠表中且有至少一个重叠对象，返回 true
     bool isAnyTriggerOverlapping(EntityId e) const {
-        if (!triggerOverlaps) return false;
-        auto it = triggerOverlaps->find(e);
-        return it != triggerOverlaps->end() && !it->second.empty();
+        return !getTriggerOverlappers(e).empty();
     }
 
     // 检查两个特定实体之间是否存在触发器重叠
@@ -41,61 +87,60 @@ struct PhysicsQuery {
     // 参数 withEntity: 另一个实体
     // 返回: 如果这两个实体之间存在触发器重叠，返回 true
     bool isTriggerOverlapping(EntityId triggerEntity, EntityId withEntity) const {
-        if (!triggerOverlaps) return false;
-        auto it = triggerOverlaps->find(triggerEntity);
-        if (it == triggerOverlaps->end()) return false;
-        return it->second.find(withEntity) != it->second.end();
+        const auto overlappers = getTriggerOverlappers(triggerEntity);
+        return std::binary_search(overlappers.begin(), overlappers.end(), withEntity);
     }
 
-    // 获取所有与指定实体的触发器重叠的其他实体列表
+    // 获取所有与指定实体的触发器重叠的其他实体（升序）
     // 参数 triggerEntity: 要查询的实体 ID（通常是拥有触发器碰撞体的实体）
-    // 参数 out: 输出向量，将填充所有与该实体重叠的其他实体 ID
-    // 返回: 重叠实体的数量
+    // 返回: 直接指向重叠表的视图（不分配内存），在下一个物理步前有效
     //
     // 用途示例：
     // - SpawnerEntity 检查生成区域是否被占用
     // - NodeEntity 检查发射区域内是否有敌方实体
-    size_t getTriggerOverlappers(EntityId triggerEntity, std::vector<EntityId> &out) const {
-        out.clear();
-        if (!triggerOverlaps) return 0;
-        auto it = triggerOverlaps->find(triggerEntity);
-        if (it == triggerOverlaps->end()) return 0;
-        out.reserve(it->second.size());
-        for (auto id: it->second) out.push_back(id);
-        return out.size();
+    std::span<const EntityId> getTriggerOverlappers(EntityId triggerEntity) const {
+        if (!triggerOverlaps) return {};
+        return triggerOverlaps->find(triggerEntity);
     }
 };
 
 // 实体查询接口（只读）
 struct EntityQuery {
-    const std::unordered_map<EntityId, IEntity *> *entityMap = nullptr;
+    const EntityStorage *storage = nullptr;
 
     // 根据 ID 获取实体指针（只读）
     IEntity *getEntity(EntityId id) const {
-        if (!entityMap) return nullptr;
-        auto it = entityMap->find(id);
-        return (it != entityMap->end()) ? it->second : nullptr;
+        return storage ? storage->find(id) : nullptr;
+    }
+
+    // 精确类型查找（不经 dynamic_cast；实体不是 T 本身时返回 nullptr）
+    template<typename T>
+    T *getEntity(EntityId id) const {
+        return storage ? storage->find<T>(id) : nullptr;
     }
 
     // 检查实体是否存在
     bool exists(EntityId id) const {
-        return entityMap && entityMap->find(id) != entityMap->end();
+        return storage && storage->contains(id);
     }
 
     // 获取所有实体 ID（用于遍历）
     void getAllEntityIds(std::vector<EntityId> &out) const {
         out.clear();
-        if (!entityMap) return;
-        out.reserve(entityMap->size());
-        for (const auto &kv: *entityMap) {
-            // 解引用指针
-            out.push_back(kv.first);
-        }
+        if (!storage) return;
+        out.reserve(storage->size());
+        storage->forEach([&out](IEntity &e) { out.push_back(e.id()); });
+    }
+
+    // 遍历某一具体类型的全部实体（连续的 dense 数组，无需先取 id 再逐个查表）
+    template<typename T, typename Fn>
+    void forEach(Fn &&fn) const {
+        if (storage) storage->forEachOf<T>(std::forward<Fn>(fn));
     }
 
     // 获取实体数量
     size_t count() const {
-        return entityMap ? entityMap->size() : 0;
+        return storage ? storage->size() : 0;
     }
 };
 
@@ -103,7 +148,7 @@ struct EntityQuery {
 struct CommandBuffer {
     // 通用实体生成命令
     struct SpawnEntityCmd {
-        std::function<std::unique_ptr<IEntity>(Scene *)> factory; // 工厂函数
+        std::function<IEntity *(Scene *, EntityStorage &, EntityId)> factory; // 工厂函数：在存储中创建并登记 id
         std::function<void(IEntity *)> configurator; // 配置回调
     };
 
@@ -125,8 +170,8 @@ struct CommandBuffer {
     template<typename EntityType, typename ConfigFunc>
     void spawn(ConfigFunc &&configurator) {
         SpawnEntityCmd cmd;
-        cmd.factory = [](Scene *scene) -> std::unique_ptr<IEntity> {
-            return std::make_unique<EntityType>();
+        cmd.factory = [](Scene *, EntityStorage &storage, EntityId id) -> IEntity * {
+            return storage.template create<EntityType>(id);
         };
         // 捕获配置函数，并在执行时安全转换类型
         cmd.configurator = [config = std::forward<ConfigFunc>(configurator)](IEntity *e) {
@@ -167,6 +212,7 @@ struct WorldContext {
     const EntityQuery *entities = nullptr; // 只读实体查询
     CommandBuffer *commands = nullptr; // 可写命令缓冲
     ResourceManager *resources = nullptr; // 资源管理器（用于加载模型/纹理）
-    Renderer *currentrenderer = nullptr; // 当前渲染器
+    IRenderer *currentrenderer = nullptr; // 当前渲染器
     class Camera *camera = nullptr; // 相机指针（用于触发抖动等效果）
+    Random *rng = nullptr; // 场景随机数（模拟逻辑需要随机时只用它，保证同种子可复现）
 };
\ No newline at end of file
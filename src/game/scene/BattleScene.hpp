@@ -1,27 +1,35 @@
 ﻿#pragma once
+#include <memory>
 #include "../runtime/Scene.hpp"
 #include "../entity/BlockEntity.hpp"
 #include "../entity/NodeEntity.hpp"
 #include "../../core/resource/ResourceManager.hpp"
 #include "../../core/gfx/Camera.hpp"
 #include "../input/InputManager.hpp"
-#include <SFML/Window.hpp>
+#include "../input/CommandLog.hpp"
 
-#include "game/ui/UINumberDisplay.hpp"
+// 对局结果（演示模式下保持 Ongoing）
+enum class BattleOutcome {
+    Ongoing,
+    Victory,
+    Defeat
+};
 
+// 对局模拟：场地、节点、选中状态与胜负判定，不依赖窗口与输入设备（headless 可直接驱动）。
+// 键鼠输入、HUD 与场景切换见 InteractiveBattleScene
 class BattleScene : public Scene {
 public:
     BattleScene() = default;
 
     ~BattleScene() override = default;
 
-    void init(Renderer *renderer) override;
+    // renderer 可为空：此时使用 NullResourceManager，实体以无模型状态运行
+    void init(IRenderer *renderer) override;
 
-    void tick(float dt); // 隐藏基类的 tick()，在调用基类前先更新 camera
-    void handleInput(float dt, const void *window) override;
+    void tick(float dt) override; // 先更新 camera 再调用基类 tick，之后统计节点并判定胜负
 
     // 返回 ResourceManager 供实体使用
-    ResourceManager *getResourceManager() override { return &resourceManager_; }
+    ResourceManager *getResourceManager() override { return resources_.get(); }
 
     // 访问 Camera
     Camera &camera() { return camera_; }
@@ -36,6 +44,28 @@ public:
     // 访问 Node 实体（公开给外部使用）
     NodeEntity *getNodeEntity(EntityId id);
 
+    // 演示模式：节点一半友方一半敌方，全部由 AI 控制，不判定胜负
+    void enterDemoMode();
+
+    bool isDemoMode() const { return isDemoMode_; }
+
+    // 执行一条玩家命令（选中/朝向/开火/停火/演示模式/相机）；录制中则同时追加到命令日志
+    void execute(const BattleCommand &cmd);
+
+    // 从当前步开始录制 execute 的命令（种子与固定步长写入日志头），通常在 init 之后立即调用
+    void startRecording();
+
+    bool isRecording() const { return recording_; }
+
+    // 以当前步为结束步、当前状态哈希为校验值保存录制的命令日志
+    bool saveRecording(const std::filesystem::path &path);
+
+    // 上一次 tick 结束时的节点统计与对局结果
+    int totalNodeCount() const { return totalNodes_; }
+    int friendlyNodeCount() const { return friendlyNodes_; }
+    int enemyNodeCount() const { return enemyNodes_; }
+    BattleOutcome outcome() const { return outcome_; }
+
     // 重写 Scene 的虚函数以支持 Billboard 渲染
     const Camera *getCameraForRendering() const override { return &camera_; }
     Camera *getCameraForShake() override { return &camera_; }
@@ -47,7 +77,7 @@ public:
     // 重写 render 方法以绘制 Node 指示箭头
     void render() override;
 
-private:
+protected:
     Camera camera_; // 场景管理的 Camera
     InputManager inputManager_; // 输入管理器
 
@@ -56,25 +86,22 @@ private:
 
     // 演示模式
     bool isDemoMode_ = false;
-    void enterDemoMode();
-    void exitDemoMode();
 
-    // 上方显示区的数字元素的指针
-    UINumberDisplay *totalNodeCount_;
-    UINumberDisplay *friendlyNodeCount_;
-    UINumberDisplay *enemyNodeCount_;
+    int totalNodes_ = 0;
+    int friendlyNodes_ = 0;
+    int enemyNodes_ = 0;
+    BattleOutcome outcome_ = BattleOutcome::Ongoing;
 
-    // 下方详情区的数字元素的指针
+    void hashEntityState(IEntity &e, StateHash &h) const override;
 
-    UINumberDisplay *selectedNodeHealth_;
-    UINumberDisplay *selectedNodePower_;
-    UINumberDisplay *selectedNodeFireInterval_;
+    bool recording_ = false;
+    CommandLog commandLog_;
 
-    ResourceManager resourceManager_;
+    // 由 init 按渲染器创建（Renderer → ResourceManagerD3D11，无渲染器 → NullResourceManager）
+    std::unique_ptr<ResourceManager> resources_;
 
+private:
     void createField();
 
     void createNodes();
-
-    void createUI();
-};
\ No newline at end of file
+};
@@ -19,7 +19,7 @@ static std::wstring ExeDirHelp() {
     return (p == std::wstring::npos) ? L"." : s.substr(0, p);
 }
 
-void HelpScene::init(Renderer *renderer) {
+void HelpScene::init(IRenderer *renderer) {
     renderer_ = renderer;
     if (!renderer_ || !renderer_->device()) return;
 
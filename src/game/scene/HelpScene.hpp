@@ -7,7 +7,7 @@ public:
     HelpScene() = default;
     ~HelpScene() override = default;
 
-    void init(Renderer *renderer) override;
+    void init(IRenderer *renderer) override;
     void tick(float dt) override;
     void handleInput(float dt, const void *window) override;
 
@@ -0,0 +1,335 @@
+﻿#include "InteractiveBattleScene.hpp"
+#include "MenuScene.hpp"
+#include "WinScene.hpp"
+#include "LoseScene.hpp"
+#include "../runtime/SceneManager.hpp"
+#include "../ui/UIImage.hpp"
+#include "../../core/platform/ExecutablePath.hpp"
+
+#include <SFML/Window.hpp>
+#include <string>
+
+using namespace DirectX;
+
+void InteractiveBattleScene::init(IRenderer *renderer) {
+    BattleScene::init(renderer);
+    startRecording();
+    createUI();
+}
+
+void InteractiveBattleScene::tick(float dt) {
+    BattleScene::tick(dt);
+
+    if (manager_) {
+        if (outcome_ == BattleOutcome::Victory) {
+            manager_->transitionTo(std::make_unique<WinScene>());
+            return;
+        }
+        if (outcome_ == BattleOutcome::Defeat) {
+            manager_->transitionTo(std::make_unique<LoseScene>());
+            return;
+        }
+    }
+
+    // 更新上方显示区的数字
+    if (totalNodeCount_) totalNodeCount_->setValue(static_cast<float>(totalNodes_));
+    if (friendlyNodeCount_) friendlyNodeCount_->setValue(static_cast<float>(friendlyNodes_));
+    if (enemyNodeCount_) enemyNodeCount_->setValue(static_cast<float>(enemyNodes_));
+
+    // 更新下方详情区的数字（显示选中 node 的属性）
+    if (selectedNodeId_ != 0) {
+        NodeEntity *selectedNode = getNodeEntity(selectedNodeId_);
+        if (selectedNode) {
+            if (selectedNodeHealth_) selectedNodeHealth_->setValue(static_cast<float>(selectedNode->getHealth()));
+            if (selectedNodePower_) selectedNodePower_->setValue(static_cast<float>(selectedNode->getFirepower()));
+            if (selectedNodeFireInterval_) selectedNodeFireInterval_->setValue(selectedNode->getfireinterval());
+        } else {
+            // 选中的节点已被销毁
+            if (selectedNodeHealth_) selectedNodeHealth_->setNaN();
+            if (selectedNodePower_) selectedNodePower_->setNaN();
+            if (selectedNodeFireInterval_) selectedNodeFireInterval_->setNaN();
+        }
+    } else {
+        // 没有选中任何节点
+        if (selectedNodeHealth_) selectedNodeHealth_->setNaN();
+        if (selectedNodePower_) selectedNodePower_->setNaN();
+        if (selectedNodeFireInterval_) selectedNodeFireInterval_->setNaN();
+    }
+}
+
+void InteractiveBattleScene::handleInput(float dt, const void *window) {
+    // 键鼠输入只翻译成 BattleCommand 交给 execute，以便录制与回放
+    // 更新 InputManager 状态（右键长按/短按检测）
+    inputManager_.updateMouseButtons(dt);
+
+    // === V键：演示模式切换 ===
+    static bool vWasPressed = false;
+    bool vPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::V);
+    if (vPressed && !vWasPressed) {
+        if (isDemoMode_) {
+            // 退出演示模式，重置场景
+            restartBattle();
+        } else {
+            // 进入演示模式
+            execute({BattleCommandType::EnterDemo});
+        }
+    }
+    vWasPressed = vPressed;
+
+    // === ESC键：返回主菜单 ===
+    static bool escWasPressed = false;
+    bool escPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Escape);
+    if (escPressed && !escWasPressed) {
+        if (manager_) {
+            manager_->transitionTo(std::make_unique<MenuScene>());
+        }
+    }
+    escWasPressed = escPressed;
+
+    // === F9键：保存本局至今的命令录制（nodewars_headless --replay 可重放）===
+    static bool f9WasPressed = false;
+    bool f9Pressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::F9);
+    if (f9Pressed && !f9WasPressed) {
+        std::wstring replayPath = ExecutableDir() + L"\\replay.nwlog";
+        if (saveRecording(replayPath)) {
+            printf("Saved %zu commands (%u steps) to replay.nwlog\n", commandLog_.commands.size(), stepCount());
+        } else {
+            printf("Failed to save replay.nwlog\n");
+        }
+    }
+    f9WasPressed = f9Pressed;
+
+    // === 左键点击：选择/取消选择 Node ===
+    static bool leftWasPressed = false;
+    bool leftPressed = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
+
+    // 检测按键从未按下到按下的边缘（只在按下瞬间触发一次）
+    if (leftPressed && !leftWasPressed) {
+        // 获取鼠标窗口坐标
+        const sf::Window *sfWindow = static_cast<const sf::Window *>(window);
+        sf::Vector2i mousePos = sf::Mouse::getPosition(*sfWindow);
+
+        printf("Mouse clicked at screen position: (%d, %d)\n", mousePos.x, mousePos.y);
+
+        Ray ray = inputManager_.screenPointToRay(mousePos.x, mousePos.y, camera_);
+        printf("Ray origin: (%.2f, %.2f, %.2f), dir: (%.2f, %.2f, %.2f)\n",
+               ray.origin.x, ray.origin.y, ray.origin.z,
+               ray.dir.x, ray.dir.y, ray.dir.z);
+
+        // 射线检测场景中的实体；是否为友方 Node 由 execute 判定，未击中时为取消选择
+        EntityId hitEntity = inputManager_.raycastEntities(ray, *this, 100.0f);
+
+        printf("Raycast result: hitEntity = %u\n", hitEntity);
+
+        BattleCommand select{BattleCommandType::Select};
+        select.entity = hitEntity;
+        execute(select);
+        if (selectedNodeId_ != 0) {
+            printf("Selected friendly Node %u\n", selectedNodeId_);
+        } else {
+            printf("Deselected\n");
+        }
+    }
+
+    leftWasPressed = leftPressed;
+
+    // === 右键短按：指定发射方向（仅在选中 Node 时有效）===
+    if (inputManager_.isRightClickShort() && selectedNodeId_ != 0) {
+        // 获取鼠标窗口坐标
+        const sf::Window *sfWindow = static_cast<const sf::Window *>(window);
+        sf::Vector2i mousePos = sf::Mouse::getPosition(*sfWindow);
+        Ray ray = inputManager_.screenPointToRay(mousePos.x, mousePos.y, camera_);
+
+        printf("[Right-click] Mouse at (%d, %d), Ray origin: (%.2f, %.2f, %.2f), dir: (%.2f, %.2f, %.2f)\n",
+               mousePos.x, mousePos.y,
+               ray.origin.x, ray.origin.y, ray.origin.z,
+               ray.dir.x, ray.dir.y, ray.dir.z);
+
+        // 与地面平面相交（Y=0）
+        DirectX::XMFLOAT3 hitPoint;
+        if (inputManager_.raycastPlane(ray, 0.0f, hitPoint)) {
+            printf("[Right-click] Hit ground at (%.2f, %.2f, %.2f)\n",
+                   hitPoint.x, hitPoint.y, hitPoint.z);
+
+            // 直接传入世界坐标点，让 setFacingDirection 内部计算方向
+            BattleCommand facing{BattleCommandType::SetFacing};
+            facing.point = hitPoint;
+            execute(facing);
+            execute({BattleCommandType::StartFiring});
+        } else {
+            printf("[Right-click] Failed to hit ground plane\n");
+        }
+    }
+
+    // Press H to halt fire command
+    static bool hWasPressed = false;
+    bool hPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::H);
+    if (hPressed && !hWasPressed && selectedNodeId_ != 0) {
+        execute({BattleCommandType::Stop});
+    }
+    hWasPressed = hPressed;
+
+    // === 相机：WASD 平移、QE 旋转、Shift 加速 ===
+    uint8_t moveFlags = 0;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W)) moveFlags |= CameraForward;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S)) moveFlags |= CameraBackward;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A)) moveFlags |= CameraLeft;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) moveFlags |= CameraRight;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Q)) moveFlags |= CameraRotateLeft;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::E)) moveFlags |= CameraRotateRight;
+    // 只有加速键而无移动时相机不动，不必产生命令
+    if (moveFlags != 0) {
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) ||
+            sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift)) {
+            moveFlags |= CameraBoost;
+        }
+        BattleCommand move{BattleCommandType::CameraMove};
+        move.flags = moveFlags;
+        move.value = dt;
+        execute(move);
+    }
+
+    // === F键：相机对准选中的 Node ===
+    static bool fWasPressed = false;
+    bool fPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::F);
+    if (fPressed && !fWasPressed && selectedNodeId_ != 0) {
+        execute({BattleCommandType::CameraFocus});
+        printf("Focusing on Node %u\n", selectedNodeId_);
+    }
+    fWasPressed = fPressed;
+
+    // === 1, 2, 3 键：切换相机 ===
+    static bool keyWasPressed[3] = {false, false, false};
+    const sf::Keyboard::Key cameraKeys[3] = {
+        sf::Keyboard::Key::Num1, sf::Keyboard::Key::Num2, sf::Keyboard::Key::Num3
+    };
+    const CameraType cameraTypes[3] = {CameraType::FreeCam, CameraType::FrontView, CameraType::TopView};
+    const char *cameraNames[3] = {"Free Camera", "Front View Camera", "Top View Camera"};
+    for (int i = 0; i < 3; ++i) {
+        bool pressed = sf::Keyboard::isKeyPressed(cameraKeys[i]);
+        if (pressed && !keyWasPressed[i]) {
+            BattleCommand sw{BattleCommandType::CameraSwitch};
+            sw.flags = static_cast<uint8_t>(cameraTypes[i]);
+            execute(sw);
+            printf("Switching to %s\n", cameraNames[i]);
+        }
+        keyWasPressed[i] = pressed;
+    }
+
+    // === 右键长按：绕 Node 旋转相机（Orbit 模式的鼠标控制在 main.cpp 中处理）===
+    // 这里不需要额外处理，processMouseMove 会在 Orbit 模式下自动生效
+
+}
+
+void InteractiveBattleScene::restartBattle() {
+    // 通过TransitionScene重置场景
+    if (manager_) {
+        manager_->transitionTo(std::make_unique<InteractiveBattleScene>());
+    }
+}
+
+void InteractiveBattleScene::createUI() {
+
+    std::wstring scorepath = ExecutableDir() + L"\\asset\\main_scoreboard.png";
+    Texture *score= resources_->getTexture(scorepath);
+
+    auto scoreImage = std::make_unique<UIImage>();
+    scoreImage->transform().x = 0.4f;
+    scoreImage->transform().y = 0.0f;
+    scoreImage->transform().width = 0.2f;
+    scoreImage->transform().height = scoreImage->transform().width/2;
+    scoreImage->setTexture(score);
+    scoreImage->setLayer(0);
+    addUIElement(std::move(scoreImage));
+
+    std::wstring detailpath = ExecutableDir() + L"\\asset\\main_detail.png";
+    Texture *detail= resources_->getTexture(detailpath);
+
+    auto detailImage = std::make_unique<UIImage>();
+    detailImage->transform().x = 0.3f;
+    detailImage->transform().y = 0.9f;
+    detailImage->transform().width = 0.4f;
+    detailImage->transform().height = detailImage->transform().width/4;
+    detailImage->setTexture(detail);
+    detailImage->setLayer(0);
+    addUIElement(std::move(detailImage));
+
+    std::wstring numberpath = ExecutableDir() + L"\\asset\\number_atlas1.png";
+    Texture *numbertex= resources_->getTexture(numberpath);
+
+    auto totalnum = std::make_unique<UINumberDisplay>();
+    totalnum->transform().x = 0.5f;
+    totalnum->transform().y = 0.025f;
+    totalnum->transform().width = 0.05f;
+    totalnum->setDigitSpacing(0);
+    totalnum->transform().height = totalnum->transform().width;
+    totalnum->setTexture(numbertex);
+    totalnum->setLayer(1);
+    totalnum->setValue(10);
+    totalNodeCount_=totalnum.get();
+    addUIElement(std::move(totalnum));
+
+    auto friendlynum = std::make_unique<UINumberDisplay>();
+    friendlynum->transform().x = 0.45f;
+    friendlynum->transform().y = 0.02f;
+    friendlynum->transform().width = 0.05f;
+    friendlynum->setDigitSpacing(0);
+    friendlynum->transform().height = friendlynum->transform().width;
+    friendlynum->setTexture(numbertex);
+    friendlynum->setLayer(1);
+    friendlynum->setValue(10);
+    friendlynum->setTint(XMFLOAT4(0, 0, 1, 1));
+    friendlyNodeCount_=friendlynum.get();
+    addUIElement(std::move(friendlynum));
+
+    auto enemynum = std::make_unique<UINumberDisplay>();
+    enemynum->transform().x = 0.55f;
+    enemynum->transform().y = 0.02f;
+    enemynum->transform().width = 0.05f;
+    enemynum->setDigitSpacing(0);
+    enemynum->transform().height = enemynum->transform().width;
+    enemynum->setTexture(numbertex);
+    enemynum->setLayer(1);
+    enemynum->setValue(10);
+    enemynum->setTint(XMFLOAT4(1, 0, 0, 1));
+    enemyNodeCount_=enemynum.get();
+    addUIElement(std::move(enemynum));
+
+    auto healthnum = std::make_unique<UINumberDisplay>();
+    healthnum->transform().x = 0.5f;
+    healthnum->transform().y = 0.9f;
+    healthnum->transform().width = 0.1f;
+    healthnum->transform().height = healthnum->transform().width;
+    healthnum->setTexture(numbertex);
+    healthnum->setLayer(1);
+    healthnum->setValue(10);
+    healthnum->setTint(XMFLOAT4(0, 1, 1, 1));
+    selectedNodeHealth_=healthnum.get();
+    addUIElement(std::move(healthnum));
+
+    auto powernum = std::make_unique<UINumberDisplay>();
+    powernum->transform().x = 0.4f;
+    powernum->transform().y = 0.94f;
+    powernum->transform().width = 0.05f;
+    powernum->transform().height = powernum->transform().width;
+    powernum->setTexture(numbertex);
+    powernum->setLayer(1);
+    powernum->setValue(9);
+    powernum->setTint(XMFLOAT4(0, 0, 1.0, 1));
+    selectedNodePower_=powernum.get();
+    addUIElement(std::move(powernum));
+
+    auto firenum = std::make_unique<UINumberDisplay>();
+    firenum->transform().x = 0.6f;
+    firenum->transform().y = 0.94f;
+    firenum->transform().width = 0.05f;
+    firenum->transform().height = firenum->transform().width;
+    firenum->setTexture(numbertex);
+    firenum->setLayer(1);
+    firenum->setValue(0.3);
+    firenum->setTint(XMFLOAT4(0, 1, 0.2, 1));
+    selectedNodeFireInterval_=firenum.get();
+    addUIElement(std::move(firenum));
+
+
+}
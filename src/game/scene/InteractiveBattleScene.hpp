@@ -0,0 +1,29 @@
+﻿#pragma once
+#include "BattleScene.hpp"
+#include "game/ui/UINumberDisplay.hpp"
+
+// 窗口版对局：在 BattleScene 模拟之上处理 SFML 键鼠输入、HUD 数字与胜负/菜单场景切换
+class InteractiveBattleScene : public BattleScene {
+public:
+    void init(IRenderer *renderer) override;
+
+    void tick(float dt) override;
+
+    void handleInput(float dt, const void *window) override;
+
+private:
+    // 通过 TransitionScene 重新开始一局（退出演示模式）
+    void restartBattle();
+
+    void createUI();
+
+    // 上方显示区的数字元素的指针
+    UINumberDisplay *totalNodeCount_ = nullptr;
+    UINumberDisplay *friendlyNodeCount_ = nullptr;
+    UINumberDisplay *enemyNodeCount_ = nullptr;
+
+    // 下方详情区的数字元素的指针
+    UINumberDisplay *selectedNodeHealth_ = nullptr;
+    UINumberDisplay *selectedNodePower_ = nullptr;
+    UINumberDisplay *selectedNodeFireInterval_ = nullptr;
+};
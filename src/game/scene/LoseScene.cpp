@@ -22,7 +22,7 @@ static std::wstring ExeDirLose() {
     return (p == std::wstring::npos) ? L"." : s.substr(0, p);
 }
 
-void LoseScene::init(Renderer *renderer) {
+void LoseScene::init(IRenderer *renderer) {
     renderer_ = renderer;
     if (!renderer_ || !renderer_->device()) return;
 
@@ -4,7 +4,7 @@
 
 #include "../runtime/SceneManager.hpp"
 #include "TransitionScene.hpp"
-#include "BattleScene.hpp"
+#include "InteractiveBattleScene.hpp"
 #include "HelpScene.hpp"
 
 #include <SFML/Window/Keyboard.hpp>
@@ -23,7 +23,7 @@ static std::wstring ExeDirMenu() {
     return (p == std::wstring::npos) ? L"." : s.substr(0, p);
 }
 
-void MenuScene::init(Renderer *renderer) {
+void MenuScene::init(IRenderer *renderer) {
     renderer_ = renderer;
     if (!renderer_ || !renderer_->device()) return;
 
@@ -123,7 +123,7 @@ void MenuScene::tick(float dt) {
 
     if (startRequested_ && manager_) {
         startRequested_ = false;
-        manager_->transitionTo(std::make_unique<BattleScene>());
+        manager_->transitionTo(std::make_unique<InteractiveBattleScene>());
     }
 
     if (helpRequested_ && manager_) {
@@ -9,7 +9,7 @@ public:
     MenuScene() = default;
     ~MenuScene() override = default;
 
-    void init(Renderer *renderer) override;
+    void init(IRenderer *renderer) override;
     void tick(float dt) override;
     void handleInput(float dt, const void *window) override;
 
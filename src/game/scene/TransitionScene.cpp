@@ -16,7 +16,7 @@ static std::wstring ExeDirTransition() {
 TransitionScene::TransitionScene(std::unique_ptr<Scene> next)
     : nextScene_(std::move(next)) {}
 
-void TransitionScene::init(Renderer *renderer) {
+void TransitionScene::init(IRenderer *renderer) {
     renderer_ = renderer;
     if (renderer_ && renderer_->device()) {
         std::wstring loadingpath = ExeDirTransition() + L"\\asset\\loading.png";
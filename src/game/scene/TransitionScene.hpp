@@ -8,7 +8,7 @@ public:
     explicit TransitionScene(std::unique_ptr<Scene> next);
     ~TransitionScene() override = default;
 
-    void init(Renderer *renderer) override;
+    void init(IRenderer *renderer) override;
     void tick(float dt) override;
     void render() override;
 
@@ -22,7 +22,7 @@ static std::wstring ExeDirWin() {
     return (p == std::wstring::npos) ? L"." : s.substr(0, p);
 }
 
-void WinScene::init(Renderer *renderer) {
+void WinScene::init(IRenderer *renderer) {
     renderer_ = renderer;
     if (!renderer_ || !renderer_->device()) return;
 
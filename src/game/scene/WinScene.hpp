@@ -9,7 +9,7 @@ public:
     WinScene() = default;
     ~WinScene() override = default;
 
-    void init(Renderer *renderer) override;
+    void init(IRenderer *renderer) override;
     void tick(float dt) override;
     void handleInput(float dt, const void *window) override;
 
@@ -1,6 +1,6 @@
 ﻿#include "UIElement.hpp"
 
-void UIElement::render(Renderer* renderer) {
+void UIElement::render(IRenderer* renderer) {
     if (!visible_ || !texture_) return;
 
     // 计算应用缩放后的实际尺寸和位置
@@ -2,7 +2,7 @@
 #include <DirectXMath.h>
 #include <functional>
 #include "../../core/gfx/Texture.hpp"
-#include "../../core/gfx/Renderer.hpp"
+#include "../../core/render/IRenderer.hpp"
 
 // 2D屏幕空间变换（归一化坐标：0-1）
 struct Transform2D {
@@ -29,7 +29,7 @@ public:
     // 生命周期
     virtual void init() {}
     virtual void update(float dt) {}
-    virtual void render(Renderer* renderer);
+    virtual void render(IRenderer* renderer);
 
     // 交互检测（屏幕空间AABB）
     bool containsPoint(float screenX, float screenY) const;
@@ -5,14 +5,14 @@
 void UINumberDisplay::setValue(float value) {
     isNaN_ = false;
     // 限制范围：0-99.99
-    value_ = max(0.0f, min(99.99f, value));
+    value_ = std::max(0.0f, std::min(99.99f, value));
 }
 
 void UINumberDisplay::setNaN() {
     isNaN_ = true;
 }
 
-void UINumberDisplay::render(Renderer* renderer) {
+void UINumberDisplay::render(IRenderer* renderer) {
     if (!visible_ || !texture_) return;
 
     // 1. NaN状态：只渲染单个"-"（居中）
@@ -85,7 +85,7 @@ void UINumberDisplay::render(Renderer* renderer) {
     }
 }
 
-void UINumberDisplay::renderDigit(Renderer* renderer, int spriteIndex, float x, float y) {
+void UINumberDisplay::renderDigit(IRenderer* renderer, int spriteIndex, float x, float y) {
     // 计算UV偏移和缩放（5×3布局）
     // 每个sprite占用的UV空间：宽度=0.2 (1/5), 高度=0.333 (1/3)
     float uvOffsetX = (spriteIndex % 5) * 0.2f;
@@ -9,7 +9,7 @@ public:
     UINumberDisplay() = default;
     virtual ~UINumberDisplay() = default;
 
-    void render(Renderer* renderer) override;
+    void render(IRenderer* renderer) override;
 
     // 设置数值（范围：0-99.99）
     void setValue(float value);
@@ -27,7 +27,7 @@ public:
 
 private:
     // 渲染单个数字（使用UV偏移）
-    void renderDigit(Renderer* renderer, int spriteIndex, float x, float y);
+    void renderDigit(IRenderer* renderer, int spriteIndex, float x, float y);
 
     float value_ = 0.0f;           // 实际数值
     bool isNaN_ = false;           // NaN状态标志